@@ -0,0 +1,377 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ASField.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "Snapshot.h"
+
+
+// The cells that are checked besides a sprite's own, half of the
+// ones around it, so that every pair of cells is only checked once
+static const int32 kNeighbors[4][2] = {
+	{ 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }
+};
+
+
+ASField::ASField(int32 capacity)
+	:
+	fCapacity(capacity),
+	fCount(0),
+	fSteps(0),
+	fBoundsWidth(0),
+	fBoundsHeight(0),
+	fCellWidth(1),
+	fCellHeight(1),
+	fColumns(1),
+	fRows(1),
+	fCellCapacity(capacity * 2 > 16 ? capacity * 2 : 16),
+	fTests(0),
+	fCollisions(0)
+{
+	fX = new float[capacity];
+	fY = new float[capacity];
+	fPreviousX = new float[capacity];
+	fPreviousY = new float[capacity];
+	fWidth = new float[capacity];
+	fHeight = new float[capacity];
+	fSpeedX = new float[capacity];
+	fSpeedY = new float[capacity];
+	
+	fCellStarts = new int32[fCellCapacity + 1];
+	fCellSprites = new int32[capacity];
+	fSpriteCells = new int32[capacity];
+}
+
+
+ASField::~ASField()
+{
+	delete[] fX;
+	delete[] fY;
+	delete[] fPreviousX;
+	delete[] fPreviousY;
+	delete[] fWidth;
+	delete[] fHeight;
+	delete[] fSpeedX;
+	delete[] fSpeedY;
+	
+	delete[] fCellStarts;
+	delete[] fCellSprites;
+	delete[] fSpriteCells;
+}
+
+
+void
+ASField::SetBounds(int32 width, int32 height)
+{
+	fBoundsWidth = width;
+	fBoundsHeight = height;
+}
+
+
+int32
+ASField::AddSprite(float x, float y, float width, float height, float speedX,
+	float speedY)
+{
+	if (fCount == fCapacity)
+		return -1;
+	
+	int32 index = fCount++;
+	fX[index] = fPreviousX[index] = x;
+	fY[index] = fPreviousY[index] = y;
+	fWidth[index] = width;
+	fHeight[index] = height;
+	fSpeedX[index] = speedX;
+	fSpeedY[index] = speedY;
+	
+	return index;
+}
+
+
+void
+ASField::RemoveSprites()
+{
+	fCount = 0;
+	fSteps = 0;
+}
+
+
+void
+ASField::Scatter(int32 count, float width, float height, float minSpeed,
+	float maxSpeed, uint32 seed)
+{
+	Random random(seed);
+	RemoveSprites();
+	
+	int32 right = (int32)(fBoundsWidth - width);
+	int32 bottom = (int32)(fBoundsHeight - height);
+	
+	for (int32 i = 0; i < count; i++) {
+		float x = random.Range(0, right > 0 ? right : 0);
+		float y = random.Range(0, bottom > 0 ? bottom : 0);
+		
+		float speed = minSpeed
+			+ (maxSpeed - minSpeed) * random.Range(0, 1000) / 1000.0f;
+		float angle = random.Range(0, 359) * (float)M_PI / 180.0f;
+		
+		if (AddSprite(x, y, width, height, speed * cosf(angle),
+				speed * sinf(angle)) < 0)
+			break;
+	}
+}
+
+
+void
+ASField::Step()
+{
+	fSteps++;
+	_Move();
+	_BuildGrid();
+	
+	for (int32 row = 0; row < fRows; row++) {
+		for (int32 column = 0; column < fColumns; column++) {
+			int32 cell = row * fColumns + column;
+			int32 first = fCellStarts[cell];
+			int32 end = fCellStarts[cell + 1];
+			
+			for (int32 i = first; i < end; i++) {
+				int32 a = fCellSprites[i];
+				
+				// The sprites after this one in its own cell...
+				for (int32 j = i + 1; j < end; j++)
+					_Collide(a, fCellSprites[j]);
+				
+				// ...and every sprite in half of the cells around it
+				for (int32 n = 0; n < 4; n++) {
+					int32 otherColumn = column + kNeighbors[n][0];
+					int32 otherRow = row + kNeighbors[n][1];
+					if (otherColumn < 0 || otherColumn >= fColumns
+						|| otherRow >= fRows)
+						continue;
+					
+					int32 other = otherRow * fColumns + otherColumn;
+					for (int32 j = fCellStarts[other];
+							j < fCellStarts[other + 1]; j++)
+						_Collide(a, fCellSprites[j]);
+				}
+			}
+		}
+	}
+}
+
+
+void
+ASField::StepBruteForce()
+{
+	fSteps++;
+	_Move();
+	
+	for (int32 a = 0; a < fCount; a++) {
+		for (int32 b = a + 1; b < fCount; b++)
+			_Collide(a, b);
+	}
+}
+
+
+void
+ASField::WriteSnapshot(Snapshot& snapshot) const
+{
+	snapshot.Write(fBoundsWidth);
+	snapshot.Write(fBoundsHeight);
+	snapshot.Write(fSteps);
+	snapshot.Write(fCount);
+	
+	snapshot.WriteData(fX, fCount * sizeof(float));
+	snapshot.WriteData(fY, fCount * sizeof(float));
+	snapshot.WriteData(fPreviousX, fCount * sizeof(float));
+	snapshot.WriteData(fPreviousY, fCount * sizeof(float));
+	snapshot.WriteData(fWidth, fCount * sizeof(float));
+	snapshot.WriteData(fHeight, fCount * sizeof(float));
+	snapshot.WriteData(fSpeedX, fCount * sizeof(float));
+	snapshot.WriteData(fSpeedY, fCount * sizeof(float));
+}
+
+
+status_t
+ASField::ReadSnapshot(Snapshot& snapshot)
+{
+	RemoveSprites();
+	
+	int32 count;
+	snapshot.Read(&fBoundsWidth);
+	snapshot.Read(&fBoundsHeight);
+	snapshot.Read(&fSteps);
+	snapshot.Read(&count);
+	if (snapshot.Status() != B_OK || count < 0 || count > fCapacity) {
+		RemoveSprites();
+		return B_BAD_VALUE;
+	}
+	
+	snapshot.ReadData(fX, count * sizeof(float));
+	snapshot.ReadData(fY, count * sizeof(float));
+	snapshot.ReadData(fPreviousX, count * sizeof(float));
+	snapshot.ReadData(fPreviousY, count * sizeof(float));
+	snapshot.ReadData(fWidth, count * sizeof(float));
+	snapshot.ReadData(fHeight, count * sizeof(float));
+	snapshot.ReadData(fSpeedX, count * sizeof(float));
+	snapshot.ReadData(fSpeedY, count * sizeof(float));
+	if (snapshot.Status() != B_OK) {
+		RemoveSprites();
+		return B_BAD_VALUE;
+	}
+	
+	fCount = count;
+	return B_OK;
+}
+
+
+/*	Move every sprite by its speed, and bounce it off the
+	edges of the screen.
+*/
+void
+ASField::_Move()
+{
+	for (int32 i = 0; i < fCount; i++) {
+		fPreviousX[i] = fX[i];
+		fPreviousY[i] = fY[i];
+		
+		float x = fX[i] + fSpeedX[i];
+		float y = fY[i] + fSpeedY[i];
+		float right = fBoundsWidth - fWidth[i];
+		float bottom = fBoundsHeight - fHeight[i];
+		
+		if (x < 0) {
+			x = -x;
+			fSpeedX[i] = fabsf(fSpeedX[i]);
+		}
+		if (x > right) {
+			x = right > 0 ? 2 * right - x : 0;
+			fSpeedX[i] = -fabsf(fSpeedX[i]);
+		}
+		
+		if (y < 0) {
+			y = -y;
+			fSpeedY[i] = fabsf(fSpeedY[i]);
+		}
+		if (y > bottom) {
+			y = bottom > 0 ? 2 * bottom - y : 0;
+			fSpeedY[i] = -fabsf(fSpeedY[i]);
+		}
+		
+		fX[i] = x;
+		fY[i] = y;
+	}
+}
+
+
+/*	Sort the sprites by the cell their top left corner is in,
+	counting the sprites in every cell first. The cells are at
+	least as big as the biggest sprite, so sprites can only touch
+	sprites in the cells right next to theirs.
+*/
+void
+ASField::_BuildGrid()
+{
+	float biggestWidth = 1;
+	float biggestHeight = 1;
+	for (int32 i = 0; i < fCount; i++) {
+		if (fWidth[i] > biggestWidth)
+			biggestWidth = fWidth[i];
+		if (fHeight[i] > biggestHeight)
+			biggestHeight = fHeight[i];
+	}
+	
+	fCellWidth = biggestWidth;
+	fCellHeight = biggestHeight;
+	for (;;) {
+		fColumns = (int32)ceilf(fBoundsWidth / fCellWidth);
+		fRows = (int32)ceilf(fBoundsHeight / fCellHeight);
+		if (fColumns < 1)
+			fColumns = 1;
+		if (fRows < 1)
+			fRows = 1;
+		if (fColumns * fRows <= fCellCapacity)
+			break;
+		
+		fCellWidth *= 2;
+		fCellHeight *= 2;
+	}
+	
+	int32 cells = fColumns * fRows;
+	memset(fCellStarts, 0, (cells + 1) * sizeof(int32));
+	
+	for (int32 i = 0; i < fCount; i++) {
+		int32 column = (int32)(fX[i] / fCellWidth);
+		int32 row = (int32)(fY[i] / fCellHeight);
+		if (column < 0)
+			column = 0;
+		else if (column >= fColumns)
+			column = fColumns - 1;
+		if (row < 0)
+			row = 0;
+		else if (row >= fRows)
+			row = fRows - 1;
+		
+		fSpriteCells[i] = row * fColumns + column;
+		fCellStarts[fSpriteCells[i] + 1]++;
+	}
+	
+	for (int32 cell = 0; cell < cells; cell++)
+		fCellStarts[cell + 1] += fCellStarts[cell];
+	
+	// Fill every cell from its end backwards, using the start of
+	// the next cell as the counter, which leaves it at its own start
+	for (int32 i = fCount - 1; i >= 0; i--)
+		fCellSprites[--fCellStarts[fSpriteCells[i] + 1]] = i;
+	
+	for (int32 cell = cells; cell > 0; cell--)
+		fCellStarts[cell] = fCellStarts[cell - 1];
+	fCellStarts[0] = 0;
+}
+
+
+/*	If the two sprites overlap, push them apart the shortest way,
+	and if they were moving towards each other that way, swap their
+	speeds that way, as if they were two balls of the same weight.
+*/
+void
+ASField::_Collide(int32 a, int32 b)
+{
+	fTests++;
+	
+	float overlapX = fminf(fX[a] + fWidth[a], fX[b] + fWidth[b])
+		- fmaxf(fX[a], fX[b]);
+	float overlapY = fminf(fY[a] + fHeight[a], fY[b] + fHeight[b])
+		- fmaxf(fY[a], fY[b]);
+	if (overlapX <= 0 || overlapY <= 0)
+		return;
+	
+	fCollisions++;
+	
+	if (overlapX < overlapY) {
+		float push = fX[a] < fX[b] ? -overlapX / 2 : overlapX / 2;
+		fX[a] += push;
+		fX[b] -= push;
+		
+		if ((fSpeedX[a] - fSpeedX[b]) * push < 0) {
+			float speed = fSpeedX[a];
+			fSpeedX[a] = fSpeedX[b];
+			fSpeedX[b] = speed;
+		}
+	} else {
+		float push = fY[a] < fY[b] ? -overlapY / 2 : overlapY / 2;
+		fY[a] += push;
+		fY[b] -= push;
+		
+		if ((fSpeedY[a] - fSpeedY[b]) * push < 0) {
+			float speed = fSpeedY[a];
+			fSpeedY[a] = fSpeedY[b];
+			fSpeedY[b] = speed;
+		}
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _ASFIELD_H_
+#define _ASFIELD_H_
+
+
+#include "PortableDefs.h"
+#include "Random.h"
+
+
+class Snapshot;
+
+
+// The snapshots of AwesomeSaver, see ASField::WriteSnapshot(). Bump
+// the version whenever what goes into them changes.
+const uint32 kSnapshotType = 'ASst';
+const uint32 kSnapshotVersion = 1;
+
+
+/*	Sprites bouncing around the screen and off each other. Every
+	sprite is a box, and a sprite is where the top left corner of
+	its box is. Nothing in here needs a BView, so it runs just the
+	same in the screensaver and headless.
+
+	Where the sprites are and how they move is kept in arrays with
+	one entry per sprite, so the passes over all of them run over a
+	few tightly packed arrays of floats. To find the sprites that
+	run into each other, the screen is divided into a grid of cells
+	at least as big as the biggest sprite, so that every sprite only
+	needs to be checked against the ones in the cells around its own.
+*/
+class ASField
+{
+public:
+							ASField(int32 capacity);
+							~ASField();
+	
+	void					SetBounds(int32 width, int32 height);
+								// The screen, the sprites bounce off its
+								// edges
+	int32					AddSprite(float x, float y, float width,
+								float height, float speedX, float speedY);
+								// Returns the new sprite, or -1 if there
+								// is no room for it. The speed is in
+								// pixels per step.
+	void					RemoveSprites();
+	void					Scatter(int32 count, float width, float height,
+								float minSpeed, float maxSpeed,
+								uint32 seed);
+								// Remove all sprites and add "count" of
+								// them, all width by height, at random
+								// places and in random directions
+	
+	void					Step();
+								// Move every sprite, bounce it off the
+								// edges, and then off the other sprites
+	int64					CountSteps() const { return fSteps; };
+								// Since the sprites were scattered
+	
+	void					WriteSnapshot(Snapshot& snapshot) const;
+	status_t				ReadSnapshot(Snapshot& snapshot);
+								// Every sprite and the screen. Only as
+								// many sprites as there is room for;
+								// a snapshot that is no good leaves
+								// the field without sprites.
+	
+	int32					CountSprites() const { return fCount; };
+	int32					Capacity() const { return fCapacity; };
+	const float*			X() const { return fX; };
+	const float*			Y() const { return fY; };
+	const float*			PreviousX() const { return fPreviousX; };
+	const float*			PreviousY() const { return fPreviousY; };
+								// Where the sprites were one step ago
+	const float*			Width() const { return fWidth; };
+	const float*			Height() const { return fHeight; };
+	const float*			SpeedX() const { return fSpeedX; };
+	const float*			SpeedY() const { return fSpeedY; };
+	
+	int64					CountTests() const { return fTests; };
+	int64					CountCollisions() const { return fCollisions; };
+								// The pairs of sprites that were checked,
+								// and that ran into each other, since the
+								// field was made
+	
+	void					StepBruteForce();
+								// Step() checking every pair of sprites
+								// instead of using the grid, to compare
+	
+private:
+	void					_Move();
+	void					_BuildGrid();
+	void					_Collide(int32 a, int32 b);
+	
+	int32					fCapacity;
+	int32					fCount;
+	int64					fSteps;
+	
+	float*					fX;
+	float*					fY;
+	float*					fPreviousX;
+	float*					fPreviousY;
+	float*					fWidth;
+	float*					fHeight;
+	float*					fSpeedX;
+	float*					fSpeedY;
+	
+	float					fBoundsWidth;
+	float					fBoundsHeight;
+	
+	float					fCellWidth;
+	float					fCellHeight;
+	int32					fColumns;
+	int32					fRows;
+	int32					fCellCapacity;
+								// The most cells the grid can have, the
+								// cells are made bigger to stay below it
+	int32*					fCellStarts;
+								// Where the sprites of every cell start in
+								// fCellSprites, with one more at the end
+	int32*					fCellSprites;
+								// Every sprite, sorted by its cell
+	int32*					fSpriteCells;
+	
+	int64					fTests;
+	int64					fCollisions;
+};
+
+
+#endif
@@ -1,35 +1,77 @@
 //
 // An awesome screensaver
 //
+#include <stdlib.h>
+
+#include <Bitmap.h>
 #include <ScreenSaver.h>
 #include <StringView.h>
 
+#include "ASField.h"
+#include "FrameTrace.h"
+#include "Snapshot.h"
+#include "TextMask.h"
+
+
+const char* kText = "Haiku is AWESOME!";
+const uint32 kTextColor = 0xfff9d22a; // Haiku yellow
+const uint32 kBackgroundColor = 0xff000000; // Black
+const int32 kSpriteCount = 10; // How many times the text bounces around
+
 
 class AwesomeSaver : public BScreenSaver
 {
 public:
 					AwesomeSaver(BMessage* archive, image_id thisImage);
+					~AwesomeSaver();
 	void			StartConfig(BView* configView);
 	status_t		StartSaver(BView* view, bool preview);
 	void			Draw(BView* view, int32 frame);
 private:
+	BRect			_SpriteRect(float x, float y) const;
+	void			_DrawOverlay(BView* view);
+	
 	// These variables are specific to AwesomeSaver
-	int32			fX;
-	int32			fY;
-	int32			fChangeX;
-	int32			fChangeY;
+	ASField			fField;
+	
+	// The text is only rendered once, and drawn into a
+	// bitmap as big as the screen, of which only the
+	// parts that changed are drawn on the screen
+	TextMask		fText;
+	BBitmap*		fBack;
+	
+	// How long the frames take, only when asked
+	// for in the environment
+	FrameTrace		fTrace;
+	BRect			fOverlayRect;
+	
+	// The texts before the slowest frame, also
+	// only when asked for in the environment
+	Snapshot		fSnapshot;
+	const char*		fSnapshotPath;
+	bigtime_t		fSlowestFrame;
 };
 
 
 AwesomeSaver::AwesomeSaver(BMessage* archive, image_id thisImage)
 	:
 	BScreenSaver(archive, thisImage), // Call the constructor for BScreenSaver
-	fX(200), // Initialize variable
-	fY(100),
-	fChangeX(1),
-	fChangeY(1)
+	fField(kSpriteCount), // Initialize variable
+	fBack(NULL),
+	fSnapshot(kSnapshotType, kSnapshotVersion),
+	fSnapshotPath(getenv(SNAPSHOT_VARIABLE)),
+	fSlowestFrame(0)
 {
-	// Empty
+	fTrace.ConfigureFromEnvironment();
+}
+
+
+AwesomeSaver::~AwesomeSaver()
+{
+	delete fBack;
+	
+	if (fTrace.DumpPath() != NULL)
+		fTrace.DumpChromeTrace(fTrace.DumpPath());
 }
 
 
@@ -54,45 +96,147 @@ AwesomeSaver::StartConfig(BView* configView)
 status_t
 AwesomeSaver::StartSaver(BView* view, bool preview)
 {
-	if (preview) {
-		fX = 20;
-		fY = 10;
-	}
+	// Render the text in the font of the view, like
+	// DrawString() would, once and for all
+	BFont font;
+	view->GetFont(&font);
+	status_t status = fText.SetTo(kText, font);
+	if (status != B_OK)
+		return status;
+	fText.SetColor(kTextColor);
+	
+	delete fBack;
+	fBack = new BBitmap(view->Bounds().OffsetToCopy(B_ORIGIN), B_RGB32);
+	if (fBack->InitCheck() != B_OK)
+		return fBack->InitCheck();
+	
+	TextMask::FillRect(fBack->Bits(), fBack->BytesPerRow(), 0, 0,
+		fBack->Bounds().IntegerWidth() + 1,
+		fBack->Bounds().IntegerHeight() + 1, kBackgroundColor);
+	
+	// Scatter the text around the screen, only once in the preview
+	fField.SetBounds(fBack->Bounds().IntegerWidth() + 1,
+		fBack->Bounds().IntegerHeight() + 1);
+	fField.Scatter(preview ? 1 : kSpriteCount, fText.Width(),
+		fText.Height(), 1, 2, (uint32)system_time());
 	
 	return B_OK;
 }
 
 
-const char* kText = "Haiku is AWESOME!";
-
-
 void
 AwesomeSaver::Draw(BView* view, int32 frame)
 {
+	bigtime_t now = system_time();
+	fTrace.BeginFrame();
+	
+	// Keep what the frame starts from, in case it is the slowest
+	if (fSnapshotPath != NULL) {
+		fSnapshot.MakeEmpty();
+		fField.WriteSnapshot(fSnapshot);
+	}
+	
 	if (frame == 0) {
 		// Erase the screen
 		view->SetLowColor(0, 0, 0);
 		view->FillRect(view->Bounds(), B_SOLID_LOW);
 	}
 	
-	// Erase the old text
-	view->SetHighColor(0, 0, 0); // Black
-	view->DrawString(kText, BPoint(fX, fY));
+	{
+		TRACE_SCOPE(&fTrace, "update");
+		
+		// Move the text, and bounce off the edges of the
+		// screen and off each other
+		fField.Step();
+	}
+	
+	int32 count = fField.CountSprites();
+	const float* x = fField.X();
+	const float* y = fField.Y();
+	const float* previousX = fField.PreviousX();
+	const float* previousY = fField.PreviousY();
+	
+	int32 width = fBack->Bounds().IntegerWidth() + 1;
+	int32 height = fBack->Bounds().IntegerHeight() + 1;
+	
+	// Erase the old text, all of it before any of it is
+	// drawn again, where the texts overlap
+	{
+		TRACE_SCOPE(&fTrace, "clear");
+		for (int32 i = 0; i < count; i++) {
+			BRect rect = _SpriteRect(previousX[i], previousY[i]);
+			TextMask::FillRect(fBack->Bits(), fBack->BytesPerRow(),
+				(int32)rect.left, (int32)rect.top, (int32)rect.right + 1,
+				(int32)rect.bottom + 1, kBackgroundColor);
+		}
+	}
+	
+	// Draw the text at its new locations
+	{
+		TRACE_SCOPE(&fTrace, "compose");
+		for (int32 i = 0; i < count; i++) {
+			fText.Draw(fBack->Bits(), fBack->BytesPerRow(), width, height,
+				(int32)x[i] + fText.OriginX(), (int32)y[i] + fText.OriginY());
+		}
+	}
+	
+	// Only draw where every text was and is now
+	{
+		TRACE_SCOPE(&fTrace, "present");
+		for (int32 i = 0; i < count; i++) {
+			BRect rect = _SpriteRect(previousX[i], previousY[i])
+				| _SpriteRect(x[i], y[i]);
+			if (rect.IsValid())
+				view->DrawBitmap(fBack, rect, rect);
+		}
+		
+		// Wait for the app_server to draw it, otherwise
+		// that isn't timed at all
+		if (fTrace.IsEnabled())
+			view->Sync();
+	}
+	
+	if (fTrace.ShowsOverlay())
+		_DrawOverlay(view);
 	
-	// Move the text
-	fX += fChangeX;
-	fY += fChangeY;
+	fTrace.EndFrame();
+	
+	bigtime_t cost = system_time() - now;
+	if (fSnapshotPath != NULL && frame > 0 && cost > fSlowestFrame) {
+		fSlowestFrame = cost;
+		fSnapshot.WriteFile(fSnapshotPath);
+	}
+}
+
+
+// Where a text is drawn at x, y, clipped to the screen
+BRect
+AwesomeSaver::_SpriteRect(float x, float y) const
+{
+	BRect rect((int32)x, (int32)y, (int32)x + fText.Width() - 1,
+		(int32)y + fText.Height() - 1);
+	return rect & fBack->Bounds();
+}
+
+
+// Show how long the frames took, in the top left corner
+void
+AwesomeSaver::_DrawOverlay(BView* view)
+{
+	char summary[256];
+	fTrace.GetSummary(summary, sizeof(summary));
 	
-	// Bounce off the edge of the screen
-	if (fX <= 0 || fX >= view->Bounds().right)
-		fChangeX = -fChangeX;
+	// Erase the last one first
+	view->SetLowColor(0, 0, 0);
+	view->FillRect(fOverlayRect, B_SOLID_LOW);
 	
-	if (fY <= 0 || fY >= view->Bounds().bottom)
-		fChangeY = -fChangeY;
+	font_height height;
+	view->GetFontHeight(&height);
+	fOverlayRect.Set(10, 20 - height.ascent, 10 + view->StringWidth(summary),
+		20 + height.descent);
 	
-	// Draw the text at its new location
-	view->SetHighColor(249, 210, 42); // Haiku yellow
-	view->DrawString(kText, BPoint(fX, fY));
+	view->SetHighColor(255, 255, 255);
+	view->DrawString(summary, BPoint(10, 20));
 }
 
 
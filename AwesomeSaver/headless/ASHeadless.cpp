@@ -0,0 +1,550 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Runs the AwesomeSaver drawing without the screensaver host,
+	into a plain block of memory instead of a BView. For a few text
+	sizes, it times the frames drawn the old way, rasterizing the
+	text twice every frame, and the new way, drawing the text from
+	a TextMask into a small patch that is then copied to the screen.
+	It also counts every allocation made while drawing, which should
+	be none, and prints a checksum of the last frame.
+
+	Then it times how long moving more and more sprites around in an
+	ASField takes, with the grid, and checking every pair of sprites
+	for as long as that doesn't take forever.
+
+	It can also save a snapshot of the sprites before one step, and
+	run on from a snapshot, from this harness or from the screensaver,
+	to look at one slow step on its own.
+*/
+
+
+#include <algorithm>
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ASField.h"
+#include "ShapeText.h"
+#include "Snapshot.h"
+#include "TextMask.h"
+
+
+static const char* kText = "Haiku is AWESOME!";
+static const uint32 kTextColor = 0xfff9d22a;
+static const uint32 kBackgroundColor = 0xff000000;
+
+static const int32 kSizes[] = { 12, 24, 48, 96 };
+static const int32 kSpriteCounts[] = { 100, 1000, 10000, 100000 };
+static const int32 kMostBruteForceSprites = 2000;
+static const bigtime_t kFrameBudget = 16667;
+	// A frame at 60 Hz
+
+
+// Counts every operator new, see below
+static int64 sAllocations = 0;
+
+
+/*	Both forms of operator new allocate with this, and both forms of
+	operator delete free with free(), so that they always match, even
+	where the compiler sees through one calling the other.
+*/
+static void*
+counted_malloc(size_t size)
+{
+	sAllocations++;
+	void* memory = malloc(size != 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+
+void*
+operator new(size_t size)
+{
+	return counted_malloc(size);
+}
+
+
+void*
+operator new[](size_t size)
+{
+	return counted_malloc(size);
+}
+
+
+void
+operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete[](void* memory) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete(void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete[](void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+
+static uint32
+checksum(const uint8* bits, int32 width, int32 height)
+{
+	// FNV-1a over every pixel
+	uint32 hash = 2166136261U;
+	for (int32 i = 0; i < width * height * 4; i++) {
+		hash ^= bits[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+
+static uint32
+field_checksum(const ASField& field)
+{
+	// FNV-1a over where every sprite is
+	uint32 hash = 2166136261U;
+	const float* coordinates[2] = { field.X(), field.Y() };
+	for (int32 i = 0; i < 2; i++) {
+		const uint8* bytes = (const uint8*)coordinates[i];
+		for (size_t j = 0; j < field.CountSprites() * sizeof(float); j++) {
+			hash ^= bytes[j];
+			hash *= 16777619U;
+		}
+	}
+	return hash;
+}
+
+
+static bigtime_t
+percentile(const bigtime_t* sorted, int32 count, int32 percent)
+{
+	return sorted[(int64)(count - 1) * percent / 100];
+}
+
+
+/*	Copy the patch to the screen with its top left corner at
+	left, top, clipped to the screen, like DrawBitmap() does.
+*/
+static void
+copy_patch(const uint8* patch, int32 patchWidth, int32 patchHeight,
+	uint8* screen, int32 width, int32 height, int32 left, int32 top)
+{
+	int32 first = left < 0 ? -left : 0;
+	int32 last = left + patchWidth > width ? width - left : patchWidth;
+	if (first >= last)
+		return;
+	
+	for (int32 row = top < 0 ? -top : 0; row < patchHeight
+			&& top + row < height; row++) {
+		memcpy(screen + ((top + row) * width + left + first) * 4,
+			patch + (row * patchWidth + first) * 4, (last - first) * 4);
+	}
+}
+
+
+/*	Bounce the pen around like AwesomeSaver::Draw() does.
+*/
+static void
+move(int32& x, int32& y, int32& changeX, int32& changeY, int32 width,
+	int32 height)
+{
+	x += changeX;
+	y += changeY;
+	
+	if (x <= 0 || x >= width - 1)
+		changeX = -changeX;
+	if (y <= 0 || y >= height - 1)
+		changeY = -changeY;
+}
+
+
+/*	Scatter "count" sprites over the screen, twice as wide as high,
+	like the text, and sized to cover about a quarter of the screen
+	together.
+*/
+static float
+scatter(ASField& field, int32 count, int32 width, int32 height)
+{
+	float spriteHeight = sqrtf((float)width * height / (8.0f * count));
+	if (spriteHeight < 1)
+		spriteHeight = 1;
+	
+	field.SetBounds(width, height);
+	field.Scatter(count, spriteHeight * 2, spriteHeight, 1, 4, 1);
+	
+	return spriteHeight;
+}
+
+
+/*	Step "count" sprites for "frames" frames, with the grid or
+	checking every pair, and print how long the steps took.
+*/
+static bigtime_t
+time_field(int32 count, bool bruteForce, int32 width, int32 height,
+	int32 frames, bigtime_t* times)
+{
+	ASField field(count);
+	float spriteHeight = scatter(field, count, width, height);
+	
+	int64 allocations = sAllocations;
+	
+	for (int32 frame = 0; frame < frames; frame++) {
+		bigtime_t start = system_time();
+		
+		if (bruteForce)
+			field.StepBruteForce();
+		else
+			field.Step();
+		
+		times[frame] = system_time() - start;
+	}
+	
+	allocations = sAllocations - allocations;
+	
+	std::sort(times, times + frames);
+	
+	printf("\t%-6d sprites %5.1fx%-5.1f %-11s p50 %7lld  p99 %7lld us  "
+		"%9.0f tests  %7.0f collisions per step  %lld allocations\n",
+		(int)count, spriteHeight * 2, spriteHeight,
+		bruteForce ? "every pair" : "grid",
+		(long long)percentile(times, frames, 50),
+		(long long)percentile(times, frames, 99),
+		(double)field.CountTests() / frames,
+		(double)field.CountCollisions() / frames, (long long)allocations);
+	
+	return percentile(times, frames, 99);
+}
+
+
+/*	Step "count" sprites for "frames" frames, saving the
+	sprites before step "at", and print where they end up.
+*/
+static int
+save_snapshot(const char* path, int32 at, int32 count, int32 width,
+	int32 height, int32 frames)
+{
+	ASField field(count);
+	scatter(field, count, width, height);
+	Snapshot snapshot(kSnapshotType, kSnapshotVersion);
+	
+	for (int32 frame = 0; frame < frames; frame++) {
+		if (frame == at) {
+			field.WriteSnapshot(snapshot);
+			if (snapshot.WriteFile(path) != B_OK) {
+				fprintf(stderr, "Could not write the snapshot to %s\n", path);
+				return 1;
+			}
+		}
+		field.Step();
+	}
+	
+	printf("AwesomeSaver: %d sprites on %dx%d, snapshot before step %d "
+		"saved to %s\n", (int)count, (int)width, (int)height, (int)at,
+		path);
+	printf("checksum after %d steps: 0x%08x\n", (int)frames,
+		(unsigned)field_checksum(field));
+	
+	return 0;
+}
+
+
+/*	Step the sprites on from the snapshot "frames" times, "repeat"
+	times over, and print how long the steps took and whether every
+	run ended with the sprites in the same places.
+*/
+static int
+replay(const char* path, int32 frames, int32 repeat)
+{
+	Snapshot snapshot(kSnapshotType, kSnapshotVersion);
+	if (snapshot.ReadFile(path) != B_OK) {
+		fprintf(stderr, "%s is not an AwesomeSaver snapshot\n", path);
+		return 1;
+	}
+	
+	// Every sprite takes eight floats, so there
+	// can't be more than this many in there
+	ASField field(snapshot.Size() / (8 * sizeof(float)));
+	if (field.ReadSnapshot(snapshot) != B_OK) {
+		fprintf(stderr, "%s is damaged\n", path);
+		return 1;
+	}
+	
+	int64 step = field.CountSteps();
+	bigtime_t* times = new bigtime_t[frames * repeat];
+	uint32 first = 0;
+	bool same = true;
+	int64 allocations = 0;
+	
+	for (int32 run = 0; run < repeat; run++) {
+		snapshot.Rewind();
+		field.ReadSnapshot(snapshot);
+		
+		int64 started = sAllocations;
+		for (int32 frame = 0; frame < frames; frame++) {
+			bigtime_t start = system_time();
+			field.Step();
+			times[run * frames + frame] = system_time() - start;
+		}
+		allocations += sAllocations - started;
+		
+		uint32 sum = field_checksum(field);
+		if (run == 0)
+			first = sum;
+		else if (sum != first)
+			same = false;
+	}
+	
+	int32 count = frames * repeat;
+	std::sort(times, times + count);
+	
+	printf("AwesomeSaver replay of %s: %d sprites from step %lld, "
+		"%d steps, %d times\n", path, (int)field.CountSprites(),
+		(long long)step, (int)frames, (int)repeat);
+	printf("step time (us): p50 %lld  p99 %lld  max %lld\n",
+		(long long)percentile(times, count, 50),
+		(long long)percentile(times, count, 99),
+		(long long)times[count - 1]);
+	printf("allocations while stepping: %lld\n", (long long)allocations);
+	
+	const char* verdict = "";
+	if (repeat > 1)
+		verdict = same ? ", the same every time" : ", NOT the same every time";
+	printf("checksum after %d steps: 0x%08x%s\n", (int)frames,
+		(unsigned)first, verdict);
+	
+	delete[] times;
+	
+	return same ? 0 : 1;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--width n] [--height n] [--frames n]\n"
+		"\t[--size pixels] [--sprites n]\n"
+		"       %s --snapshot file --at step [--sprites n] [--width n]\n"
+		"\t[--height n] [--frames n]\n"
+		"       %s --replay file [--frames n] [--repeat n]\n",
+		name, name, name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 width = 1920;
+	int32 height = 1080;
+	int32 frames = 1000;
+	int32 size = 0;
+	int32 sprites = 0;
+	const char* snapshotPath = NULL;
+	int32 snapshotAt = 0;
+	const char* replayPath = NULL;
+	int32 repeat = 1;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--width") == 0)
+			width = value;
+		else if (strcmp(argv[i], "--height") == 0)
+			height = value;
+		else if (strcmp(argv[i], "--frames") == 0)
+			frames = value;
+		else if (strcmp(argv[i], "--size") == 0)
+			size = value;
+		else if (strcmp(argv[i], "--sprites") == 0)
+			sprites = value;
+		else if (strcmp(argv[i], "--snapshot") == 0)
+			snapshotPath = argv[i + 1];
+		else if (strcmp(argv[i], "--at") == 0)
+			snapshotAt = value;
+		else if (strcmp(argv[i], "--replay") == 0)
+			replayPath = argv[i + 1];
+		else if (strcmp(argv[i], "--repeat") == 0)
+			repeat = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (width < 1 || height < 1 || frames < 1 || size < 0 || sprites < 0
+		|| repeat < 1 || snapshotAt < 0 || snapshotAt >= frames)
+		usage(argv[0]);
+	
+	if (replayPath != NULL)
+		return replay(replayPath, frames, repeat);
+	if (snapshotPath != NULL) {
+		return save_snapshot(snapshotPath, snapshotAt,
+			sprites != 0 ? sprites : 1000, width, height, frames);
+	}
+	
+	uint8* screen = new uint8[width * height * 4];
+	bigtime_t* rasterized = new bigtime_t[frames];
+	bigtime_t* cached = new bigtime_t[frames];
+	
+	printf("AwesomeSaver headless: %dx%d, %d frames\n", (int)width,
+		(int)height, (int)frames);
+	
+	// Every size, unless one was asked for
+	const int32* sizes = kSizes;
+	int32 sizeCount = sizeof(kSizes) / sizeof(kSizes[0]);
+	if (size != 0) {
+		sizes = &size;
+		sizeCount = 1;
+	}
+	
+	for (int32 i = 0; i < sizeCount; i++) {
+		int32 textSize = sizes[i];
+		
+		// Render the text once, white on black, for the mask
+		int32 textWidth = ShapeText::Width(kText, textSize);
+		int32 textHeight = textSize + 2;
+		uint8* rendered = new uint8[(textWidth + 2) * textHeight * 4];
+		TextMask::FillRect(rendered, (textWidth + 2) * 4, 0, 0,
+			textWidth + 2, textHeight, kBackgroundColor);
+		ShapeText::Draw(kText, textSize, 0xffffffff, rendered,
+			(textWidth + 2) * 4, textWidth + 2, textHeight, 1, textSize + 1);
+		
+		TextMask mask;
+		mask.SetTo(rendered, (textWidth + 2) * 4, textWidth + 2, textHeight,
+			1, textSize + 1);
+		mask.SetColor(kTextColor);
+		delete[] rendered;
+		
+		int32 patchWidth = mask.Width() + 1;
+		int32 patchHeight = mask.Height() + 1;
+		uint8* patch = new uint8[patchWidth * patchHeight * 4];
+		
+		int64 allocations = sAllocations;
+		
+		// The old way: erase the text by drawing it in black,
+		// then draw it again in yellow, rasterizing it both times
+		TextMask::FillRect(screen, width * 4, 0, 0, width, height,
+			kBackgroundColor);
+		int32 x = 200;
+		int32 y = 100;
+		int32 changeX = 1;
+		int32 changeY = 1;
+		
+		for (int32 frame = 0; frame < frames; frame++) {
+			bigtime_t start = system_time();
+			
+			ShapeText::Draw(kText, textSize, kBackgroundColor, screen,
+				width * 4, width, height, x, y);
+			move(x, y, changeX, changeY, width, height);
+			ShapeText::Draw(kText, textSize, kTextColor, screen, width * 4,
+				width, height, x, y);
+			
+			rasterized[frame] = system_time() - start;
+		}
+		
+		// The new way: fill the patch, draw the mask into
+		// it, and copy it to where the text was and is
+		TextMask::FillRect(screen, width * 4, 0, 0, width, height,
+			kBackgroundColor);
+		x = 200;
+		y = 100;
+		changeX = 1;
+		changeY = 1;
+		
+		for (int32 frame = 0; frame < frames; frame++) {
+			bigtime_t start = system_time();
+			
+			int32 oldX = x;
+			int32 oldY = y;
+			move(x, y, changeX, changeY, width, height);
+			
+			int32 left = std::min(oldX, x) - mask.OriginX();
+			int32 top = std::min(oldY, y) - mask.OriginY();
+			TextMask::FillRect(patch, patchWidth * 4, 0, 0, patchWidth,
+				patchHeight, kBackgroundColor);
+			mask.Draw(patch, patchWidth * 4, patchWidth, patchHeight,
+				x - left, y - top);
+			copy_patch(patch, patchWidth, patchHeight, screen, width, height,
+				left, top);
+			
+			cached[frame] = system_time() - start;
+		}
+		
+		allocations = sAllocations - allocations;
+		
+		std::sort(rasterized, rasterized + frames);
+		std::sort(cached, cached + frames);
+		
+		printf("text %d pixels high, mask %dx%d (%d%% covered):\n",
+			(int)textSize, (int)mask.Width(), (int)mask.Height(),
+			(int)(100 * mask.CoveredPixels()
+				/ std::max(1, (int)(mask.Width() * mask.Height()))));
+		printf("\trasterized twice (us): p50 %lld  p99 %lld\n",
+			(long long)percentile(rasterized, frames, 50),
+			(long long)percentile(rasterized, frames, 99));
+		printf("\tfrom the mask (us):    p50 %lld  p99 %lld  %.1f Mpixels/s\n",
+			(long long)percentile(cached, frames, 50),
+			(long long)percentile(cached, frames, 99),
+			percentile(cached, frames, 50) > 0
+				? (double)patchWidth * patchHeight
+					/ percentile(cached, frames, 50) : 0.0);
+		printf("\tallocations while drawing: %lld  checksum: 0x%08x\n",
+			(long long)allocations,
+			(unsigned)checksum(screen, width, height));
+		
+		delete[] patch;
+	}
+	
+	// Every count of sprites, unless one was asked for
+	const int32* counts = kSpriteCounts;
+	int32 countCount = sizeof(kSpriteCounts) / sizeof(kSpriteCounts[0]);
+	if (sprites != 0) {
+		counts = &sprites;
+		countCount = 1;
+	}
+	
+	printf("bouncing sprites (a frame at 60 Hz is %lld us):\n",
+		(long long)kFrameBudget);
+	
+	int32 mostInBudget = 0;
+	for (int32 i = 0; i < countCount; i++) {
+		if (time_field(counts[i], false, width, height, frames, cached)
+				<= kFrameBudget && counts[i] > mostInBudget)
+			mostInBudget = counts[i];
+		
+		if (counts[i] <= kMostBruteForceSprites)
+			time_field(counts[i], true, width, height, frames, rasterized);
+	}
+	
+	printf("\tmost sprites stepped within a frame (p99): %d\n",
+		(int)mostInBudget);
+	
+	delete[] rasterized;
+	delete[] cached;
+	delete[] screen;
+	
+	return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ShapeText.h"
+
+#include <ctype.h>
+
+
+// The letters, a row of 5 bits for each of the 7 rows
+static const uint8 kLetters[26][7] = {
+	{ 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },	// A
+	{ 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e },	// B
+	{ 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e },	// C
+	{ 0x1e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1e },	// D
+	{ 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f },	// E
+	{ 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 },	// F
+	{ 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f },	// G
+	{ 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },	// H
+	{ 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e },	// I
+	{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c },	// J
+	{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },	// K
+	{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f },	// L
+	{ 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 },	// M
+	{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },	// N
+	{ 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },	// O
+	{ 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 },	// P
+	{ 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d },	// Q
+	{ 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 },	// R
+	{ 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e },	// S
+	{ 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },	// T
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },	// U
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 },	// V
+	{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a },	// W
+	{ 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 },	// X
+	{ 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x04 },	// Y
+	{ 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f },	// Z
+};
+
+static const uint8 kExclamation[7] = {
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04
+};
+
+// Every letter is this many blocks wide, with the space after it
+static const int32 kCellWidth = 6;
+static const int32 kCellHeight = 7;
+
+// Every pixel is sampled this many times in each direction
+static const int32 kSamples = 4;
+
+
+static const uint8*
+glyph_for(char character)
+{
+	if (isalpha((unsigned char)character))
+		return kLetters[toupper((unsigned char)character) - 'A'];
+	if (character == '!')
+		return kExclamation;
+	
+	// Everything else is a space
+	return NULL;
+}
+
+
+static inline uint32
+scale(uint32 color, uint32 coverage)
+{
+	uint32 rb = (color & 0x00ff00ff) * coverage + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+	uint32 ag = ((color >> 8) & 0x00ff00ff) * coverage + 0x00800080;
+	ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+	
+	return ag | rb;
+}
+
+
+int32
+ShapeText::Width(const char* text, int32 size)
+{
+	int32 length = 0;
+	while (text[length] != '\0')
+		length++;
+	
+	return (length * kCellWidth * size + kCellHeight - 1) / kCellHeight;
+}
+
+
+void
+ShapeText::Draw(const char* text, int32 size, uint32 color, uint8* bits,
+	int32 bytesPerRow, int32 width, int32 height, int32 x, int32 y)
+{
+	int32 left = x < 0 ? 0 : x;
+	int32 top = y - size < 0 ? 0 : y - size;
+	int32 right = x + Width(text, size);
+	int32 bottom = y > height ? height : y;
+	if (right > width)
+		right = width;
+	
+	// The size of a block, in samples
+	float block = (float)size * kSamples / kCellHeight;
+	
+	for (int32 row = top; row < bottom; row++) {
+		uint32* dest = (uint32*)(bits + row * bytesPerRow);
+		
+		for (int32 column = left; column < right; column++) {
+			int32 covered = 0;
+			
+			for (int32 i = 0; i < kSamples * kSamples; i++) {
+				float sx = (column - x) * kSamples + i % kSamples + 0.5f;
+				float sy = (row - y + size) * kSamples + i / kSamples + 0.5f;
+				
+				int32 bx = (int32)(sx / block);
+				int32 by = (int32)(sy / block);
+				if (by >= kCellHeight || bx % kCellWidth == kCellWidth - 1)
+					continue;
+				
+				const uint8* glyph = glyph_for(text[bx / kCellWidth]);
+				if (glyph != NULL
+					&& (glyph[by] >> (4 - bx % kCellWidth) & 1) != 0)
+					covered++;
+			}
+			
+			if (covered == 0)
+				continue;
+			
+			uint32 coverage = covered * 255 / (kSamples * kSamples);
+			dest[column] = scale(color, coverage)
+				+ scale(dest[column], 255 - coverage);
+		}
+	}
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SHAPETEXT_H_
+#define _SHAPETEXT_H_
+
+
+#include "PortableDefs.h"
+
+
+/*	Stands in for the fonts when there is no app_server. Every letter
+	is a 5 by 7 grid of blocks, sampled a few times in every pixel so
+	the edges are smooth. Lower case letters are drawn in upper case.
+*/
+class ShapeText
+{
+public:
+	static int32	Width(const char* text, int32 size);
+						// Of the text with letters "size"
+						// pixels high
+	static void		Draw(const char* text, int32 size, uint32 color,
+						uint8* bits, int32 bytesPerRow, int32 width,
+						int32 height, int32 x, int32 y);
+						// Blend the text in the opaque color over
+						// 32 bit pixels, with the pen at x, y on
+						// the baseline, like DrawString()
+};
+
+
+#endif
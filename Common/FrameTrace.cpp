@@ -0,0 +1,338 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FrameTrace.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef __HAIKU__
+#include <pthread.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+
+// The most different event names GetSummary() shows
+const int32 kMaxSummaryNames = 8;
+
+
+FrameTrace::FrameTrace(int32 events, int32 frames)
+	:
+	fEvents(NULL),
+	fEventMask(_RoundUp(events) - 1),
+	fNextEvent(0),
+	fFrameStarts(NULL),
+	fFrameTimes(NULL),
+	fSorted(NULL),
+	fFrameMask(_RoundUp(frames) - 1),
+	fFrameCount(0),
+	fFrameStart(0),
+	fEnabled(false),
+	fOverlay(false)
+{
+	fEvents = new event[fEventMask + 1];
+	memset(fEvents, 0, sizeof(event) * (fEventMask + 1));
+	
+	fFrameStarts = new bigtime_t[fFrameMask + 1];
+	fFrameTimes = new bigtime_t[fFrameMask + 1];
+	fSorted = new bigtime_t[fFrameMask + 1];
+	
+	fDumpPath[0] = '\0';
+}
+
+
+FrameTrace::~FrameTrace()
+{
+	delete[] fEvents;
+	delete[] fFrameStarts;
+	delete[] fFrameTimes;
+	delete[] fSorted;
+}
+
+
+void
+FrameTrace::SetDumpPath(const char* path)
+{
+	if (path == NULL
+		|| snprintf(fDumpPath, sizeof(fDumpPath), "%s", path)
+			>= (int)sizeof(fDumpPath))
+		fDumpPath[0] = '\0';
+}
+
+
+const char*
+FrameTrace::DumpPath() const
+{
+	return fDumpPath[0] != '\0' ? fDumpPath : NULL;
+}
+
+
+void
+FrameTrace::ConfigureFromEnvironment(const char* variable)
+{
+	const char* value = getenv(variable);
+	if (value == NULL || value[0] == '\0' || strcmp(value, "off") == 0)
+		return;
+	
+	fEnabled = true;
+	
+	while (*value != '\0') {
+		const char* end = strchr(value, ',');
+		size_t length = end != NULL ? end - value : strlen(value);
+		
+		if (length == 7 && strncmp(value, "overlay", 7) == 0)
+			fOverlay = true;
+		else if (length > 5 && strncmp(value, "json=", 5) == 0) {
+			if (length - 5 < sizeof(fDumpPath)) {
+				memcpy(fDumpPath, value + 5, length - 5);
+				fDumpPath[length - 5] = '\0';
+			}
+		}
+		
+		value += length;
+		if (*value == ',')
+			value++;
+	}
+}
+
+
+/*	Any number of threads can add events at the same time. Each one
+	takes the next slot in the ring, and marks it as written once it
+	has filled it in, so that the readers can skip over slots that are
+	still being written, or that were taken over since.
+*/
+void
+FrameTrace::AddEvent(const char* name, bigtime_t start, bigtime_t duration)
+{
+	uint32 index = __atomic_fetch_add(&fNextEvent, 1, __ATOMIC_RELAXED);
+	event& slot = fEvents[index & fEventMask];
+	
+	__atomic_store_n(&slot.sequence, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	
+	__atomic_store_n(&slot.name, name, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot.start, start, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot.duration, duration, __ATOMIC_RELAXED);
+	__atomic_store_n(&slot.thread, _CurrentThread(), __ATOMIC_RELAXED);
+	
+	__atomic_store_n(&slot.sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+
+void
+FrameTrace::BeginFrame()
+{
+	if (fEnabled)
+		fFrameStart = system_time();
+}
+
+
+void
+FrameTrace::EndFrame()
+{
+	if (!fEnabled || fFrameStart == 0)
+		return;
+	
+	bigtime_t duration = system_time() - fFrameStart;
+	AddEvent("frame", fFrameStart, duration);
+	
+	fFrameStarts[fFrameCount & fFrameMask] = fFrameStart;
+	fFrameTimes[fFrameCount & fFrameMask] = duration;
+	fFrameCount++;
+	fFrameStart = 0;
+}
+
+
+int32
+FrameTrace::CountFrames() const
+{
+	return std::min(fFrameCount, fFrameMask + 1);
+}
+
+
+float
+FrameTrace::FramesPerSecond() const
+{
+	int32 count = CountFrames();
+	if (count < 2)
+		return 0;
+	
+	bigtime_t first = fFrameStarts[(fFrameCount - count) & fFrameMask];
+	bigtime_t last = fFrameStarts[(fFrameCount - 1) & fFrameMask];
+	if (last <= first)
+		return 0;
+	
+	return (count - 1) * 1000000.0f / (last - first);
+}
+
+
+bigtime_t
+FrameTrace::FramePercentile(int32 percent)
+{
+	int32 count = CountFrames();
+	if (count == 0)
+		return 0;
+	
+	memcpy(fSorted, fFrameTimes, count * sizeof(bigtime_t));
+	
+	int32 rank = (int32)((int64)(count - 1) * percent / 100);
+	std::nth_element(fSorted, fSorted + rank, fSorted + count);
+	return fSorted[rank];
+}
+
+
+bigtime_t
+FrameTrace::AverageTime(const char* name) const
+{
+	bigtime_t total = 0;
+	int32 count = 0;
+	
+	uint32 next = __atomic_load_n(&fNextEvent, __ATOMIC_ACQUIRE);
+	uint32 kept = std::min(next, fEventMask + 1);
+	for (uint32 index = next - kept; index != next; index++) {
+		event slot;
+		if (!_ReadEvent(index, &slot) || strcmp(slot.name, name) != 0)
+			continue;
+		
+		total += slot.duration;
+		count++;
+	}
+	
+	return count > 0 ? total / count : 0;
+}
+
+
+void
+FrameTrace::GetSummary(char* buffer, size_t size)
+{
+	int length = snprintf(buffer, size,
+		"%.1f fps  frame p50 %.2f  p95 %.2f  p99 %.2f ms",
+		FramesPerSecond(), FramePercentile(50) / 1000.0f,
+		FramePercentile(95) / 1000.0f, FramePercentile(99) / 1000.0f);
+	
+	// Then the average of every part of the frame, in the
+	// order they were first seen
+	const char* names[kMaxSummaryNames];
+	int32 nameCount = 0;
+	
+	uint32 next = __atomic_load_n(&fNextEvent, __ATOMIC_ACQUIRE);
+	uint32 kept = std::min(next, fEventMask + 1);
+	for (uint32 index = next - kept; index != next; index++) {
+		event slot;
+		if (!_ReadEvent(index, &slot) || strcmp(slot.name, "frame") == 0)
+			continue;
+		
+		bool known = false;
+		for (int32 i = 0; i < nameCount && !known; i++)
+			known = strcmp(names[i], slot.name) == 0;
+		if (!known && nameCount < kMaxSummaryNames)
+			names[nameCount++] = slot.name;
+	}
+	
+	for (int32 i = 0; i < nameCount; i++) {
+		if (length < 0 || (size_t)length >= size)
+			return;
+		
+		length += snprintf(buffer + length, size - length, "%s %s %.2f",
+			i == 0 ? "  |" : "", names[i], AverageTime(names[i]) / 1000.0f);
+	}
+}
+
+
+/*	Write the kept events in the Trace Event Format, as
+	complete ("X") events in microseconds, from the oldest
+	kept event on.
+*/
+status_t
+FrameTrace::DumpChromeTrace(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (file == NULL)
+		return B_ERROR;
+	
+	uint32 next = __atomic_load_n(&fNextEvent, __ATOMIC_ACQUIRE);
+	uint32 kept = std::min(next, fEventMask + 1);
+	
+	bigtime_t origin = 0;
+	for (uint32 index = next - kept; index != next; index++) {
+		event slot;
+		if (_ReadEvent(index, &slot) && (origin == 0 || slot.start < origin))
+			origin = slot.start;
+	}
+	
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	
+	bool first = true;
+	for (uint32 index = next - kept; index != next; index++) {
+		event slot;
+		if (!_ReadEvent(index, &slot))
+			continue;
+		
+		fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,"
+			"\"dur\":%lld,\"pid\":1,\"tid\":%llu}", first ? "" : ",",
+			slot.name, (long long)(slot.start - origin),
+			(long long)slot.duration, (unsigned long long)slot.thread);
+		first = false;
+	}
+	
+	fprintf(file, "\n]}\n");
+	
+	if (fclose(file) != 0)
+		return B_ERROR;
+	
+	return B_OK;
+}
+
+
+/*	Copies the event written for "index", unless it isn't written yet,
+	or a thread that adds an event took its slot over, before or while
+	it was copied. Then it returns false.
+*/
+bool
+FrameTrace::_ReadEvent(uint32 index, event* _event) const
+{
+	const event& slot = fEvents[index & fEventMask];
+	if (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != index + 1)
+		return false;
+	
+	_event->name = __atomic_load_n(&slot.name, __ATOMIC_RELAXED);
+	_event->start = __atomic_load_n(&slot.start, __ATOMIC_RELAXED);
+	_event->duration = __atomic_load_n(&slot.duration, __ATOMIC_RELAXED);
+	_event->thread = __atomic_load_n(&slot.thread, __ATOMIC_RELAXED);
+	
+	// The copy only holds if nobody started writing the slot meanwhile
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) == index + 1;
+}
+
+
+uint32
+FrameTrace::_RoundUp(int32 count)
+{
+	uint32 size = 1;
+	while ((int32)size < count)
+		size *= 2;
+	
+	return size;
+}
+
+
+uint64
+FrameTrace::_CurrentThread()
+{
+#ifdef __HAIKU__
+	return find_thread(NULL);
+#elif defined(__linux__)
+	return syscall(SYS_gettid);
+#else
+	return (uint64)(uintptr_t)pthread_self();
+#endif
+}
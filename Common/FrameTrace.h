@@ -0,0 +1,160 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FRAMETRACE_H_
+#define _FRAMETRACE_H_
+
+
+#include "PortableDefs.h"
+
+
+// The variable that turns tracing on, see
+// FrameTrace::ConfigureFromEnvironment()
+#define FRAME_TRACE_VARIABLE "SAVER_TRACE"
+
+
+/*	Times how long every frame takes, and how long the parts of it
+	take, like clearing, updating, composing and presenting. The
+	parts are timed with a TraceScope, or the TRACE_SCOPE() macro,
+	which can be used from any thread: every timed part is written
+	into a ring buffer, without a lock, so only the latest ones are
+	kept. Nothing is allocated once the trace is made.
+
+	While the trace is disabled, which it is by default, a scope
+	only checks a flag, and doesn't even read the clock. Building
+	with FRAME_TRACE_DISABLED defined leaves out the scopes entirely.
+*/
+class FrameTrace
+{
+public:
+							FrameTrace(int32 events = 4096,
+								int32 frames = 256);
+								// Room for the latest "events" timed
+								// parts and "frames" frames, both
+								// rounded up to a power of two
+							~FrameTrace();
+	
+	void					SetEnabled(bool enabled)
+								{ fEnabled = enabled; };
+	bool					IsEnabled() const { return fEnabled; };
+	void					SetOverlay(bool overlay)
+								{ fOverlay = overlay; };
+	bool					ShowsOverlay() const
+								{ return fEnabled && fOverlay; };
+								// Whether the saver should draw the
+								// GetSummary() over what it draws
+	void					SetDumpPath(const char* path);
+	const char*				DumpPath() const;
+								// Where the saver should write the trace
+								// when it quits, NULL for nowhere
+	
+	void					ConfigureFromEnvironment(
+								const char* variable
+									= FRAME_TRACE_VARIABLE);
+								// A comma separated list: "on" enables
+								// the trace, "overlay" also shows it and
+								// "json=path" writes it to "path".
+								// Anything but "off" enables it.
+	
+	void					AddEvent(const char* name, bigtime_t start,
+								bigtime_t duration);
+								// "name" has to stay around as long as
+								// the trace, like a string literal
+	
+	void					BeginFrame();
+	void					EndFrame();
+								// Around everything a frame does
+	
+	int32					CountFrames() const;
+								// The frames kept, up to the room for them
+	float					FramesPerSecond() const;
+	bigtime_t				FramePercentile(int32 percent);
+								// Over the frames kept
+	bigtime_t				AverageTime(const char* name) const;
+								// Of the kept events with that name
+	
+	void					GetSummary(char* buffer, size_t size);
+								// One line of the above, for the overlay
+	status_t				DumpChromeTrace(const char* path) const;
+								// Write every kept event as JSON, to be
+								// opened in chrome://tracing or Perfetto
+	
+private:
+	struct event {
+		const char*			name;
+		bigtime_t			start;
+		bigtime_t			duration;
+		uint64				thread;
+		uint32				sequence;
+								// One more than the index the event was
+								// written for, once it is all written
+	};
+	
+			bool			_ReadEvent(uint32 index, event* _event) const;
+	static uint32			_RoundUp(int32 count);
+	static uint64			_CurrentThread();
+	
+	event*					fEvents;
+	uint32					fEventMask;
+	uint32					fNextEvent;
+								// Taken by whoever adds an event
+	
+	bigtime_t*				fFrameStarts;
+	bigtime_t*				fFrameTimes;
+	bigtime_t*				fSorted;
+								// To find the percentiles in
+	uint32					fFrameMask;
+	uint32					fFrameCount;
+	bigtime_t				fFrameStart;
+	
+	bool					fEnabled;
+	bool					fOverlay;
+	char					fDumpPath[1024];
+};
+
+
+/*	Adds an event for the time from its creation to its
+	destruction, if the trace is enabled.
+*/
+class TraceScope
+{
+public:
+	inline					TraceScope(FrameTrace* trace,
+								const char* name);
+	inline					~TraceScope();
+	
+private:
+	FrameTrace*				fTrace;
+	const char*				fName;
+	bigtime_t				fStart;
+};
+
+
+TraceScope::TraceScope(FrameTrace* trace, const char* name)
+	:
+	fTrace(trace != NULL && trace->IsEnabled() ? trace : NULL),
+	fName(name),
+	fStart(fTrace != NULL ? system_time() : 0)
+{
+}
+
+
+TraceScope::~TraceScope()
+{
+	if (fTrace != NULL)
+		fTrace->AddEvent(fName, fStart, system_time() - fStart);
+}
+
+
+#ifdef FRAME_TRACE_DISABLED
+#	define TRACE_SCOPE(trace, name)
+#else
+#	define _TRACE_SCOPE_NAME(line)	_traceScope ## line
+#	define _TRACE_SCOPE_LINE(line)	_TRACE_SCOPE_NAME(line)
+#	define TRACE_SCOPE(trace, name) \
+		TraceScope _TRACE_SCOPE_LINE(__LINE__)(trace, name)
+#endif
+
+
+#endif
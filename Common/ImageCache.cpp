@@ -0,0 +1,331 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ImageCache.h"
+
+#include <string.h>
+
+
+struct ImageCache::entry {
+	image_key			key;
+	void*				image;
+	size_t				bytes;
+	int32				references;
+	bool				decoding;
+	bool				failed;
+	
+	entry*				next;
+							// In the same bucket
+	entry*				older;
+	entry*				newer;
+							// Only while it is released
+};
+
+
+ImageCache::ImageCache(ImageDecoder* decoder, size_t budget)
+	:
+	fDecoder(decoder),
+	fBudget(budget),
+	fBuckets(NULL),
+	fBucketCount(64),
+	fCount(0),
+	fOldest(NULL),
+	fNewest(NULL)
+{
+	fBuckets = new entry*[fBucketCount];
+	memset(fBuckets, 0, fBucketCount * sizeof(entry*));
+	
+	memset(&fStats, 0, sizeof(fStats));
+	
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fDecoded, NULL);
+}
+
+
+ImageCache::~ImageCache()
+{
+	for (int32 i = 0; i < fBucketCount; i++) {
+		entry* current = fBuckets[i];
+		while (current != NULL) {
+			entry* next = current->next;
+			if (current->image != NULL)
+				fDecoder->Free(current->image);
+			delete current;
+			current = next;
+		}
+	}
+	delete[] fBuckets;
+	
+	pthread_cond_destroy(&fDecoded);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+void*
+ImageCache::Acquire(const image_key& key)
+{
+	bigtime_t start = system_time();
+	
+	pthread_mutex_lock(&fLock);
+	
+	entry* found = _Find(key);
+	if (found != NULL && !found->decoding) {
+		// A hit, take it off the released list if it was there
+		if (found->references++ == 0)
+			_Unlink(found);
+		
+		bigtime_t time = system_time() - start;
+		fStats.hits++;
+		fStats.hitTime += time;
+		if (time > fStats.maxHitTime)
+			fStats.maxHitTime = time;
+		
+		pthread_mutex_unlock(&fLock);
+		return found->image;
+	}
+	
+	fStats.misses++;
+	
+	if (found != NULL) {
+		// Another thread is decoding it already
+		fStats.coalesced++;
+		found->references++;
+		while (found->decoding)
+			pthread_cond_wait(&fDecoded, &fLock);
+	} else {
+		found = new entry;
+		found->key = key;
+		found->image = NULL;
+		found->bytes = 0;
+		found->references = 1;
+		found->decoding = true;
+		found->failed = false;
+		found->older = NULL;
+		found->newer = NULL;
+		_Insert(found);
+		
+		// Decode without holding the lock, so other
+		// images can be gotten in the meantime
+		pthread_mutex_unlock(&fLock);
+		size_t bytes = 0;
+		void* image = fDecoder->Decode(key, &bytes);
+		pthread_mutex_lock(&fLock);
+		
+		found->decoding = false;
+		if (image != NULL) {
+			found->image = image;
+			found->bytes = bytes;
+			fStats.bytes += bytes;
+			if (fStats.bytes > fStats.maxBytes)
+				fStats.maxBytes = fStats.bytes;
+		} else {
+			// Forget it, so the next one tries again, but leave
+			// the entry to the threads that are waiting for it
+			found->failed = true;
+			fStats.failures++;
+			_Remove(found);
+		}
+		
+		pthread_cond_broadcast(&fDecoded);
+		_Evict();
+	}
+	
+	void* image = found->image;
+	if (found->failed && --found->references == 0)
+		delete found;
+	
+	bigtime_t time = system_time() - start;
+	fStats.missTime += time;
+	if (time > fStats.maxMissTime)
+		fStats.maxMissTime = time;
+	
+	pthread_mutex_unlock(&fLock);
+	return image;
+}
+
+
+void
+ImageCache::Release(const image_key& key)
+{
+	pthread_mutex_lock(&fLock);
+	
+	entry* found = _Find(key);
+	if (found != NULL && !found->decoding && found->references > 0
+		&& --found->references == 0) {
+		_Touch(found);
+		_Evict();
+	}
+	
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+ImageCache::SetBudget(size_t budget)
+{
+	pthread_mutex_lock(&fLock);
+	fBudget = budget;
+	_Evict();
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+ImageCache::GetStats(image_cache_stats* stats) const
+{
+	pthread_mutex_lock(&fLock);
+	
+	*stats = fStats;
+	stats->images = fCount;
+	stats->acquired = 0;
+	for (int32 i = 0; i < fBucketCount; i++) {
+		for (entry* current = fBuckets[i]; current != NULL;
+				current = current->next) {
+			if (current->references > 0)
+				stats->acquired++;
+		}
+	}
+	
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+ImageCache::ResetStats()
+{
+	pthread_mutex_lock(&fLock);
+	
+	size_t bytes = fStats.bytes;
+	memset(&fStats, 0, sizeof(fStats));
+	fStats.bytes = bytes;
+	fStats.maxBytes = bytes;
+	
+	pthread_mutex_unlock(&fLock);
+}
+
+
+ImageCache::entry*
+ImageCache::_Find(const image_key& key) const
+{
+	entry* current = fBuckets[_Hash(key) & (fBucketCount - 1)];
+	while (current != NULL && !(current->key == key))
+		current = current->next;
+	return current;
+}
+
+
+/*	Add the entry to its bucket, with twice as many buckets
+	once there are more entries than buckets.
+*/
+void
+ImageCache::_Insert(entry* added)
+{
+	if (fCount >= fBucketCount) {
+		int32 count = fBucketCount * 2;
+		entry** buckets = new entry*[count];
+		memset(buckets, 0, count * sizeof(entry*));
+		
+		for (int32 i = 0; i < fBucketCount; i++) {
+			entry* current = fBuckets[i];
+			while (current != NULL) {
+				entry* next = current->next;
+				entry** bucket = &buckets[_Hash(current->key) & (count - 1)];
+				current->next = *bucket;
+				*bucket = current;
+				current = next;
+			}
+		}
+		
+		delete[] fBuckets;
+		fBuckets = buckets;
+		fBucketCount = count;
+	}
+	
+	entry** bucket = &fBuckets[_Hash(added->key) & (fBucketCount - 1)];
+	added->next = *bucket;
+	*bucket = added;
+	fCount++;
+}
+
+
+/*	Take the entry out of its bucket, without deleting it.
+*/
+void
+ImageCache::_Remove(entry* removed)
+{
+	entry** link = &fBuckets[_Hash(removed->key) & (fBucketCount - 1)];
+	while (*link != removed)
+		link = &(*link)->next;
+	
+	*link = removed->next;
+	removed->next = NULL;
+	fCount--;
+}
+
+
+/*	Put a released entry at the new end of the list.
+*/
+void
+ImageCache::_Touch(entry* used)
+{
+	used->older = fNewest;
+	used->newer = NULL;
+	if (fNewest != NULL)
+		fNewest->newer = used;
+	else
+		fOldest = used;
+	fNewest = used;
+}
+
+
+void
+ImageCache::_Unlink(entry* used)
+{
+	if (used->older != NULL)
+		used->older->newer = used->newer;
+	else
+		fOldest = used->newer;
+	
+	if (used->newer != NULL)
+		used->newer->older = used->older;
+	else
+		fNewest = used->older;
+	
+	used->older = NULL;
+	used->newer = NULL;
+}
+
+
+/*	Free the released images used the longest ago until all of the
+	images fit in the budget, or none of them are released.
+*/
+void
+ImageCache::_Evict()
+{
+	while (fStats.bytes > fBudget && fOldest != NULL) {
+		entry* victim = fOldest;
+		_Unlink(victim);
+		_Remove(victim);
+		
+		fDecoder->Free(victim->image);
+		fStats.bytes -= victim->bytes;
+		fStats.evictions++;
+		delete victim;
+	}
+}
+
+
+uint32
+ImageCache::_Hash(const image_key& key)
+{
+	uint32 hash = key.source * 0x9e3779b1U;
+	hash ^= (uint32)key.width * 0x85ebca6bU + (uint32)key.height;
+	hash ^= key.colorSpace * 0xc2b2ae35U;
+	hash ^= hash >> 16;
+	hash *= 0x7feb352dU;
+	hash ^= hash >> 15;
+	return hash;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _IMAGECACHE_H_
+#define _IMAGECACHE_H_
+
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "PortableDefs.h"
+
+
+/*	What an image is decoded from and to. "source" is whatever the
+	decoder makes of it, a resource ID for example. A size of 0 by 0
+	is the size the image has, and the color space is a color_space
+	on Haiku, or whatever the decoder makes of it elsewhere.
+*/
+struct image_key {
+	uint32				source;
+	int32				width;
+	int32				height;
+	uint32				colorSpace;
+	
+	bool operator==(const image_key& other) const
+	{
+		return source == other.source && width == other.width
+			&& height == other.height && colorSpace == other.colorSpace;
+	}
+};
+
+
+/*	Decodes the images for an ImageCache. On Haiku, that can be
+	into a BBitmap, in the headless harnesses into plain memory.
+*/
+class ImageDecoder
+{
+public:
+	virtual					~ImageDecoder() {};
+	
+	virtual void*			Decode(const image_key& key, size_t* _bytes) = 0;
+								// On any thread, and on several at the
+								// same time for different keys. NULL if
+								// the image can't be decoded.
+	virtual void			Free(void* image) = 0;
+};
+
+
+struct image_cache_stats {
+	int64				hits;
+	int64				misses;
+	int64				coalesced;
+								// Misses that waited for another thread
+								// decoding the same image, instead of
+								// decoding it again
+	int64				failures;
+	int64				evictions;
+	
+	bigtime_t			hitTime;
+	bigtime_t			missTime;
+	bigtime_t			maxHitTime;
+	bigtime_t			maxMissTime;
+								// The time Acquire() took, all of them
+								// together and the longest
+	
+	size_t				bytes;
+	size_t				maxBytes;
+	int32				images;
+	int32				acquired;
+								// The images in the cache now, and
+								// those of them that are acquired
+};
+
+
+/*	Keeps decoded images around, so images that are shown again, by
+	the same or another window, don't have to be decoded again.
+
+	Images are acquired and released again by their key, as often as
+	they were acquired. While an image is acquired it stays in the
+	cache. Once it is released, it stays as long as all of the images
+	fit in the budget, after which the released image that was used
+	the longest ago is freed first. When two threads ask for the same
+	image, only one decodes it, and the other one waits for it.
+*/
+class ImageCache
+{
+public:
+							ImageCache(ImageDecoder* decoder,
+								size_t budget);
+							~ImageCache();
+								// Frees every image, acquired or not
+	
+	void*					Acquire(const image_key& key);
+								// The image, decoded now or by another
+								// thread if it isn't in the cache.
+								// NULL if it can't be decoded.
+	void					Release(const image_key& key);
+	
+	void					SetBudget(size_t budget);
+	size_t					Budget() const { return fBudget; };
+	
+	void					GetStats(image_cache_stats* stats) const;
+	void					ResetStats();
+								// Only the counters and the times
+	
+private:
+	struct entry;
+	
+	entry*					_Find(const image_key& key) const;
+	void					_Insert(entry* added);
+	void					_Remove(entry* removed);
+	void					_Touch(entry* used);
+	void					_Unlink(entry* used);
+	void					_Evict();
+	static uint32			_Hash(const image_key& key);
+	
+	ImageDecoder*			fDecoder;
+	size_t					fBudget;
+	
+	entry**					fBuckets;
+	int32					fBucketCount;
+	int32					fCount;
+	
+	entry*					fOldest;
+	entry*					fNewest;
+								// The released images, from the one
+								// used the longest ago
+	
+	image_cache_stats		fStats;
+	
+	mutable pthread_mutex_t	fLock;
+	pthread_cond_t			fDecoded;
+};
+
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "MessageCoalescer.h"
+
+#include <stdio.h>
+
+
+MessageCoalescer::MessageCoalescer(CoalescedHandler* handler,
+	bigtime_t frameInterval)
+	:
+	fHandler(handler),
+	fFrameInterval(frameInterval),
+	fLastFlush(-frameInterval),
+	fPendingCount(0),
+	fPosted(0),
+	fApplied(0),
+	fDropped(0),
+	fFlushes(0)
+{
+}
+
+
+bool
+MessageCoalescer::Post(uint32 what, void* target, int64 value)
+{
+	fPosted++;
+	
+	for (int32 i = 0; i < fPendingCount; i++) {
+		if (fPending[i].what == what && fPending[i].target == target) {
+			fPending[i].value = value;
+			fDropped++;
+			return false;
+		}
+	}
+	
+	if (fPendingCount == kMaxPending) {
+		// There are never that many different targets, but if there
+		// are, this one isn't kept from its handler
+		fHandler->ApplyUpdate(what, target, value);
+		fApplied++;
+		return false;
+	}
+	
+	update& pending = fPending[fPendingCount++];
+	pending.what = what;
+	pending.target = target;
+	pending.value = value;
+	return fPendingCount == 1;
+}
+
+
+bigtime_t
+MessageCoalescer::FlushDelay(bigtime_t now) const
+{
+	bigtime_t delay = fLastFlush + fFrameInterval - now;
+	return delay > 0 ? delay : 0;
+}
+
+
+int32
+MessageCoalescer::Flush(bigtime_t now)
+{
+	if (fPendingCount == 0 || now - fLastFlush < fFrameInterval)
+		return 0;
+	
+	fLastFlush = now;
+	fFlushes++;
+	
+	// The handler may post again, which goes into the next frame
+	update pending[kMaxPending];
+	int32 count = fPendingCount;
+	for (int32 i = 0; i < count; i++)
+		pending[i] = fPending[i];
+	fPendingCount = 0;
+	
+	for (int32 i = 0; i < count; i++)
+		fHandler->ApplyUpdate(pending[i].what, pending[i].target,
+			pending[i].value);
+	
+	fApplied += count;
+	return count;
+}
+
+
+void
+MessageCoalescer::PrintStatistics(const char* name) const
+{
+	printf("%s: %lld updates, %lld applied in %lld frames, %lld dropped\n",
+		name, (long long)fPosted, (long long)fApplied, (long long)fFlushes,
+		(long long)fDropped);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _MESSAGECOALESCER_H_
+#define _MESSAGECOALESCER_H_
+
+
+#include "PortableDefs.h"
+
+
+// About one frame of a 60 Hz screen
+const bigtime_t kCoalesceFrameInterval = 16667;
+
+
+/*	Does what the updates that a MessageCoalescer kept ask for.
+*/
+class CoalescedHandler
+{
+public:
+	virtual					~CoalescedHandler() {};
+	
+	virtual void			ApplyUpdate(uint32 what, void* target,
+								int64 value) = 0;
+};
+
+
+/*	Keeps only the latest update for every target and kind of message,
+	like the selection messages of a list that is moved through with
+	the keyboard or the modification messages of a slider that is
+	dragged, and hands them to its handler at most once a frame. An
+	update that comes while there is one for the same target and
+	message already is dropped in favor of it.
+
+	It doesn't look at the clock itself: Flush() is told the time, so
+	that a window can flush it from a message it sends itself, and a
+	benchmark with a made up time.
+*/
+class MessageCoalescer
+{
+public:
+							MessageCoalescer(CoalescedHandler* handler,
+								bigtime_t frameInterval
+									= kCoalesceFrameInterval);
+	
+	bool					Post(uint32 what, void* target, int64 value);
+								// Returns true when nothing was pending
+								// before, so that one Flush() has to be
+								// scheduled, after FlushDelay()
+	bigtime_t				FlushDelay(bigtime_t now) const;
+								// How long until the next frame, or 0
+	int32					Flush(bigtime_t now);
+								// Applies the pending updates, unless
+								// the last ones were applied less than
+								// a frame ago. Returns how many.
+	bool					HasPending() const
+								{ return fPendingCount > 0; };
+	
+	int64					CountPosted() const { return fPosted; };
+	int64					CountApplied() const { return fApplied; };
+	int64					CountDropped() const { return fDropped; };
+	int64					CountFlushes() const { return fFlushes; };
+	void					PrintStatistics(const char* name) const;
+	
+private:
+	struct update {
+		uint32				what;
+		void*				target;
+		int64				value;
+	};
+	
+	enum {
+		kMaxPending = 16
+	};
+	
+	CoalescedHandler*		fHandler;
+	bigtime_t				fFrameInterval;
+	bigtime_t				fLastFlush;
+	
+	update					fPending[kMaxPending];
+	int32					fPendingCount;
+								// In the order they first came
+	
+	int64					fPosted;
+	int64					fApplied;
+	int64					fDropped;
+	int64					fFlushes;
+};
+
+
+#endif
@@ -0,0 +1,850 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "MessageLoop.h"
+
+#include <algorithm>
+#include <new>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// How many different field names there can be, and room for them. The
+// slots are a power of two, and never more than half of them are used.
+const int32 kMaxFieldNames = 1024;
+const int32 kFieldNameSlots = 2 * kMaxFieldNames;
+const size_t kFieldNameBytes = 32768;
+
+
+// The names by key, and the keys by the hash of their name
+static const char* sFieldNames[kMaxFieldNames + 1];
+static field_key sFieldNameSlots[kFieldNameSlots];
+static char sFieldNameText[kFieldNameBytes];
+static size_t sFieldNameTextUsed;
+static int32 sFieldNameCount;
+static pthread_mutex_t sFieldNameLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*	The slot with the key of "name", or the free one it would go into.
+	A key is only put into a slot once its name is there, so that this
+	doesn't need the lock.
+*/
+static uint32
+field_name_slot(const char* name)
+{
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	for (const char* c = name; *c != '\0'; c++)
+		hash = (hash ^ (uint8)*c) * 16777619u;
+	
+	uint32 slot = hash & (kFieldNameSlots - 1);
+	while (true) {
+		field_key key = __atomic_load_n(&sFieldNameSlots[slot],
+			__ATOMIC_ACQUIRE);
+		if (key == 0 || strcmp(sFieldNames[key], name) == 0)
+			return slot;
+		slot = (slot + 1) & (kFieldNameSlots - 1);
+	}
+}
+
+
+field_key
+intern_field_name(const char* name)
+{
+	field_key key = find_field_name(name);
+	if (key != 0 || name == NULL)
+		return key;
+	
+	pthread_mutex_lock(&sFieldNameLock);
+	
+	// Another thread may have added it in the meantime
+	uint32 slot = field_name_slot(name);
+	key = sFieldNameSlots[slot];
+	size_t length = strlen(name) + 1;
+	if (key == 0 && sFieldNameCount < kMaxFieldNames
+		&& sFieldNameTextUsed + length <= kFieldNameBytes) {
+		char* copy = sFieldNameText + sFieldNameTextUsed;
+		memcpy(copy, name, length);
+		sFieldNameTextUsed += length;
+		
+		key = ++sFieldNameCount;
+		sFieldNames[key] = copy;
+		__atomic_store_n(&sFieldNameSlots[slot], key, __ATOMIC_RELEASE);
+	}
+	
+	pthread_mutex_unlock(&sFieldNameLock);
+	return key;
+}
+
+
+field_key
+find_field_name(const char* name)
+{
+	if (name == NULL)
+		return 0;
+	return __atomic_load_n(&sFieldNameSlots[field_name_slot(name)],
+		__ATOMIC_ACQUIRE);
+}
+
+
+const char*
+field_name(field_key key)
+{
+	if (key == 0 || key > kMaxFieldNames)
+		return NULL;
+	return sFieldNames[key];
+}
+
+
+const field_key kWhenField = intern_field_name("when");
+const field_key kSourceField = intern_field_name("source");
+const field_key kValueField = intern_field_name("be:value");
+
+
+//	#pragma mark - LoopMessage
+
+
+LoopMessage::LoopMessage(uint32 _what)
+	:
+	what(_what),
+	fMoreFields(NULL),
+	fFieldCount(0),
+	fMoreCapacity(0),
+	fNext(NULL),
+	fTarget(NULL),
+	fWhen(0),
+	fPool(NULL),
+	fPoolIndex(-1)
+{
+}
+
+
+LoopMessage::~LoopMessage()
+{
+	MakeEmpty();
+	free(fMoreFields);
+}
+
+
+status_t
+LoopMessage::SetTo(const LoopMessage& other)
+{
+	if (&other == this)
+		return B_OK;
+	
+	MakeEmpty();
+	what = other.what;
+	
+	for (int32 i = 0; i < other.fFieldCount; i++) {
+		const field& source = other._FieldAt(i);
+		field* added = _Add(source.key, source.type);
+		if (added == NULL)
+			return B_NO_MEMORY;
+		
+		*added = source;
+		if (source.type == kLoopStringType) {
+			added->string = strdup(source.string);
+			if (added->string == NULL) {
+				fFieldCount--;
+				return B_NO_MEMORY;
+			}
+		}
+	}
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddInt32(field_key key, int32 value)
+{
+	field* added = _Add(key, kLoopInt32Type);
+	if (added == NULL)
+		return B_NO_MEMORY;
+	added->int32Value = value;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddInt64(field_key key, int64 value)
+{
+	field* added = _Add(key, kLoopInt64Type);
+	if (added == NULL)
+		return B_NO_MEMORY;
+	added->int64Value = value;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddBool(field_key key, bool value)
+{
+	field* added = _Add(key, kLoopBoolType);
+	if (added == NULL)
+		return B_NO_MEMORY;
+	added->boolValue = value;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddFloat(field_key key, float value)
+{
+	field* added = _Add(key, kLoopFloatType);
+	if (added == NULL)
+		return B_NO_MEMORY;
+	added->floatValue = value;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddString(field_key key, const char* string)
+{
+	if (string == NULL)
+		return B_BAD_VALUE;
+	
+	char* copy = strdup(string);
+	field* added = copy != NULL ? _Add(key, kLoopStringType) : NULL;
+	if (added == NULL) {
+		free(copy);
+		return B_NO_MEMORY;
+	}
+	added->string = copy;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::AddPointer(field_key key, const void* pointer)
+{
+	field* added = _Add(key, kLoopPointerType);
+	if (added == NULL)
+		return B_NO_MEMORY;
+	added->pointer = pointer;
+	return B_OK;
+}
+
+
+status_t
+LoopMessage::FindInt32(field_key key, int32 index, int32* _value) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopInt32Type, &found);
+	if (status == B_OK)
+		*_value = found->int32Value;
+	return status;
+}
+
+
+status_t
+LoopMessage::FindInt64(field_key key, int32 index, int64* _value) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopInt64Type, &found);
+	if (status == B_OK)
+		*_value = found->int64Value;
+	return status;
+}
+
+
+status_t
+LoopMessage::FindBool(field_key key, int32 index, bool* _value) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopBoolType, &found);
+	if (status == B_OK)
+		*_value = found->boolValue;
+	return status;
+}
+
+
+status_t
+LoopMessage::FindFloat(field_key key, int32 index, float* _value) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopFloatType, &found);
+	if (status == B_OK)
+		*_value = found->floatValue;
+	return status;
+}
+
+
+status_t
+LoopMessage::FindString(field_key key, int32 index,
+	const char** _string) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopStringType, &found);
+	if (status == B_OK)
+		*_string = found->string;
+	return status;
+}
+
+
+status_t
+LoopMessage::FindPointer(field_key key, int32 index,
+	void** _pointer) const
+{
+	const field* found;
+	status_t status = _Find(key, index, kLoopPointerType, &found);
+	if (status == B_OK)
+		*_pointer = (void*)found->pointer;
+	return status;
+}
+
+
+void
+LoopMessage::MakeEmpty()
+{
+	for (int32 i = 0; i < fFieldCount; i++) {
+		field& candidate = _FieldAt(i);
+		if (candidate.type == kLoopStringType)
+			free(candidate.string);
+	}
+	fFieldCount = 0;
+}
+
+
+inline LoopMessage::field&
+LoopMessage::_FieldAt(int32 index)
+{
+	return index < kInlineFields
+		? fInlineFields[index] : fMoreFields[index - kInlineFields];
+}
+
+
+inline const LoopMessage::field&
+LoopMessage::_FieldAt(int32 index) const
+{
+	return index < kInlineFields
+		? fInlineFields[index] : fMoreFields[index - kInlineFields];
+}
+
+
+/*	Only the fields that don't fit into the message itself go into
+	fMoreFields, which grows as needed.
+*/
+LoopMessage::field*
+LoopMessage::_Add(field_key key, uint32 type)
+{
+	if (key == 0)
+		return NULL;
+	
+	if (fFieldCount - kInlineFields == fMoreCapacity) {
+		int32 capacity = fMoreCapacity > 0
+			? fMoreCapacity * 2 : kInlineFields;
+		field* fields = (field*)realloc(fMoreFields,
+			capacity * sizeof(field));
+		if (fields == NULL)
+			return NULL;
+		fMoreFields = fields;
+		fMoreCapacity = capacity;
+	}
+	
+	field& added = _FieldAt(fFieldCount++);
+	added.key = key;
+	added.type = type;
+	return &added;
+}
+
+
+/*	The values of a field are the fields with its key, in the order
+	they were added. They all have to have the same type.
+*/
+status_t
+LoopMessage::_Find(field_key key, int32 index, uint32 type,
+	const field** _field) const
+{
+	if (index < 0)
+		return B_BAD_VALUE;
+	if (key == 0)
+		return B_NAME_NOT_FOUND;
+	
+	bool named = false;
+	for (int32 i = 0; i < fFieldCount; i++) {
+		const field& candidate = _FieldAt(i);
+		if (candidate.key != key)
+			continue;
+		if (candidate.type != type)
+			return B_BAD_TYPE;
+		
+		named = true;
+		if (index-- == 0) {
+			*_field = &candidate;
+			return B_OK;
+		}
+	}
+	
+	return named ? B_BAD_INDEX : B_NAME_NOT_FOUND;
+}
+
+
+//	#pragma mark - MessagePool
+
+
+MessagePool::MessagePool(int32 count)
+	:
+	fMessages(NULL),
+	fNextFree(NULL),
+	fCount(0),
+	fFreeHead(0),
+	fMisses(0)
+{
+	if (count < 1)
+		return;
+	
+	fMessages = new(std::nothrow) LoopMessage[count];
+	fNextFree = (int32*)malloc(count * sizeof(int32));
+	if (fMessages == NULL || fNextFree == NULL)
+		return;
+	
+	fCount = count;
+	for (int32 i = 0; i < count; i++) {
+		fMessages[i].fPool = this;
+		fMessages[i].fPoolIndex = i;
+		fNextFree[i] = i + 1 < count ? i + 1 : -1;
+	}
+	fFreeHead = _Link(0, 0);
+}
+
+
+MessagePool::~MessagePool()
+{
+	delete[] fMessages;
+	free(fNextFree);
+}
+
+
+status_t
+MessagePool::InitCheck() const
+{
+	return fCount > 0 ? B_OK : B_NO_MEMORY;
+}
+
+
+LoopMessage*
+MessagePool::Acquire(uint32 what)
+{
+	uint64 head = __atomic_load_n(&fFreeHead, __ATOMIC_ACQUIRE);
+	while (true) {
+		int32 index = (int32)(uint32)head - 1;
+		if (index < 0) {
+			__atomic_fetch_add(&fMisses, 1, __ATOMIC_RELAXED);
+			return NULL;
+		}
+		
+		// If another thread took it in the meantime, the next one read
+		// here may be wrong, but then the head changed, too
+		int32 next = __atomic_load_n(&fNextFree[index], __ATOMIC_RELAXED);
+		if (__atomic_compare_exchange_n(&fFreeHead, &head, _Link(head, next),
+				true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+			LoopMessage* message = &fMessages[index];
+			message->what = what;
+			return message;
+		}
+	}
+}
+
+
+void
+MessagePool::Release(LoopMessage* message)
+{
+	message->MakeEmpty();
+	message->fTarget = NULL;
+	
+	int32 index = message->fPoolIndex;
+	uint64 head = __atomic_load_n(&fFreeHead, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(&fNextFree[index], (int32)(uint32)head - 1,
+			__ATOMIC_RELAXED);
+	} while (!__atomic_compare_exchange_n(&fFreeHead, &head,
+		_Link(head, index), true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+
+int64
+MessagePool::CountMisses() const
+{
+	return __atomic_load_n(&fMisses, __ATOMIC_RELAXED);
+}
+
+
+/*	A new head with "index" first, one change after "head".
+*/
+uint64
+MessagePool::_Link(uint64 head, int32 index)
+{
+	return (((head >> 32) + 1) << 32) | (uint32)(index + 1);
+}
+
+
+//	#pragma mark - MessageQueue
+
+
+/*	The queue always keeps one message in it that was already taken
+	out, or the stub when that one was handed out, so that pushing only
+	has to link the new message to the one pushed before.
+*/
+MessageQueue::MessageQueue()
+	:
+	fHead(&fStub),
+	fTail(&fStub)
+{
+}
+
+
+void
+MessageQueue::Push(LoopMessage* message)
+{
+	__atomic_store_n(&message->fNext, NULL, __ATOMIC_RELAXED);
+	LoopMessage* previous = __atomic_exchange_n(&fHead, message,
+		__ATOMIC_SEQ_CST);
+	
+	// Until this, the messages pushed after this one can't be reached
+	__atomic_store_n(&previous->fNext, message, __ATOMIC_RELEASE);
+}
+
+
+LoopMessage*
+MessageQueue::Pop()
+{
+	LoopMessage* tail = fTail;
+	LoopMessage* next = __atomic_load_n(&tail->fNext, __ATOMIC_ACQUIRE);
+	
+	if (tail == &fStub) {
+		if (next == NULL)
+			return NULL;
+		fTail = next;
+		tail = next;
+		next = __atomic_load_n(&next->fNext, __ATOMIC_ACQUIRE);
+	}
+	
+	if (next != NULL) {
+		fTail = next;
+		return tail;
+	}
+	
+	// The tail is the last message, unless one is being pushed after it
+	if (tail != __atomic_load_n(&fHead, __ATOMIC_SEQ_CST))
+		return NULL;
+	
+	Push(&fStub);
+	next = __atomic_load_n(&tail->fNext, __ATOMIC_ACQUIRE);
+	if (next == NULL)
+		return NULL;
+	
+	fTail = next;
+	return tail;
+}
+
+
+bool
+MessageQueue::IsEmpty() const
+{
+	LoopMessage* tail = fTail;
+	return __atomic_load_n(&tail->fNext, __ATOMIC_ACQUIRE) == NULL
+		&& tail == __atomic_load_n(&fHead, __ATOMIC_SEQ_CST);
+}
+
+
+//	#pragma mark - LoopHandler
+
+
+LoopHandler::LoopHandler()
+	:
+	fLoop(NULL),
+	fUnhandled(0)
+{
+}
+
+
+LoopHandler::~LoopHandler()
+{
+}
+
+
+void
+LoopHandler::MessageReceived(LoopMessage* /*message*/)
+{
+	fUnhandled++;
+}
+
+
+//	#pragma mark - MessageLoop
+
+
+MessageLoop::MessageLoop(int32 poolSize)
+	:
+	fPool(poolSize),
+	fRunning(false),
+	fWaiting(0),
+	fQuitMessage(kLoopQuitMessage),
+	fLatencies(NULL),
+	fLatencyCount(0),
+	fLatencyIndex(0),
+	fDispatched(0)
+{
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fPosted, NULL);
+	AddHandler(this);
+}
+
+
+MessageLoop::~MessageLoop()
+{
+	Quit();
+	
+	// Whatever was posted before it ran at all
+	while (LoopMessage* message = fQueue.Pop()) {
+		if (message->fPool != NULL)
+			message->fPool->Release(message);
+	}
+	
+	free(fLatencies);
+	pthread_cond_destroy(&fPosted);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+status_t
+MessageLoop::InitCheck() const
+{
+	return fPool.InitCheck();
+}
+
+
+void
+MessageLoop::AddHandler(LoopHandler* handler)
+{
+	handler->fLoop = this;
+}
+
+
+status_t
+MessageLoop::Run()
+{
+	if (fRunning)
+		return B_BAD_VALUE;
+	if (pthread_create(&fThread, NULL, &_Loop, this) != 0)
+		return B_NO_MEMORY;
+	
+	fRunning = true;
+	return B_OK;
+}
+
+
+void
+MessageLoop::Quit()
+{
+	if (!fRunning)
+		return;
+	
+	PostMessage(&fQuitMessage, this);
+	pthread_join(fThread, NULL);
+	fRunning = false;
+}
+
+
+LoopMessage*
+MessageLoop::NewMessage(uint32 what)
+{
+	return fPool.Acquire(what);
+}
+
+
+status_t
+MessageLoop::PostMessage(LoopMessage* message, LoopHandler* handler)
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+	
+	message->fTarget = handler != NULL ? handler : this;
+	message->fWhen = system_time();
+	fQueue.Push(message);
+	
+	// The thread only waits once it saw that the queue is empty while
+	// holding the lock, so it either sees this message, or is woken up
+	if (__atomic_load_n(&fWaiting, __ATOMIC_SEQ_CST) != 0) {
+		pthread_mutex_lock(&fLock);
+		pthread_cond_signal(&fPosted);
+		pthread_mutex_unlock(&fLock);
+	}
+	return B_OK;
+}
+
+
+status_t
+MessageLoop::PostMessage(uint32 what, LoopHandler* handler)
+{
+	LoopMessage* message = NewMessage(what);
+	if (message == NULL)
+		return B_WOULD_BLOCK;
+	return PostMessage(message, handler);
+}
+
+
+void
+MessageLoop::ReleaseMessage(LoopMessage* message)
+{
+	if (message != NULL && message->fPool != NULL)
+		message->fPool->Release(message);
+}
+
+
+status_t
+MessageLoop::KeepLatencies(int32 count)
+{
+	if (fRunning || count < 0)
+		return B_BAD_VALUE;
+	
+	bigtime_t* latencies = (bigtime_t*)realloc(fLatencies,
+		(count > 0 ? count : 1) * sizeof(bigtime_t));
+	if (latencies == NULL)
+		return B_NO_MEMORY;
+	
+	fLatencies = latencies;
+	fLatencyCount = count;
+	fLatencyIndex = 0;
+	return B_OK;
+}
+
+
+int32
+MessageLoop::CountLatencies() const
+{
+	return fLatencyIndex < fLatencyCount ? fLatencyIndex : fLatencyCount;
+}
+
+
+bigtime_t
+MessageLoop::LatencyPercentile(int32 percent)
+{
+	int32 count = CountLatencies();
+	if (count == 0)
+		return 0;
+	
+	int32 index = (int32)((int64)count * percent / 100);
+	if (index >= count)
+		index = count - 1;
+	std::nth_element(fLatencies, fLatencies + index, fLatencies + count);
+	return fLatencies[index];
+}
+
+
+void*
+MessageLoop::_Loop(void* data)
+{
+	MessageLoop* loop = (MessageLoop*)data;
+	while (true) {
+		LoopMessage* message = loop->_Next();
+		if (message == &loop->fQuitMessage)
+			break;
+		loop->_Dispatch(message);
+	}
+	return NULL;
+}
+
+
+LoopMessage*
+MessageLoop::_Next()
+{
+	while (true) {
+		LoopMessage* message = fQueue.Pop();
+		if (message != NULL)
+			return message;
+		
+		// Another thread is in the middle of pushing one
+		if (!fQueue.IsEmpty()) {
+			sched_yield();
+			continue;
+		}
+		
+		pthread_mutex_lock(&fLock);
+		__atomic_store_n(&fWaiting, 1, __ATOMIC_SEQ_CST);
+		if (fQueue.IsEmpty())
+			pthread_cond_wait(&fPosted, &fLock);
+		__atomic_store_n(&fWaiting, 0, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(&fLock);
+	}
+}
+
+
+void
+MessageLoop::_Dispatch(LoopMessage* message)
+{
+	if (fLatencyCount > 0) {
+		fLatencies[fLatencyIndex % fLatencyCount]
+			= system_time() - message->fWhen;
+		fLatencyIndex++;
+	}
+	
+	message->fTarget->MessageReceived(message);
+	fDispatched++;
+	
+	if (message->fPool != NULL)
+		message->fPool->Release(message);
+}
+
+
+//	#pragma mark - LoopInvoker
+
+
+LoopInvoker::LoopInvoker(uint32 what, LoopHandler* target)
+	:
+	fMessage(what),
+	fTarget(target)
+{
+}
+
+
+LoopInvoker::~LoopInvoker()
+{
+}
+
+
+void
+LoopInvoker::SetTarget(LoopHandler* target)
+{
+	fTarget = target;
+}
+
+
+status_t
+LoopInvoker::Invoke()
+{
+	MessageLoop* loop = fTarget != NULL ? fTarget->Loop() : NULL;
+	if (loop == NULL)
+		return B_BAD_VALUE;
+	
+	LoopMessage* message = loop->NewMessage(fMessage.what);
+	if (message == NULL)
+		return B_WOULD_BLOCK;
+	
+	status_t status = message->SetTo(fMessage);
+	if (status == B_OK)
+		status = message->AddInt64(kWhenField, system_time());
+	if (status == B_OK)
+		status = message->AddPointer(kSourceField, this);
+	if (status == B_OK)
+		status = AddFields(message);
+	if (status != B_OK) {
+		loop->ReleaseMessage(message);
+		return status;
+	}
+	
+	return loop->PostMessage(message, fTarget);
+}
+
+
+/*	Adds nothing, a control adds its value.
+*/
+status_t
+LoopInvoker::AddFields(LoopMessage* /*message*/)
+{
+	return B_OK;
+}
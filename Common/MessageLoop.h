@@ -0,0 +1,417 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _MESSAGELOOP_H_
+#define _MESSAGELOOP_H_
+
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "PortableDefs.h"
+
+
+class LoopHandler;
+class MessageLoop;
+class MessagePool;
+
+
+// The type codes of Haiku, so that the fields mean the same there
+enum {
+	kLoopInt32Type = 'LONG',
+	kLoopInt64Type = 'LLNG',
+	kLoopBoolType = 'BOOL',
+	kLoopFloatType = 'FLOT',
+	kLoopStringType = 'CSTR',
+	kLoopPointerType = 'PNTR'
+};
+
+// Like B_QUIT_REQUESTED, it makes a MessageLoop quit
+const uint32 kLoopQuitMessage = '_QRQ';
+
+
+/*	Field names are interned once: every name gets a key of its own, so
+	that a field is found by comparing keys instead of strings, and a
+	message doesn't have to copy the names of its fields. The names are
+	kept for good, in room that is set aside up front.
+*/
+// 0 is no name
+typedef uint32 field_key;
+
+// The same key every time for the same name, 0 when there is no room
+field_key intern_field_name(const char* name);
+// 0 if it wasn't interned
+field_key find_field_name(const char* name);
+const char* field_name(field_key key);
+
+// "when", "source" and "be:value", the fields a control adds to the
+// messages it sends, like a BControl
+extern const field_key kWhenField;
+extern const field_key kSourceField;
+extern const field_key kValueField;
+
+
+/*	A message with typed fields found by name, like a BMessage, of which
+	a field can have several values under the same name. Fields that
+	are found with the wrong type give B_BAD_TYPE, fields that aren't
+	there B_NAME_NOT_FOUND, and an index past their values B_BAD_INDEX.
+
+	The first few fields are kept in the message itself, so that adding
+	them allocates nothing unless they are strings. Finding a field by
+	its key is faster than by its name, which has to be looked up.
+*/
+class LoopMessage
+{
+public:
+							LoopMessage(uint32 what = 0);
+							~LoopMessage();
+	
+	uint32					what;
+	
+	status_t				SetTo(const LoopMessage& other);
+								// Copies its code and fields
+	
+	status_t				AddInt32(field_key key, int32 value);
+	status_t				AddInt64(field_key key, int64 value);
+	status_t				AddBool(field_key key, bool value);
+	status_t				AddFloat(field_key key, float value);
+	status_t				AddString(field_key key, const char* string);
+	status_t				AddPointer(field_key key, const void* pointer);
+	
+	status_t				AddInt32(const char* name, int32 value)
+								{ return AddInt32(intern_field_name(name),
+									value); };
+	status_t				AddInt64(const char* name, int64 value)
+								{ return AddInt64(intern_field_name(name),
+									value); };
+	status_t				AddBool(const char* name, bool value)
+								{ return AddBool(intern_field_name(name),
+									value); };
+	status_t				AddFloat(const char* name, float value)
+								{ return AddFloat(intern_field_name(name),
+									value); };
+	status_t				AddString(const char* name, const char* string)
+								{ return AddString(intern_field_name(name),
+									string); };
+	status_t				AddPointer(const char* name, const void* pointer)
+								{ return AddPointer(intern_field_name(name),
+									pointer); };
+	
+	status_t				FindInt32(field_key key, int32 index,
+								int32* _value) const;
+	status_t				FindInt64(field_key key, int32 index,
+								int64* _value) const;
+	status_t				FindBool(field_key key, int32 index,
+								bool* _value) const;
+	status_t				FindFloat(field_key key, int32 index,
+								float* _value) const;
+	status_t				FindString(field_key key, int32 index,
+								const char** _string) const;
+	status_t				FindPointer(field_key key, int32 index,
+								void** _pointer) const;
+	
+	status_t				FindInt32(field_key key, int32* _value) const
+								{ return FindInt32(key, 0, _value); };
+	status_t				FindInt64(field_key key, int64* _value) const
+								{ return FindInt64(key, 0, _value); };
+	status_t				FindBool(field_key key, bool* _value) const
+								{ return FindBool(key, 0, _value); };
+	status_t				FindFloat(field_key key, float* _value) const
+								{ return FindFloat(key, 0, _value); };
+	status_t				FindString(field_key key,
+								const char** _string) const
+								{ return FindString(key, 0, _string); };
+	status_t				FindPointer(field_key key,
+								void** _pointer) const
+								{ return FindPointer(key, 0, _pointer); };
+	
+	status_t				FindInt32(const char* name, int32 index,
+								int32* _value) const
+								{ return FindInt32(find_field_name(name),
+									index, _value); };
+	status_t				FindInt32(const char* name, int32* _value) const
+								{ return FindInt32(name, 0, _value); };
+	status_t				FindInt64(const char* name, int32 index,
+								int64* _value) const
+								{ return FindInt64(find_field_name(name),
+									index, _value); };
+	status_t				FindInt64(const char* name, int64* _value) const
+								{ return FindInt64(name, 0, _value); };
+	status_t				FindBool(const char* name, int32 index,
+								bool* _value) const
+								{ return FindBool(find_field_name(name),
+									index, _value); };
+	status_t				FindBool(const char* name, bool* _value) const
+								{ return FindBool(name, 0, _value); };
+	status_t				FindFloat(const char* name, int32 index,
+								float* _value) const
+								{ return FindFloat(find_field_name(name),
+									index, _value); };
+	status_t				FindFloat(const char* name, float* _value) const
+								{ return FindFloat(name, 0, _value); };
+	status_t				FindString(const char* name, int32 index,
+								const char** _string) const
+								{ return FindString(find_field_name(name),
+									index, _string); };
+	status_t				FindString(const char* name,
+								const char** _string) const
+								{ return FindString(name, 0, _string); };
+	status_t				FindPointer(const char* name, int32 index,
+								void** _pointer) const
+								{ return FindPointer(find_field_name(name),
+									index, _pointer); };
+	status_t				FindPointer(const char* name,
+								void** _pointer) const
+								{ return FindPointer(name, 0, _pointer); };
+	
+	int32					CountFields() const { return fFieldCount; };
+	void					MakeEmpty();
+	
+	LoopHandler*			Target() const { return fTarget; };
+	bigtime_t				When() const { return fWhen; };
+								// When it was posted
+	
+private:
+	friend class MessageLoop;
+	friend class MessagePool;
+	friend class MessageQueue;
+	
+	struct field {
+		field_key			key;
+		uint32				type;
+		union {
+			int32			int32Value;
+			int64			int64Value;
+			bool			boolValue;
+			float			floatValue;
+			const void*		pointer;
+			char*			string;
+		};
+	};
+	
+	// Enough for a control's message with "when", "source", "be:value"
+	// and a few fields of its own
+	enum {
+		kInlineFields = 6
+	};
+	
+							LoopMessage(const LoopMessage& other);
+			LoopMessage&	operator=(const LoopMessage& other);
+	
+	inline	field&			_FieldAt(int32 index);
+	inline	const field&	_FieldAt(int32 index) const;
+			field*			_Add(field_key key, uint32 type);
+			status_t		_Find(field_key key, int32 index, uint32 type,
+								const field** _field) const;
+	
+	field					fInlineFields[kInlineFields];
+	field*					fMoreFields;
+	int32					fFieldCount;
+	int32					fMoreCapacity;
+								// Kept when the message is made empty, so
+								// that a message from a pool grows only
+								// the first few times
+	
+	LoopMessage*			fNext;
+	LoopHandler*			fTarget;
+	bigtime_t				fWhen;
+	MessagePool*			fPool;
+	int32					fPoolIndex;
+};
+
+
+/*	A fixed number of messages made up front, that any thread can take
+	one of and give it back, without a lock.
+*/
+class MessagePool
+{
+public:
+							MessagePool(int32 count);
+							~MessagePool();
+	
+	status_t				InitCheck() const;
+	int32					CountMessages() const { return fCount; };
+	
+	LoopMessage*			Acquire(uint32 what);
+								// NULL while all of them are in use
+	void					Release(LoopMessage* message);
+								// Makes it empty
+	
+	int64					CountMisses() const;
+								// How often Acquire() found none
+	
+private:
+	static	uint64			_Link(uint64 head, int32 index);
+	
+	LoopMessage*			fMessages;
+	int32*					fNextFree;
+	int32					fCount;
+	uint64					fFreeHead;
+								// The index of the first free message plus
+								// one in the low half, and how often it
+								// changed in the high half, so that a
+								// message that was taken and given back
+								// in the meantime isn't mistaken for the
+								// one that was free
+	int64					fMisses;
+};
+
+
+/*	Any number of threads can push messages into it, and one thread
+	takes them out, in the order they were pushed, without a lock. The
+	messages are linked through themselves, so pushing one doesn't
+	allocate anything.
+*/
+class MessageQueue
+{
+public:
+							MessageQueue();
+	
+	void					Push(LoopMessage* message);
+	LoopMessage*			Pop();
+								// Only by the one thread, NULL when it is
+								// empty, or a push isn't done yet
+	bool					IsEmpty() const;
+								// Only by the one thread, false while a
+								// push isn't done yet
+	
+private:
+	LoopMessage				fStub;
+	LoopMessage*			fHead;
+								// The last one pushed
+	LoopMessage*			fTail;
+								// The next one to take out
+};
+
+
+/*	Gets the messages of its MessageLoop, like a BHandler.
+*/
+class LoopHandler
+{
+public:
+							LoopHandler();
+	virtual					~LoopHandler();
+	
+	virtual void			MessageReceived(LoopMessage* message);
+								// Counts the messages nobody handled
+	
+	MessageLoop*			Loop() const { return fLoop; };
+	int64					CountUnhandled() const { return fUnhandled; };
+	
+private:
+	friend class MessageLoop;
+	
+	MessageLoop*			fLoop;
+	int64					fUnhandled;
+};
+
+
+/*	A thread that hands the messages posted to it to their handlers one
+	after the other, like a BLooper. Any thread can post to it. The
+	messages come from a MessagePool of its own, and go back to it once
+	they were handled.
+
+	It can keep how long the latest messages waited from being posted
+	to being handed to their handler, to see how that is spread.
+*/
+class MessageLoop : public LoopHandler
+{
+public:
+							MessageLoop(int32 poolSize = 1024);
+	virtual					~MessageLoop();
+								// Quits first
+	
+	status_t				InitCheck() const;
+	
+	void					AddHandler(LoopHandler* handler);
+	status_t				Run();
+	void					Quit();
+								// Handles what was posted before, and
+								// waits for the thread to end
+	
+	LoopMessage*			NewMessage(uint32 what);
+								// From the pool, NULL while all of its
+								// messages are in use
+	status_t				PostMessage(LoopMessage* message,
+								LoopHandler* handler = NULL);
+								// Takes over a message from NewMessage(),
+								// for the loop itself if there is no
+								// handler
+	status_t				PostMessage(uint32 what,
+								LoopHandler* handler = NULL);
+								// B_WOULD_BLOCK while all messages of the
+								// pool are in use
+	void					ReleaseMessage(LoopMessage* message);
+								// Gives back a message from NewMessage()
+								// that isn't posted after all
+	
+	status_t				KeepLatencies(int32 count);
+								// Before Run()
+	int32					CountLatencies() const;
+	bigtime_t				LatencyPercentile(int32 percent);
+								// Of the latencies kept, once it quit
+	
+	int64					CountDispatched() const
+								{ return fDispatched; };
+	int64					CountPoolMisses() const
+								{ return fPool.CountMisses(); };
+	
+private:
+	static	void*			_Loop(void* data);
+			void			_Dispatch(LoopMessage* message);
+			LoopMessage*	_Next();
+	
+	MessagePool				fPool;
+	MessageQueue			fQueue;
+	
+	pthread_t				fThread;
+	bool					fRunning;
+	pthread_mutex_t			fLock;
+	pthread_cond_t			fPosted;
+	int32					fWaiting;
+								// Whether the thread waits for fPosted
+	LoopMessage				fQuitMessage;
+	
+	bigtime_t*				fLatencies;
+	int32					fLatencyCount;
+	int64					fLatencyIndex;
+	int64					fDispatched;
+};
+
+
+/*	Sends a message to its target every time it is invoked, like a
+	BInvoker. Instead of a copy of a message of its own that was made
+	with new, it sends one from the pool of the target's loop, with the
+	fields of Message() copied into it and "when" and "source" added,
+	and a control adds its value in AddFields(), like a BControl adds
+	"be:value". Unless there are strings or more fields than a message
+	keeps in itself, that allocates nothing.
+*/
+class LoopInvoker
+{
+public:
+							LoopInvoker(uint32 what = 0,
+								LoopHandler* target = NULL);
+	virtual					~LoopInvoker();
+	
+	LoopMessage*			Message() { return &fMessage; };
+	uint32					Command() const { return fMessage.what; };
+	
+	void					SetTarget(LoopHandler* target);
+	LoopHandler*			Target() const { return fTarget; };
+	
+	virtual status_t		Invoke();
+								// B_WOULD_BLOCK while all messages of the
+								// target's pool are in use
+	
+protected:
+	virtual status_t		AddFields(LoopMessage* message);
+	
+private:
+	LoopMessage				fMessage;
+	LoopHandler*			fTarget;
+};
+
+
+#endif
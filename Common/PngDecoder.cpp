@@ -0,0 +1,753 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "PngDecoder.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+static const uint8 kSignature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26,
+	'\n' };
+
+enum {
+	kGray = 0,
+	kColor = 2,
+	kIndexed = 3,
+	kGrayAlpha = 4,
+	kColorAlpha = 6
+};
+
+enum {
+	kFilterNone = 0,
+	kFilterSub,
+	kFilterUp,
+	kFilterAverage,
+	kFilterPaeth
+};
+
+static bool sVectorized = true;
+
+
+static inline uint32
+read32(const uint8* data)
+{
+	return ((uint32)data[0] << 24) | ((uint32)data[1] << 16)
+		| ((uint32)data[2] << 8) | data[3];
+}
+
+
+/*	color * alpha / 255, rounded, without dividing.
+*/
+static inline uint32
+multiply(uint32 color, uint32 alpha)
+{
+	uint32 product = color * alpha + 128;
+	return (product + (product >> 8)) >> 8;
+}
+
+
+static inline uint32
+premultiplied(uint32 red, uint32 green, uint32 blue, uint32 alpha)
+{
+	if (alpha == 255)
+		return 0xff000000 | (red << 16) | (green << 8) | blue;
+	
+	return (alpha << 24) | (multiply(red, alpha) << 16)
+		| (multiply(green, alpha) << 8) | multiply(blue, alpha);
+}
+
+
+/*	A premultiplied pixel blended over an opaque color.
+*/
+static inline uint32
+flattened(uint32 pixel, uint32 background)
+{
+	uint32 through = 255 - (pixel >> 24);
+	if (through == 0)
+		return pixel;
+	
+	return pixel + (through << 24)
+		+ (multiply((background >> 16) & 0xff, through) << 16)
+		+ (multiply((background >> 8) & 0xff, through) << 8)
+		+ multiply(background & 0xff, through);
+}
+
+
+/*	Premultiplies four byte pixels with the alpha last, swapping the
+	first and the third byte if "swap" is set. Returns the alpha of all
+	of them and'ed together, which is 255 if they are all opaque.
+*/
+static uint8
+premultiply_row(const uint8* source, uint32* dest, int32 width, bool swap)
+{
+	uint8 alphas = 255;
+	for (int32 x = 0; x < width; x++, source += 4) {
+		uint8 first = source[0];
+		uint8 third = source[2];
+		alphas &= source[3];
+		dest[x] = premultiplied(swap ? first : third, source[1],
+			swap ? third : first, source[3]);
+	}
+	
+	return alphas;
+}
+
+
+static inline uint8
+paeth(uint8 left, uint8 up, uint8 upLeft)
+{
+	int32 distanceLeft = up - upLeft;
+	int32 distanceUp = left - upLeft;
+	int32 distanceUpLeft = distanceLeft + distanceUp;
+	if (distanceLeft < 0)
+		distanceLeft = -distanceLeft;
+	if (distanceUp < 0)
+		distanceUp = -distanceUp;
+	if (distanceUpLeft < 0)
+		distanceUpLeft = -distanceUpLeft;
+	
+	if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft)
+		return left;
+	if (distanceUp <= distanceUpLeft)
+		return up;
+	return upLeft;
+}
+
+
+static void
+unfilter_row(uint8* row, const uint8* previous, int32 rowBytes,
+	int32 pixelBytes, uint8 filter)
+{
+	switch (filter) {
+		case kFilterSub:
+			for (int32 x = pixelBytes; x < rowBytes; x++)
+				row[x] += row[x - pixelBytes];
+			break;
+		
+		case kFilterUp:
+			for (int32 x = 0; x < rowBytes; x++)
+				row[x] += previous[x];
+			break;
+		
+		case kFilterAverage:
+			for (int32 x = 0; x < pixelBytes; x++)
+				row[x] += previous[x] >> 1;
+			for (int32 x = pixelBytes; x < rowBytes; x++)
+				row[x] += (row[x - pixelBytes] + previous[x]) >> 1;
+			break;
+		
+		case kFilterPaeth:
+			for (int32 x = 0; x < pixelBytes; x++)
+				row[x] += previous[x];
+			for (int32 x = pixelBytes; x < rowBytes; x++) {
+				row[x] += paeth(row[x - pixelBytes], previous[x],
+					previous[x - pixelBytes]);
+			}
+			break;
+	}
+}
+
+
+#ifdef __SSE2__
+
+
+/*	Sub, Average and Paeth depend on the pixel to the left, so those
+	are undone one pixel at a time, but all bytes of the pixel at
+	once. Pixels of three bytes are loaded into four byte lanes.
+*/
+template<int32 kBytes>
+static inline __m128i
+load_pixel(const uint8* data)
+{
+	uint32 pixel = 0;
+	memcpy(&pixel, data, kBytes);
+	return _mm_cvtsi32_si128(pixel);
+}
+
+
+template<int32 kBytes>
+static inline void
+store_pixel(uint8* data, __m128i pixel)
+{
+	uint32 value = _mm_cvtsi128_si32(pixel);
+	memcpy(data, &value, kBytes);
+}
+
+
+static inline __m128i
+absolute_sse2(__m128i value)
+{
+	return _mm_max_epi16(value, _mm_sub_epi16(_mm_setzero_si128(), value));
+}
+
+
+static inline __m128i
+select_sse2(__m128i mask, __m128i ifSet, __m128i otherwise)
+{
+	return _mm_or_si128(_mm_and_si128(mask, ifSet),
+		_mm_andnot_si128(mask, otherwise));
+}
+
+
+static void
+unfilter_up_sse2(uint8* row, const uint8* previous, int32 rowBytes)
+{
+	int32 x = 0;
+	for (; x + 16 <= rowBytes; x += 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(row + x));
+		__m128i up = _mm_loadu_si128((const __m128i*)(previous + x));
+		_mm_storeu_si128((__m128i*)(row + x), _mm_add_epi8(bytes, up));
+	}
+	for (; x < rowBytes; x++)
+		row[x] += previous[x];
+}
+
+
+template<int32 kBytes>
+static void
+unfilter_sub_sse2(uint8* row, int32 rowBytes)
+{
+	__m128i left = _mm_setzero_si128();
+	for (int32 x = 0; x < rowBytes; x += kBytes) {
+		left = _mm_add_epi8(load_pixel<kBytes>(row + x), left);
+		store_pixel<kBytes>(row + x, left);
+	}
+}
+
+
+template<int32 kBytes>
+static void
+unfilter_average_sse2(uint8* row, const uint8* previous, int32 rowBytes)
+{
+	// _mm_avg_epu8() rounds up, where the filter rounds down
+	__m128i ones = _mm_set1_epi8(1);
+	__m128i left = _mm_setzero_si128();
+	for (int32 x = 0; x < rowBytes; x += kBytes) {
+		__m128i up = load_pixel<kBytes>(previous + x);
+		__m128i average = _mm_sub_epi8(_mm_avg_epu8(left, up),
+			_mm_and_si128(_mm_xor_si128(left, up), ones));
+		left = _mm_add_epi8(load_pixel<kBytes>(row + x), average);
+		store_pixel<kBytes>(row + x, left);
+	}
+}
+
+
+template<int32 kBytes>
+static void
+unfilter_paeth_sse2(uint8* row, const uint8* previous, int32 rowBytes)
+{
+	// In 16 bits, where the distances fit
+	__m128i zero = _mm_setzero_si128();
+	__m128i left = zero;
+	__m128i upLeft = zero;
+	for (int32 x = 0; x < rowBytes; x += kBytes) {
+		__m128i up = _mm_unpacklo_epi8(load_pixel<kBytes>(previous + x),
+			zero);
+		
+		__m128i towardsLeft = _mm_sub_epi16(up, upLeft);
+		__m128i towardsUp = _mm_sub_epi16(left, upLeft);
+		__m128i distanceUpLeft = absolute_sse2(
+			_mm_add_epi16(towardsLeft, towardsUp));
+		__m128i distanceLeft = absolute_sse2(towardsLeft);
+		__m128i distanceUp = absolute_sse2(towardsUp);
+		
+		__m128i smallest = _mm_min_epi16(
+			_mm_min_epi16(distanceLeft, distanceUp), distanceUpLeft);
+		__m128i predictor = select_sse2(
+			_mm_cmpeq_epi16(distanceUp, smallest), up, upLeft);
+		predictor = select_sse2(_mm_cmpeq_epi16(distanceLeft, smallest),
+			left, predictor);
+		
+		__m128i bytes = _mm_unpacklo_epi8(load_pixel<kBytes>(row + x), zero);
+		left = _mm_and_si128(_mm_add_epi16(bytes, predictor),
+			_mm_set1_epi16(0xff));
+		store_pixel<kBytes>(row + x, _mm_packus_epi16(left, left));
+		upLeft = up;
+	}
+}
+
+
+static inline __m128i
+multiply_sse2(__m128i colors, __m128i alphas)
+{
+	__m128i products = _mm_add_epi16(_mm_mullo_epi16(colors, alphas),
+		_mm_set1_epi16(128));
+	return _mm_srli_epi16(
+		_mm_add_epi16(products, _mm_srli_epi16(products, 8)), 8);
+}
+
+
+/*	The alpha of both pixels in every lane, except for 255 in the
+	lanes of the alpha itself.
+*/
+static inline __m128i
+spread_alpha_sse2(__m128i pixels)
+{
+	__m128i alphas = _mm_shufflehi_epi16(
+		_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+		_MM_SHUFFLE(3, 3, 3, 3));
+	return _mm_or_si128(_mm_and_si128(alphas,
+			_mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+		_mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+}
+
+
+/*	premultiply_row(), four pixels at a time. Four opaque pixels in a
+	row are only swapped.
+*/
+static uint8
+premultiply_row_sse2(const uint8* source, uint32* dest, int32 width,
+	bool swap)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i allOnes = _mm_set1_epi8(-1);
+	__m128i alphaMask = _mm_set1_epi32(0xff000000);
+	__m128i greenAlpha = _mm_set1_epi32(0xff00ff00);
+	__m128i redBlue = _mm_set1_epi32(0x00ff00ff);
+	__m128i alphas = allOnes;
+	
+	int32 x = 0;
+	for (; x + 4 <= width; x += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(source + x * 4));
+		alphas = _mm_and_si128(alphas, pixels);
+		
+		if (swap) {
+			__m128i swapped = _mm_and_si128(pixels, redBlue);
+			swapped = _mm_or_si128(_mm_slli_epi32(swapped, 16),
+				_mm_srli_epi32(swapped, 16));
+			pixels = _mm_or_si128(_mm_and_si128(pixels, greenAlpha),
+				_mm_and_si128(swapped, redBlue));
+		}
+		
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+				_mm_or_si128(pixels, _mm_andnot_si128(alphaMask, allOnes)),
+				allOnes)) != 0xffff) {
+			__m128i low = _mm_unpacklo_epi8(pixels, zero);
+			__m128i high = _mm_unpackhi_epi8(pixels, zero);
+			pixels = _mm_packus_epi16(
+				multiply_sse2(low, spread_alpha_sse2(low)),
+				multiply_sse2(high, spread_alpha_sse2(high)));
+		}
+		
+		_mm_storeu_si128((__m128i*)(dest + x), pixels);
+	}
+	
+	uint8 bytes[16];
+	_mm_storeu_si128((__m128i*)bytes, alphas);
+	uint8 alpha = bytes[3] & bytes[7] & bytes[11] & bytes[15];
+	
+	return alpha & premultiply_row(source + x * 4, dest + x, width - x, swap);
+}
+
+
+static void
+flatten_row_sse2(uint32* row, int32 width, uint32 color)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i background = _mm_unpacklo_epi8(_mm_set1_epi32(color), zero);
+	__m128i full = _mm_set1_epi16(255);
+	
+	int32 x = 0;
+	for (; x + 4 <= width; x += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(row + x));
+		__m128i low = _mm_unpacklo_epi8(pixels, zero);
+		__m128i high = _mm_unpackhi_epi8(pixels, zero);
+		
+		// What shows through is what the pixel doesn't cover
+		__m128i lowCover = _mm_shufflehi_epi16(
+			_mm_shufflelo_epi16(low, _MM_SHUFFLE(3, 3, 3, 3)),
+			_MM_SHUFFLE(3, 3, 3, 3));
+		__m128i highCover = _mm_shufflehi_epi16(
+			_mm_shufflelo_epi16(high, _MM_SHUFFLE(3, 3, 3, 3)),
+			_MM_SHUFFLE(3, 3, 3, 3));
+		low = _mm_add_epi16(low,
+			multiply_sse2(background, _mm_sub_epi16(full, lowCover)));
+		high = _mm_add_epi16(high,
+			multiply_sse2(background, _mm_sub_epi16(full, highCover)));
+		
+		_mm_storeu_si128((__m128i*)(row + x), _mm_packus_epi16(low, high));
+	}
+	
+	for (; x < width; x++)
+		row[x] = flattened(row[x], color);
+}
+
+
+#endif	// __SSE2__
+
+
+PngDecoder::PngDecoder()
+	:
+	fData(NULL),
+	fSize(0),
+	fFirstData(0),
+	fWidth(0),
+	fHeight(0),
+	fColorType(0),
+	fChannels(0),
+	fOpaque(false)
+{
+	// Empty
+}
+
+
+status_t
+PngDecoder::SetTo(const void* data, size_t size)
+{
+	fData = NULL;
+	fWidth = 0;
+	fHeight = 0;
+	fOpaque = false;
+	
+	const uint8* bytes = (const uint8*)data;
+	if (size < 8 + 25 || memcmp(bytes, kSignature, 8) != 0
+		|| read32(bytes + 8) != 13 || memcmp(bytes + 12, "IHDR", 4) != 0)
+		return B_BAD_VALUE;
+	
+	uint32 width = read32(bytes + 16);
+	uint32 height = read32(bytes + 20);
+	uint8 depth = bytes[24];
+	uint8 colorType = bytes[25];
+	if (width == 0 || height == 0 || width > 0x1000000 || height > 0x1000000)
+		return B_BAD_DATA;
+	if (depth != 8 || bytes[26] != 0 || bytes[27] != 0 || bytes[28] != 0)
+		return B_BAD_TYPE;
+	
+	switch (colorType) {
+		case kGray:
+		case kIndexed:
+			fChannels = 1;
+			break;
+		case kGrayAlpha:
+			fChannels = 2;
+			break;
+		case kColor:
+			fChannels = 3;
+			break;
+		case kColorAlpha:
+			fChannels = 4;
+			break;
+		default:
+			return B_BAD_DATA;
+	}
+	
+	// Find the palette, if there is one, and the first data
+	uint8 palette[256 * 4];
+	int32 paletteCount = 0;
+	memset(palette, 255, sizeof(palette));
+	
+	size_t position = 8 + 25;
+	while (true) {
+		if (position + 12 > size)
+			return B_BAD_DATA;
+		
+		uint32 length = read32(bytes + position);
+		const uint8* type = bytes + position + 4;
+		const uint8* chunk = bytes + position + 8;
+		if (length > size - position - 12)
+			return B_BAD_DATA;
+		
+		if (memcmp(type, "IDAT", 4) == 0)
+			break;
+		if (memcmp(type, "IEND", 4) == 0)
+			return B_BAD_DATA;
+		
+		if (memcmp(type, "PLTE", 4) == 0) {
+			if (length % 3 != 0 || length > 256 * 3)
+				return B_BAD_DATA;
+			paletteCount = length / 3;
+			for (int32 i = 0; i < paletteCount; i++)
+				memcpy(palette + i * 4, chunk + i * 3, 3);
+		} else if (memcmp(type, "tRNS", 4) == 0) {
+			// A transparent color for images without alpha isn't
+			// worth the trouble here
+			if (colorType != kIndexed)
+				return B_BAD_TYPE;
+			for (uint32 i = 0; i < length && i < 256; i++)
+				palette[i * 4 + 3] = chunk[i];
+		}
+		
+		position += length + 12;
+	}
+	
+	if (colorType == kIndexed && paletteCount == 0)
+		return B_BAD_DATA;
+	
+	for (int32 i = 0; i < 256; i++) {
+		const uint8* entry = palette + i * 4;
+		fPalette[i] = i < paletteCount
+			? premultiplied(entry[0], entry[1], entry[2], entry[3]) : 0;
+	}
+	
+	fData = bytes;
+	fSize = size;
+	fFirstData = position;
+	fWidth = width;
+	fHeight = height;
+	fColorType = colorType;
+	
+	return B_OK;
+}
+
+
+status_t
+PngDecoder::Decode(uint8* bits, int32 bytesPerRow)
+{
+	if (fData == NULL)
+		return B_ERROR;
+	
+	// Two rows, each with its filter type in front
+	int32 rowBytes = fWidth * fChannels;
+	uint8* rows = new uint8[2 * (rowBytes + 1)];
+	memset(rows, 0, 2 * (rowBytes + 1));
+	uint8* previous = rows + 1;
+	uint8* current = rows + rowBytes + 2;
+	
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if (inflateInit(&stream) != Z_OK) {
+		delete[] rows;
+		return B_NO_MEMORY;
+	}
+	
+	size_t position = fFirstData;
+	uint8 alpha = 255;
+	status_t status = B_OK;
+	for (int32 y = 0; y < fHeight; y++) {
+		stream.next_out = current - 1;
+		stream.avail_out = rowBytes + 1;
+		status = _Inflate(&stream, &position);
+		if (status != B_OK)
+			break;
+		
+		if (!_Unfilter(current, previous, current[-1])) {
+			status = B_BAD_DATA;
+			break;
+		}
+		
+		alpha &= _Convert(current, (uint32*)(bits + y * bytesPerRow));
+		
+		uint8* swap = previous;
+		previous = current;
+		current = swap;
+	}
+	
+	inflateEnd(&stream);
+	delete[] rows;
+	
+	fOpaque = status == B_OK && alpha == 255;
+	return status;
+}
+
+
+void
+PngDecoder::Premultiply(uint8* bits, int32 width, int32 height,
+	int32 bytesPerRow)
+{
+	for (int32 y = 0; y < height; y++) {
+		uint8* row = bits + y * bytesPerRow;
+#ifdef __SSE2__
+		if (sVectorized) {
+			premultiply_row_sse2(row, (uint32*)row, width, false);
+			continue;
+		}
+#endif
+		premultiply_row(row, (uint32*)row, width, false);
+	}
+}
+
+
+void
+PngDecoder::Flatten(uint8* bits, int32 width, int32 height,
+	int32 bytesPerRow, uint32 background)
+{
+	background |= 0xff000000;
+	
+	for (int32 y = 0; y < height; y++) {
+		uint32* row = (uint32*)(bits + y * bytesPerRow);
+#ifdef __SSE2__
+		if (sVectorized) {
+			flatten_row_sse2(row, width, background);
+			continue;
+		}
+#endif
+		for (int32 x = 0; x < width; x++)
+			row[x] = flattened(row[x], background);
+	}
+}
+
+
+void
+PngDecoder::SetVectorized(bool vectorized)
+{
+	sVectorized = vectorized;
+}
+
+
+bool
+PngDecoder::IsVectorized()
+{
+#ifdef __SSE2__
+	return sVectorized;
+#else
+	return false;
+#endif
+}
+
+
+/*	Inflate until the output is full, going on with the next IDAT
+	chunk whenever one is used up.
+*/
+status_t
+PngDecoder::_Inflate(void* _stream, size_t* _position)
+{
+	z_stream* stream = (z_stream*)_stream;
+	
+	while (stream->avail_out > 0) {
+		if (stream->avail_in == 0) {
+			const uint8* data;
+			uint32 size;
+			if (!_NextData(_position, &data, &size))
+				return B_BAD_DATA;
+			
+			stream->next_in = (Bytef*)data;
+			stream->avail_in = size;
+			continue;
+		}
+		
+		int result = inflate(stream, Z_NO_FLUSH);
+		if (result == Z_STREAM_END)
+			return stream->avail_out == 0 ? B_OK : B_BAD_DATA;
+		if (result != Z_OK && result != Z_BUF_ERROR)
+			return B_BAD_DATA;
+	}
+	
+	return B_OK;
+}
+
+
+/*	The data of the IDAT chunk at or after the position, which is
+	moved past it. The CRCs of the chunks aren't checked, the data
+	itself has a checksum that zlib checks.
+*/
+bool
+PngDecoder::_NextData(size_t* _position, const uint8** _data,
+	uint32* _size)
+{
+	size_t position = *_position;
+	while (position + 12 <= fSize) {
+		uint32 length = read32(fData + position);
+		const uint8* type = fData + position + 4;
+		if (length > fSize - position - 12 || memcmp(type, "IEND", 4) == 0)
+			return false;
+		
+		position += length + 12;
+		if (memcmp(type, "IDAT", 4) == 0) {
+			*_position = position;
+			*_data = type + 4;
+			*_size = length;
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+
+bool
+PngDecoder::_Unfilter(uint8* row, const uint8* previous, uint8 filter)
+{
+	if (filter > kFilterPaeth)
+		return false;
+	if (filter == kFilterNone)
+		return true;
+	
+	int32 rowBytes = fWidth * fChannels;
+	
+#ifdef __SSE2__
+	if (sVectorized) {
+		if (filter == kFilterUp) {
+			unfilter_up_sse2(row, previous, rowBytes);
+			return true;
+		}
+		
+		if (fChannels == 4) {
+			if (filter == kFilterSub)
+				unfilter_sub_sse2<4>(row, rowBytes);
+			else if (filter == kFilterAverage)
+				unfilter_average_sse2<4>(row, previous, rowBytes);
+			else
+				unfilter_paeth_sse2<4>(row, previous, rowBytes);
+			return true;
+		}
+		
+		if (fChannels == 3) {
+			if (filter == kFilterSub)
+				unfilter_sub_sse2<3>(row, rowBytes);
+			else if (filter == kFilterAverage)
+				unfilter_average_sse2<3>(row, previous, rowBytes);
+			else
+				unfilter_paeth_sse2<3>(row, previous, rowBytes);
+			return true;
+		}
+	}
+#endif
+	
+	unfilter_row(row, previous, rowBytes, fChannels, filter);
+	return true;
+}
+
+
+/*	Convert a row to premultiplied B_RGBA32, and return the alpha of
+	all of its pixels and'ed together.
+*/
+uint8
+PngDecoder::_Convert(const uint8* row, uint32* dest)
+{
+	uint8 alphas = 255;
+	
+	switch (fColorType) {
+		case kColorAlpha:
+#ifdef __SSE2__
+			if (sVectorized)
+				return premultiply_row_sse2(row, dest, fWidth, true);
+#endif
+			return premultiply_row(row, dest, fWidth, true);
+		
+		case kColor:
+			for (int32 x = 0; x < fWidth; x++, row += 3) {
+				dest[x] = 0xff000000 | ((uint32)row[0] << 16)
+					| ((uint32)row[1] << 8) | row[2];
+			}
+			break;
+		
+		case kGray:
+			for (int32 x = 0; x < fWidth; x++)
+				dest[x] = 0xff000000 | row[x] * 0x010101U;
+			break;
+		
+		case kGrayAlpha:
+			for (int32 x = 0; x < fWidth; x++, row += 2) {
+				alphas &= row[1];
+				dest[x] = premultiplied(row[0], row[0], row[0], row[1]);
+			}
+			break;
+		
+		case kIndexed:
+			for (int32 x = 0; x < fWidth; x++) {
+				dest[x] = fPalette[row[x]];
+				alphas &= dest[x] >> 24;
+			}
+			break;
+	}
+	
+	return alphas;
+}
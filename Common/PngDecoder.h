@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _PNGDECODER_H_
+#define _PNGDECODER_H_
+
+
+#include "PortableDefs.h"
+
+
+/*	Decodes PNG images straight into premultiplied B_RGBA32 pixels,
+	one row at a time as they are inflated. Undoing the filters,
+	swapping red and blue and premultiplying are done with SSE2 where
+	there is SSE2, and opaque pixels are only swapped.
+
+	Only the kinds of PNG images that icons and pictures come in are
+	decoded: 8 bits per sample and not interlaced, in any color type.
+	SetTo() returns B_BAD_TYPE for any other kind, which then has to
+	be decoded some other way.
+*/
+class PngDecoder
+{
+public:
+							PngDecoder();
+	
+	status_t				SetTo(const void* data, size_t size);
+								// Reads the header. The data has to stay
+								// until the image is decoded.
+	int32					Width() const { return fWidth; };
+	int32					Height() const { return fHeight; };
+	
+	status_t				Decode(uint8* bits, int32 bytesPerRow);
+								// Into Width() by Height() pixels
+	bool					IsOpaque() const { return fOpaque; };
+								// Whether all of the decoded pixels are
+								// opaque, and can be copied instead of
+								// blended
+	
+	static void				Premultiply(uint8* bits, int32 width,
+								int32 height, int32 bytesPerRow);
+								// Of the straight B_RGBA32 pixels other
+								// decoders give
+	static void				Flatten(uint8* bits, int32 width,
+								int32 height, int32 bytesPerRow,
+								uint32 background);
+								// Blends premultiplied pixels over an
+								// 0x00rrggbb color, which makes them
+								// opaque
+	
+	static void				SetVectorized(bool vectorized);
+	static bool				IsVectorized();
+								// Whether SSE2 is used, where there is
+								// SSE2, to compare it with plain C++
+	
+private:
+	status_t				_Inflate(void* stream, size_t* _position);
+	bool					_NextData(size_t* _position,
+								const uint8** _data, uint32* _size);
+	bool					_Unfilter(uint8* row, const uint8* previous,
+								uint8 filter);
+	uint8					_Convert(const uint8* row, uint32* dest);
+	
+	const uint8*			fData;
+	size_t					fSize;
+	size_t					fFirstData;
+								// Where the first IDAT chunk starts
+	
+	int32					fWidth;
+	int32					fHeight;
+	uint8					fColorType;
+	int32					fChannels;
+	
+	uint32					fPalette[256];
+								// Premultiplied, for indexed images
+	bool					fOpaque;
+};
+
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _PORTABLEDEFS_H_
+#define _PORTABLEDEFS_H_
+
+
+/*	The code in this folder only uses the basic types from the
+	Haiku API, so it builds on other systems too, for the headless
+	harnesses and benchmarks. Elsewhere, they are defined here.
+*/
+#ifdef __HAIKU__
+#include <OS.h>
+#include <SupportDefs.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef int8_t		int8;
+typedef uint8_t		uint8;
+typedef int16_t		int16;
+typedef uint16_t	uint16;
+typedef int32_t		int32;
+typedef uint32_t	uint32;
+typedef int64_t		int64;
+typedef uint64_t	uint64;
+
+typedef int32		status_t;
+typedef int64		bigtime_t;
+
+enum {
+	B_OK = 0,
+	B_ERROR = -1,
+	B_NO_MEMORY = -2147483647 - 1,
+	B_BAD_INDEX = -2147483647 - 1 + 3,
+	B_BAD_TYPE = -2147483647 - 1 + 4,
+	B_BAD_VALUE = -2147483647 - 1 + 5,
+	B_NAME_NOT_FOUND = -2147483647 - 1 + 7,
+	B_WOULD_BLOCK = -2147483647 - 1 + 11,
+	B_NO_INIT = -2147483647 - 1 + 13,
+	B_BAD_DATA = -2147483647 - 1 + 16
+};
+
+
+/*	Microseconds since some time in the past, which never
+	goes backwards, like system_time() on Haiku.
+*/
+inline bigtime_t
+system_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (bigtime_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+#endif
+
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+
+#include "PortableDefs.h"
+
+
+/*	A tiny random number generator (xorshift32).
+	Unlike rand(), every user has its own, so the same
+	seed always gives the same numbers.
+*/
+class Random
+{
+public:
+					Random(uint32 seed = 1) { SetSeed(seed); };
+	
+	void			SetSeed(uint32 seed) { fState = seed != 0 ? seed : 1; };
+	uint32			State() const { return fState; };
+	
+	uint32			Next()
+					{
+						fState ^= fState << 13;
+						fState ^= fState >> 17;
+						fState ^= fState << 5;
+						return fState;
+					};
+	
+	int32			Range(int32 low, int32 high)
+						// A number from low to high, inclusive
+					{
+						return (int32)(Next() % (uint32)(high - low + 1))
+							+ low;
+					};
+	
+private:
+	uint32			fState;
+};
+
+
+#endif
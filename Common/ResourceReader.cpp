@@ -0,0 +1,370 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ResourceReader.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// A resource file starts with this, and then the resources
+// themselves, to which all of the offsets are relative
+static const uint8 kFileMagic[4] = { 'R', 'S', 0, 0 };
+static const size_t kResourcesOffset = 4;
+
+// The header of the resources: the magic, the number of
+// resources, where the index is and how big it is with the
+// section after it
+static const uint32 kResourcesMagic = 0x444f1000;
+static const size_t kResourcesHeaderSize = 68;
+
+// The index starts with a header, of which only the offset and
+// size of the info table are used, followed by an offset, a
+// size and a pad for every resource
+static const size_t kIndexHeaderSize = 132;
+static const size_t kInfoTableOffset = 120;
+static const size_t kIndexEntrySize = 12;
+
+// The info table has a block for every type, with the ID, the
+// index and the name of every resource of that type, and ends
+// with a checksum and a zero
+static const uint32 kSeparator = 0xffffffff;
+static const size_t kInfoTableEndSize = 8;
+
+
+struct ResourceReader::entry {
+	type_code			type;
+	int32				id;
+	const char*			name;
+	const uint8*		data;
+	size_t				size;
+};
+
+
+ResourceReader::ResourceReader()
+	:
+	fData(NULL),
+	fSize(0),
+	fMapped(false),
+	fStatus(B_ERROR),
+	fEntries(NULL),
+	fCount(0),
+	fTable(NULL),
+	fTableMask(0)
+{
+	// Empty
+}
+
+
+ResourceReader::~ResourceReader()
+{
+	Unset();
+}
+
+
+status_t
+ResourceReader::SetTo(const char* path)
+{
+	Unset();
+	
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return fStatus = B_ERROR;
+	
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+		close(fd);
+		return fStatus = B_BAD_VALUE;
+	}
+	
+	// The mapping stays after the file is closed
+	void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return fStatus = B_ERROR;
+	
+	fData = (const uint8*)data;
+	fSize = info.st_size;
+	fMapped = true;
+	
+	fStatus = _Parse();
+	if (fStatus != B_OK) {
+		status_t status = fStatus;
+		Unset();
+		fStatus = status;
+	}
+	return fStatus;
+}
+
+
+status_t
+ResourceReader::SetTo(const void* data, size_t size)
+{
+	Unset();
+	
+	fData = (const uint8*)data;
+	fSize = size;
+	
+	fStatus = _Parse();
+	if (fStatus != B_OK) {
+		status_t status = fStatus;
+		Unset();
+		fStatus = status;
+	}
+	return fStatus;
+}
+
+
+void
+ResourceReader::Unset()
+{
+	if (fMapped)
+		munmap((void*)fData, fSize);
+	
+	delete[] fEntries;
+	delete[] fTable;
+	
+	fData = NULL;
+	fSize = 0;
+	fMapped = false;
+	fStatus = B_ERROR;
+	fEntries = NULL;
+	fCount = 0;
+	fTable = NULL;
+	fTableMask = 0;
+}
+
+
+bool
+ResourceReader::GetResourceInfo(int32 index, type_code* _type, int32* _id,
+	const char** _name, size_t* _size) const
+{
+	if (index < 0 || index >= fCount)
+		return false;
+	
+	const entry& resource = fEntries[index];
+	if (_type != NULL)
+		*_type = resource.type;
+	if (_id != NULL)
+		*_id = resource.id;
+	if (_name != NULL)
+		*_name = resource.name;
+	if (_size != NULL)
+		*_size = resource.size;
+	
+	return true;
+}
+
+
+const void*
+ResourceReader::LoadResource(type_code type, int32 id, size_t* _size) const
+{
+	int32 index = _Find(type, id);
+	if (index < 0)
+		return NULL;
+	
+	if (_size != NULL)
+		*_size = fEntries[index].size;
+	return fEntries[index].data;
+}
+
+
+const void*
+ResourceReader::LoadResource(type_code type, const char* name,
+	size_t* _size) const
+{
+	for (int32 i = 0; i < fCount; i++) {
+		if (fEntries[i].type != type || strcmp(fEntries[i].name, name) != 0)
+			continue;
+		
+		if (_size != NULL)
+			*_size = fEntries[i].size;
+		return fEntries[i].data;
+	}
+	
+	return NULL;
+}
+
+
+/*	Check the headers, read the info table into the entries, in the
+	order it has them, and build the index. Every offset and size is
+	checked against the file first, so a damaged file is turned down
+	instead of read past its end.
+*/
+status_t
+ResourceReader::_Parse()
+{
+	if (fSize < kResourcesOffset + kResourcesHeaderSize
+		|| memcmp(fData, kFileMagic, sizeof(kFileMagic)) != 0
+		|| _Read32(kResourcesOffset) != kResourcesMagic)
+		return B_BAD_VALUE;
+	
+	// From here on, the offsets are relative to the resources
+	const uint8* resources = fData + kResourcesOffset;
+	size_t size = fSize - kResourcesOffset;
+	
+	uint32 count = _Read32(kResourcesOffset + 4);
+	size_t indexOffset = _Read32(kResourcesOffset + 8);
+	if (indexOffset > size || size - indexOffset < kIndexHeaderSize
+		|| count > (size - indexOffset - kIndexHeaderSize) / kIndexEntrySize)
+		return B_BAD_VALUE;
+	
+	size_t tableOffset = _Read32(kResourcesOffset + indexOffset
+		+ kInfoTableOffset);
+	size_t tableSize = _Read32(kResourcesOffset + indexOffset
+		+ kInfoTableOffset + 4);
+	if (tableOffset > size || tableSize > size - tableOffset
+		|| tableSize < kInfoTableEndSize)
+		return B_BAD_VALUE;
+	
+	size_t position = tableOffset;
+	size_t end = tableOffset + tableSize - kInfoTableEndSize;
+	
+	// The checksum adds up the table four bytes at a time,
+	// each of them read as a big endian number
+	uint32 checksum = 0;
+	for (size_t i = tableOffset; i < end; i += 4) {
+		uint32 word = 0;
+		for (size_t j = i; j < i + 4 && j < end; j++)
+			word = (word << 8) + resources[j];
+		checksum += word;
+	}
+	if (checksum != _Read32(kResourcesOffset + end)
+		|| _Read32(kResourcesOffset + end + 4) != 0)
+		return B_BAD_VALUE;
+	
+	fEntries = new entry[count > 0 ? count : 1];
+	
+	while (position < end) {
+		if (end - position < 4)
+			return B_BAD_VALUE;
+		type_code type = _Read32(kResourcesOffset + position);
+		position += 4;
+		
+		for (;;) {
+			if (end - position < 8)
+				return B_BAD_VALUE;
+			
+			uint32 id = _Read32(kResourcesOffset + position);
+			uint32 index = _Read32(kResourcesOffset + position + 4);
+			position += 8;
+			if (id == kSeparator && index == kSeparator)
+				break;
+			
+			if (end - position < 2)
+				return B_BAD_VALUE;
+			size_t nameSize = _Read16(kResourcesOffset + position);
+			position += 2;
+			
+			// The name includes its terminating zero
+			if (end - position < nameSize
+				|| (nameSize > 0 && resources[position + nameSize - 1] != 0))
+				return B_BAD_VALUE;
+			const char* name = nameSize > 0
+				? (const char*)resources + position : "";
+			position += nameSize;
+			
+			// The index counts from one
+			if (index < 1 || index > count || (uint32)fCount == count)
+				return B_BAD_VALUE;
+			
+			size_t entryOffset = indexOffset + kIndexHeaderSize
+				+ (index - 1) * kIndexEntrySize;
+			size_t dataOffset = _Read32(kResourcesOffset + entryOffset);
+			size_t dataSize = _Read32(kResourcesOffset + entryOffset + 4);
+			if (dataOffset > size || dataSize > size - dataOffset)
+				return B_BAD_VALUE;
+			
+			entry& resource = fEntries[fCount++];
+			resource.type = type;
+			resource.id = (int32)id;
+			resource.name = name;
+			resource.data = resources + dataOffset;
+			resource.size = dataSize;
+		}
+	}
+	
+	// Build the index
+	uint32 tableCount = 16;
+	while (tableCount < (uint32)fCount * 2)
+		tableCount *= 2;
+	
+	fTable = new int32[tableCount];
+	memset(fTable, 0, tableCount * sizeof(int32));
+	fTableMask = tableCount - 1;
+	
+	for (int32 i = 0; i < fCount; i++) {
+		// The first of several with the same type and ID is the one found
+		uint32 slot = _Hash(fEntries[i].type, fEntries[i].id) & fTableMask;
+		bool duplicate = false;
+		while (fTable[slot] != 0) {
+			const entry& other = fEntries[fTable[slot] - 1];
+			if (other.type == fEntries[i].type && other.id == fEntries[i].id) {
+				duplicate = true;
+				break;
+			}
+			slot = (slot + 1) & fTableMask;
+		}
+		if (!duplicate)
+			fTable[slot] = i + 1;
+	}
+	
+	return B_OK;
+}
+
+
+int32
+ResourceReader::_Find(type_code type, int32 id) const
+{
+	if (fTable == NULL)
+		return -1;
+	
+	uint32 slot = _Hash(type, id) & fTableMask;
+	while (fTable[slot] != 0) {
+		int32 index = fTable[slot] - 1;
+		if (fEntries[index].type == type && fEntries[index].id == id)
+			return index;
+		slot = (slot + 1) & fTableMask;
+	}
+	
+	return -1;
+}
+
+
+/*	Mixes the type and the ID, so resources of the same type with
+	IDs one after the other end up all over the table.
+*/
+uint32
+ResourceReader::_Hash(type_code type, int32 id)
+{
+	uint32 hash = type * 0x9e3779b1U ^ (uint32)id * 0x85ebca6bU;
+	hash ^= hash >> 16;
+	hash *= 0x7feb352dU;
+	hash ^= hash >> 15;
+	return hash;
+}
+
+
+/*	The file is little endian, whatever the machine is.
+*/
+uint32
+ResourceReader::_Read32(size_t offset) const
+{
+	const uint8* bytes = fData + offset;
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16)
+		| ((uint32)bytes[3] << 24);
+}
+
+
+uint16
+ResourceReader::_Read16(size_t offset) const
+{
+	const uint8* bytes = fData + offset;
+	return bytes[0] | (bytes[1] << 8);
+}
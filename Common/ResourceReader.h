@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _RESOURCEREADER_H_
+#define _RESOURCEREADER_H_
+
+
+#include <stddef.h>
+
+#include "PortableDefs.h"
+
+
+#ifndef __HAIKU__
+typedef uint32 type_code;
+#endif
+
+
+/*	Reads the resources of a Haiku resource file, the kind xres makes
+	and adds to an application, without the Storage Kit. The file is
+	mapped into memory, and the resources are handed out where they
+	are in the mapping, so nothing is copied. An index of the types
+	and IDs is built when the file is opened, so finding a resource
+	doesn't depend on how many there are.
+
+	Only resource files on their own are read, not the resources of
+	an application, and only the little endian kind, which is what
+	Haiku uses on x86. The resources stay valid until the reader is
+	set to another file or deleted.
+*/
+class ResourceReader
+{
+public:
+							ResourceReader();
+							~ResourceReader();
+	
+	status_t				SetTo(const char* path);
+	status_t				SetTo(const void* data, size_t size);
+								// Read the resources in memory
+								// instead, which the reader doesn't
+								// own or copy
+	void					Unset();
+	status_t				InitCheck() const { return fStatus; };
+								// B_BAD_VALUE for a file that isn't a
+								// resource file, or is damaged
+	
+	int32					CountResources() const { return fCount; };
+	bool					GetResourceInfo(int32 index, type_code* _type,
+								int32* _id, const char** _name,
+								size_t* _size) const;
+								// Like the BResources call, in the order
+								// they are in the file. The name is
+								// never NULL, but can be empty.
+	
+	bool					HasResource(type_code type, int32 id) const
+								{ return _Find(type, id) >= 0; };
+	const void*				LoadResource(type_code type, int32 id,
+								size_t* _size) const;
+	const void*				LoadResource(type_code type, const char* name,
+								size_t* _size) const;
+								// NULL if there is no such resource.
+								// Looking one up by name goes through
+								// all of them.
+	
+private:
+	struct entry;
+	
+	status_t				_Parse();
+	int32					_Find(type_code type, int32 id) const;
+	static uint32			_Hash(type_code type, int32 id);
+	uint32					_Read32(size_t offset) const;
+	uint16					_Read16(size_t offset) const;
+	
+	const uint8*			fData;
+	size_t					fSize;
+	bool					fMapped;
+	status_t				fStatus;
+	
+	entry*					fEntries;
+	int32					fCount;
+	int32*					fTable;
+								// Open addressing, a power of two at
+								// least twice as big as the count, with
+								// the index of every entry plus one
+	uint32					fTableMask;
+};
+
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "Snapshot.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static const uint32 kSnapshotMagic = 'Snap';
+
+
+struct Snapshot::header {
+	uint32			magic;
+	uint32			type;
+	uint32			version;
+	uint32			reserved;
+	uint64			size;
+	uint64			checksum;
+};
+
+
+static bool
+write_fully(int fd, const void* data, size_t size)
+{
+	const uint8* bytes = (const uint8*)data;
+	while (size > 0) {
+		ssize_t written = write(fd, bytes, size);
+		if (written <= 0)
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+
+static bool
+read_fully(int fd, void* data, size_t size)
+{
+	uint8* bytes = (uint8*)data;
+	while (size > 0) {
+		ssize_t bytesRead = read(fd, bytes, size);
+		if (bytesRead <= 0)
+			return false;
+		bytes += bytesRead;
+		size -= bytesRead;
+	}
+	return true;
+}
+
+
+Snapshot::Snapshot(uint32 type, uint32 version)
+	:
+	fType(type),
+	fVersion(version),
+	fData(NULL),
+	fSize(0),
+	fCapacity(0),
+	fPosition(0),
+	fStatus(B_OK)
+{
+	// Empty
+}
+
+
+Snapshot::~Snapshot()
+{
+	delete[] fData;
+}
+
+
+void
+Snapshot::MakeEmpty()
+{
+	fSize = 0;
+	fPosition = 0;
+	fStatus = B_OK;
+}
+
+
+void
+Snapshot::Rewind()
+{
+	fPosition = 0;
+	fStatus = B_OK;
+}
+
+
+status_t
+Snapshot::WriteData(const void* data, size_t size)
+{
+	if (fStatus != B_OK)
+		return fStatus;
+	
+	if (fSize + size > fCapacity) {
+		// Double the memory, so writing
+		// byte by byte is still fast
+		size_t capacity = fCapacity > 0 ? fCapacity * 2 : 4096;
+		while (capacity < fSize + size)
+			capacity *= 2;
+		
+		uint8* newData = new uint8[capacity];
+		if (fSize > 0)
+			memcpy(newData, fData, fSize);
+		delete[] fData;
+		fData = newData;
+		fCapacity = capacity;
+	}
+	
+	memcpy(fData + fSize, data, size);
+	fSize += size;
+	
+	return B_OK;
+}
+
+
+status_t
+Snapshot::ReadData(void* data, size_t size)
+{
+	if (fStatus != B_OK)
+		return fStatus;
+	
+	if (size > fSize - fPosition)
+		return fStatus = B_BAD_VALUE;
+	
+	memcpy(data, fData + fPosition, size);
+	fPosition += size;
+	
+	return B_OK;
+}
+
+
+status_t
+Snapshot::WriteFile(const char* path) const
+{
+	if (fStatus != B_OK)
+		return fStatus;
+	
+	header fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	fileHeader.magic = kSnapshotMagic;
+	fileHeader.type = fType;
+	fileHeader.version = fVersion;
+	fileHeader.size = fSize;
+	fileHeader.checksum = _Checksum(fData, fSize);
+	
+	char temporary[1024];
+	if (snprintf(temporary, sizeof(temporary), "%s.new", path)
+			>= (int)sizeof(temporary))
+		return B_BAD_VALUE;
+	
+	int fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return B_ERROR;
+	
+	bool ok = write_fully(fd, &fileHeader, sizeof(header))
+		&& write_fully(fd, fData, fSize);
+	
+	if (close(fd) != 0)
+		ok = false;
+	
+	if (!ok || rename(temporary, path) != 0) {
+		unlink(temporary);
+		return B_ERROR;
+	}
+	
+	return B_OK;
+}
+
+
+status_t
+Snapshot::ReadFile(const char* path)
+{
+	MakeEmpty();
+	
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return B_ERROR;
+	
+	header fileHeader;
+	struct stat info;
+	if (!read_fully(fd, &fileHeader, sizeof(header))
+		|| fstat(fd, &info) != 0
+		|| fileHeader.magic != kSnapshotMagic
+		|| fileHeader.type != fType
+		|| fileHeader.version != fVersion
+		|| fileHeader.size != (uint64)info.st_size - sizeof(header)) {
+		close(fd);
+		return B_BAD_VALUE;
+	}
+	
+	// Make room for all of it at once
+	size_t size = fileHeader.size;
+	if (size > fCapacity) {
+		uint8* newData = new uint8[size];
+		delete[] fData;
+		fData = newData;
+		fCapacity = size;
+	}
+	
+	bool ok = read_fully(fd, fData, size);
+	close(fd);
+	
+	if (!ok || _Checksum(fData, size) != fileHeader.checksum)
+		return B_BAD_VALUE;
+	
+	fSize = size;
+	return B_OK;
+}
+
+
+/*	FNV-1a, over every byte.
+*/
+uint64
+Snapshot::_Checksum(const void* data, size_t size)
+{
+	const uint8* bytes = (const uint8*)data;
+	uint64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
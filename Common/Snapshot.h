@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+
+#include <stddef.h>
+
+#include "PortableDefs.h"
+
+
+// The environment variable that asks a screensaver
+// to save a snapshot before its slowest frame
+#define SNAPSHOT_VARIABLE "SAVER_SNAPSHOT"
+
+
+/*	The state of a simulation as a compact block of binary data, to
+	save it and carry on from there later, in the same or another
+	program. The values are written one after the other and have to
+	be read back in the same order; nothing is named or tagged.
+
+	Every kind of snapshot has its own type and version, both written
+	to the file with a checksum of the data, so that reading a file
+	of another kind, from an older version, or one that was damaged
+	fails instead of giving a wrong state. The values are stored as
+	they are in memory, so a snapshot is only meant to be read on the
+	same kind of machine.
+
+	The memory is kept when the snapshot is emptied, so taking one
+	every frame only allocates the first time.
+*/
+class Snapshot
+{
+public:
+							Snapshot(uint32 type, uint32 version);
+							~Snapshot();
+	
+	void					MakeEmpty();
+								// Forget the data, but keep the memory
+	void					Rewind();
+								// Read from the start again
+	
+	status_t				WriteData(const void* data, size_t size);
+	status_t				ReadData(void* data, size_t size);
+								// Fails with B_BAD_VALUE when reading
+								// past the end
+	
+	template<typename Type>
+	status_t				Write(const Type& value)
+								{ return WriteData(&value, sizeof(value)); };
+	template<typename Type>
+	status_t				Read(Type* value)
+								{ return ReadData(value, sizeof(*value)); };
+	
+	status_t				Status() const { return fStatus; };
+								// The first error of any read or write
+								// since the snapshot was emptied, so a
+								// whole state can be read before
+								// checking it
+	
+	const void*				Data() const { return fData; };
+	size_t					Size() const { return fSize; };
+	uint32					Type() const { return fType; };
+	uint32					Version() const { return fVersion; };
+	
+	status_t				WriteFile(const char* path) const;
+								// A new file is written first and then
+								// renamed, so the old one stays whole
+								// until then
+	status_t				ReadFile(const char* path);
+								// Only a file of the same type and
+								// version, and with the right checksum
+	
+private:
+	struct header;
+	
+	static uint64			_Checksum(const void* data, size_t size);
+	
+	uint32					fType;
+	uint32					fVersion;
+	
+	uint8*					fData;
+	size_t					fSize;
+	size_t					fCapacity;
+	size_t					fPosition;
+								// Where the next read starts
+	status_t				fStatus;
+};
+
+
+#endif
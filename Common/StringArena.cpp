@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "StringArena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// The offsets are 32 bits, to keep them small with millions of strings
+static const size_t kMaxTextSize = 0xffffffffU;
+
+
+StringArena::StringArena()
+	:
+	fText(NULL),
+	fTextSize(0),
+	fTextCapacity(0),
+	fOffsets(NULL),
+	fCount(0),
+	fCapacity(0)
+{
+	// Empty
+}
+
+
+StringArena::~StringArena()
+{
+	free(fText);
+	free(fOffsets);
+}
+
+
+int32
+StringArena::Add(const char* text, int32 length)
+{
+	if (length < 0)
+		length = strlen(text);
+	
+	if ((fCount == fCapacity || fTextSize + length + 1 > fTextCapacity)
+		&& !_Grow(1, length + 1))
+		return B_NO_MEMORY;
+	
+	memcpy(fText + fTextSize, text, length);
+	fText[fTextSize + length] = '\0';
+	fTextSize += length + 1;
+	
+	fOffsets[++fCount] = fTextSize;
+	return fCount - 1;
+}
+
+
+status_t
+StringArena::Reserve(int32 strings, size_t bytes)
+{
+	return _Grow(strings, bytes) ? B_OK : B_NO_MEMORY;
+}
+
+
+void
+StringArena::MakeEmpty()
+{
+	fTextSize = 0;
+	fCount = 0;
+}
+
+
+const char*
+StringArena::StringAt(int32 index, int32* _length) const
+{
+	if (index < 0 || index >= fCount)
+		return NULL;
+	
+	if (_length != NULL)
+		*_length = fOffsets[index + 1] - fOffsets[index] - 1;
+	return fText + fOffsets[index];
+}
+
+
+size_t
+StringArena::UsedBytes() const
+{
+	return fTextSize + (fCount + 1) * sizeof(uint32);
+}
+
+
+size_t
+StringArena::AllocatedBytes() const
+{
+	return fTextCapacity + (fCapacity > 0 ? fCapacity + 1 : 0)
+		* sizeof(uint32);
+}
+
+
+/*	Make room for that many more strings and bytes, at least twice as
+	much as there is, so that adding one string after the other takes
+	a copy of all of them only now and then.
+*/
+bool
+StringArena::_Grow(int32 strings, size_t bytes)
+{
+	if (fTextSize + bytes > kMaxTextSize || strings > 0x7fffffff - fCount)
+		return false;
+	
+	if (fTextSize + bytes > fTextCapacity) {
+		size_t capacity = fTextCapacity * 2;
+		if (capacity < fTextSize + bytes)
+			capacity = fTextSize + bytes;
+		if (capacity < 256)
+			capacity = 256;
+		if (capacity > kMaxTextSize)
+			capacity = kMaxTextSize;
+		
+		char* text = (char*)realloc(fText, capacity);
+		if (text == NULL)
+			return false;
+		
+		fText = text;
+		fTextCapacity = capacity;
+	}
+	
+	if (fCount + strings > fCapacity) {
+		int32 capacity = fCapacity * 2;
+		if (capacity < fCount + strings || capacity < 0)
+			capacity = fCount + strings;
+		if (capacity < 16)
+			capacity = 16;
+		
+		uint32* offsets = (uint32*)realloc(fOffsets,
+			(capacity + 1) * sizeof(uint32));
+		if (offsets == NULL)
+			return false;
+		
+		fOffsets = offsets;
+		fOffsets[0] = 0;
+		fCapacity = capacity;
+	}
+	
+	return true;
+}
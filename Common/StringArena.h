@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _STRINGARENA_H_
+#define _STRINGARENA_H_
+
+
+#include <stddef.h>
+
+#include "PortableDefs.h"
+
+
+/*	Keeps a lot of strings one after the other in a single block of
+	memory, with where each one starts in another, instead of every
+	string in an allocation of its own. Adding a string only copies
+	it to the end, and a string is found by its index right away.
+
+	The strings stay NUL terminated, and can't be removed one by one,
+	only all of them at once. The pointers StringAt() returns become
+	invalid when another string is added.
+*/
+class StringArena
+{
+public:
+							StringArena();
+							~StringArena();
+	
+	int32					Add(const char* text, int32 length = -1);
+								// The index of the string, or B_NO_MEMORY
+	status_t				Reserve(int32 strings, size_t bytes);
+								// Room for that many more, so adding them
+								// doesn't have to grow the arena
+	void					MakeEmpty();
+	
+	int32					CountStrings() const { return fCount; };
+	const char*				StringAt(int32 index,
+								int32* _length = NULL) const;
+								// NULL if there is no such string
+	
+	size_t					UsedBytes() const;
+	size_t					AllocatedBytes() const;
+								// Of the text and of the offsets
+								// together
+	
+private:
+	bool					_Grow(int32 strings, size_t bytes);
+	
+	char*					fText;
+	size_t					fTextSize;
+	size_t					fTextCapacity;
+	
+	uint32*					fOffsets;
+								// Where every string starts, and one
+								// more for where the next one will
+	int32					fCount;
+	int32					fCapacity;
+};
+
+
+#endif
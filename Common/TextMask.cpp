@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "TextMask.h"
+
+#ifdef __HAIKU__
+#include <math.h>
+
+#include <Bitmap.h>
+#include <Font.h>
+#include <View.h>
+#endif
+
+
+/*	Multiply a color by a coverage, all of its channels.
+*/
+static inline uint32
+scale(uint32 color, uint32 coverage)
+{
+	uint32 rb = (color & 0x00ff00ff) * coverage + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+	uint32 ag = ((color >> 8) & 0x00ff00ff) * coverage + 0x00800080;
+	ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+	
+	return ag | rb;
+}
+
+
+TextMask::TextMask()
+	:
+	fBits(NULL),
+	fSpans(NULL),
+	fWidth(0),
+	fHeight(0),
+	fOriginX(0),
+	fOriginY(0)
+{
+	SetColor(0xffffffff);
+}
+
+
+TextMask::~TextMask()
+{
+	_Unset();
+}
+
+
+#ifdef __HAIKU__
+status_t
+TextMask::SetTo(const char* text, const BFont& font)
+{
+	font_height height;
+	font.GetHeight(&height);
+	
+	// A pixel to spare all around, for antialiasing
+	// that reaches over the edges
+	int32 originX = 1;
+	int32 originY = 1 + (int32)ceilf(height.ascent);
+	int32 width = (int32)ceilf(font.StringWidth(text)) + 2;
+	int32 bottom = originY + (int32)ceilf(height.descent) + 1;
+	
+	BBitmap bitmap(BRect(0, 0, width - 1, bottom - 1), B_RGB32, true);
+	if (bitmap.InitCheck() != B_OK)
+		return bitmap.InitCheck();
+	
+	BView* view = new BView(bitmap.Bounds(), "text", B_FOLLOW_NONE,
+		B_WILL_DRAW);
+	bitmap.Lock();
+	bitmap.AddChild(view);
+	
+	view->SetFont(&font);
+	view->SetLowColor(0, 0, 0);
+	view->FillRect(view->Bounds(), B_SOLID_LOW);
+	view->SetHighColor(255, 255, 255);
+	view->DrawString(text, BPoint(originX, originY));
+	view->Sync();
+	
+	status_t status = SetTo((const uint8*)bitmap.Bits(),
+		bitmap.BytesPerRow(), width, bottom, originX, originY);
+	
+	bitmap.RemoveChild(view);
+	bitmap.Unlock();
+	delete view;
+	
+	return status;
+}
+#endif
+
+
+status_t
+TextMask::SetTo(const uint8* bits, int32 bytesPerRow, int32 width,
+	int32 height, int32 originX, int32 originY)
+{
+	_Unset();
+	
+	// Only keep the rows and columns with any coverage,
+	// taken from the green channel
+	int32 left = width;
+	int32 top = height;
+	int32 right = 0;
+	int32 bottom = 0;
+	
+	for (int32 y = 0; y < height; y++) {
+		const uint8* row = bits + y * bytesPerRow;
+		for (int32 x = 0; x < width; x++) {
+			if (row[x * 4 + 1] == 0)
+				continue;
+			
+			if (x < left)
+				left = x;
+			if (x >= right)
+				right = x + 1;
+			if (y < top)
+				top = y;
+			bottom = y + 1;
+		}
+	}
+	
+	if (left >= right) {
+		// Nothing to draw
+		fOriginX = originX;
+		fOriginY = originY;
+		return B_OK;
+	}
+	
+	fWidth = right - left;
+	fHeight = bottom - top;
+	fOriginX = originX - left;
+	fOriginY = originY - top;
+	
+	fBits = new uint8[fWidth * fHeight];
+	fSpans = new int32[fHeight * 2];
+	
+	for (int32 y = 0; y < fHeight; y++) {
+		const uint8* source = bits + (top + y) * bytesPerRow + left * 4 + 1;
+		uint8* dest = fBits + y * fWidth;
+		
+		fSpans[y * 2] = fWidth;
+		fSpans[y * 2 + 1] = 0;
+		
+		for (int32 x = 0; x < fWidth; x++) {
+			dest[x] = source[x * 4];
+			if (dest[x] == 0)
+				continue;
+			
+			if (x < fSpans[y * 2])
+				fSpans[y * 2] = x;
+			fSpans[y * 2 + 1] = x + 1;
+		}
+	}
+	
+	return B_OK;
+}
+
+
+size_t
+TextMask::CoveredPixels() const
+{
+	size_t covered = 0;
+	for (int32 i = 0; i < fWidth * fHeight; i++) {
+		if (fBits[i] != 0)
+			covered++;
+	}
+	
+	return covered;
+}
+
+
+void
+TextMask::SetColor(uint32 color)
+{
+	for (uint32 coverage = 0; coverage < 256; coverage++)
+		fColors[coverage] = scale(color, coverage);
+}
+
+
+/*	Blend the color over the pixels with the coverage as the alpha,
+	only within the span of every row. Fully covered pixels, which
+	is most of them with an opaque color, are simply replaced.
+*/
+void
+TextMask::Draw(void* bits, int32 bytesPerRow, int32 width, int32 height,
+	int32 x, int32 y) const
+{
+	x -= fOriginX;
+	y -= fOriginY;
+	
+	// Clip the mask to the pixels
+	int32 top = y < 0 ? -y : 0;
+	int32 bottom = y + fHeight > height ? height - y : fHeight;
+	int32 clipLeft = x < 0 ? -x : 0;
+	int32 clipRight = x + fWidth > width ? width - x : fWidth;
+	
+	for (int32 row = top; row < bottom; row++) {
+		int32 left = fSpans[row * 2];
+		int32 right = fSpans[row * 2 + 1];
+		if (left < clipLeft)
+			left = clipLeft;
+		if (right > clipRight)
+			right = clipRight;
+		
+		const uint8* source = fBits + row * fWidth;
+		uint32* dest = (uint32*)((uint8*)bits + (y + row) * bytesPerRow) + x;
+		
+		for (int32 column = left; column < right; column++) {
+			uint32 coverage = source[column];
+			if (coverage == 0)
+				continue;
+			
+			uint32 color = fColors[coverage];
+			if ((color >> 24) == 255) {
+				dest[column] = color;
+				continue;
+			}
+			
+			// The colors are premultiplied, so this is
+			// color + dest * (1 - alpha)
+			dest[column] = color + scale(dest[column], 255 - (color >> 24));
+		}
+	}
+}
+
+
+void
+TextMask::FillRect(void* bits, int32 bytesPerRow, int32 left, int32 top,
+	int32 right, int32 bottom, uint32 color)
+{
+	for (int32 y = top; y < bottom; y++) {
+		uint32* row = (uint32*)((uint8*)bits + y * bytesPerRow);
+		for (int32 x = left; x < right; x++)
+			row[x] = color;
+	}
+}
+
+
+void
+TextMask::_Unset()
+{
+	delete[] fBits;
+	delete[] fSpans;
+	
+	fBits = NULL;
+	fSpans = NULL;
+	fWidth = 0;
+	fHeight = 0;
+}
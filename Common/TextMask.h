@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _TEXTMASK_H_
+#define _TEXTMASK_H_
+
+
+#include "PortableDefs.h"
+
+
+#ifdef __HAIKU__
+class BFont;
+#endif
+
+
+/*	A string rendered once, as the coverage of every pixel, so that
+	it can be drawn over and over again without shaping and
+	rasterizing it every time. The text is drawn by blending a color
+	over 32 bit pixels (B_RGB32 or B_RGBA32) with the coverage, and
+	erased by filling a rectangle.
+
+	Only the rows and columns with any coverage are kept, and for every
+	row the span of columns that have some, so drawing skips over the
+	empty parts.
+*/
+class TextMask
+{
+public:
+							TextMask();
+							~TextMask();
+	
+#ifdef __HAIKU__
+	status_t				SetTo(const char* text, const BFont& font);
+								// Render the text with the font
+#endif
+	status_t				SetTo(const uint8* bits, int32 bytesPerRow,
+								int32 width, int32 height, int32 originX,
+								int32 originY);
+								// Take the coverage from 32 bit white
+								// on black pixels. The text was drawn
+								// from the pen position originX, originY
+								// in them, on its baseline.
+	
+	int32					Width() const { return fWidth; };
+	int32					Height() const { return fHeight; };
+	int32					OriginX() const { return fOriginX; };
+	int32					OriginY() const { return fOriginY; };
+								// Where the pen position is, from the
+								// top left corner of the mask
+	const uint8*			Bits() const { return fBits; };
+	size_t					CoveredPixels() const;
+	
+	void					SetColor(uint32 color);
+								// The color to draw the text in, as
+								// 0xAARRGGBB, opaque white by default
+	void					Draw(void* bits, int32 bytesPerRow,
+								int32 width, int32 height, int32 x,
+								int32 y) const;
+								// Blend the text over 32 bit pixels with
+								// the pen at x, y, like DrawString()
+								// does, clipped to width by height
+	
+	static void				FillRect(void* bits, int32 bytesPerRow,
+								int32 left, int32 top, int32 right,
+								int32 bottom, uint32 color);
+								// Fill right - left by bottom - top
+								// pixels, with no clipping
+	
+private:
+	void					_Unset();
+	
+	uint8*					fBits;
+	int32*					fSpans;
+								// The first and one after the last column
+								// with any coverage, for every row
+	int32					fWidth;
+	int32					fHeight;
+	int32					fOriginX;
+	int32					fOriginY;
+	
+	uint32					fColors[256];
+								// The color premultiplied by every coverage
+};
+
+
+#endif
@@ -0,0 +1,372 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Invokes the button, menu items and slider of a window over and over
+	again, the way their BInvoker sends a copy of the message it was
+	given, and counts how often that allocates memory: with a copy made
+	with new for every invocation, with a message from the pool of the
+	window's loop that gets its fields by name, and with a LoopInvoker,
+	which should allocate nothing at all. It also times finding a field
+	by its name and by its key. It exits with 1 if a LoopInvoker
+	allocated, or a message wasn't handled.
+
+	The allocations are counted by replacing malloc() and its kin with
+	ones that count and call those of glibc, so it only builds there.
+*/
+
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MessageLoop.h"
+
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* address, size_t size);
+extern "C" void __libc_free(void* address);
+
+
+static int64 sAllocations;
+
+
+extern "C" void*
+malloc(size_t size)
+{
+	__atomic_fetch_add(&sAllocations, 1, __ATOMIC_RELAXED);
+	return __libc_malloc(size);
+}
+
+
+extern "C" void*
+calloc(size_t count, size_t size)
+{
+	__atomic_fetch_add(&sAllocations, 1, __ATOMIC_RELAXED);
+	return __libc_calloc(count, size);
+}
+
+
+extern "C" void*
+realloc(void* address, size_t size)
+{
+	__atomic_fetch_add(&sAllocations, 1, __ATOMIC_RELAXED);
+	return __libc_realloc(address, size);
+}
+
+
+extern "C" void
+free(void* address)
+{
+	__libc_free(address);
+}
+
+
+static int64
+count_allocations()
+{
+	return __atomic_load_n(&sAllocations, __ATOMIC_RELAXED);
+}
+
+
+// The messages of the ButtonPress, MenuBar and VerticalSlider windows
+enum {
+	M_BUTTON_CLICKED = 'btcl',
+	M_SET_COLOR_RED = 'sred',
+	M_SET_COLOR_GREEN = 'sgrn',
+	M_SET_COLOR_BLUE = 'sblu',
+	M_SLIDE = 'slde'
+};
+
+
+/*	Handles what its controls send, finding the fields by key or by
+	name.
+*/
+class HeadlessWindow : public LoopHandler
+{
+public:
+	HeadlessWindow()
+		:
+		fByName(false),
+		fHandled(0),
+		fValue(0),
+		fColor(0)
+	{
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_BUTTON_CLICKED:
+				break;
+			
+			case M_SET_COLOR_RED:
+			case M_SET_COLOR_GREEN:
+			case M_SET_COLOR_BLUE:
+				fColor = msg->what;
+				break;
+			
+			case M_SLIDE:
+			{
+				int32 val;
+				status_t status = fByName
+					? msg->FindInt32("be:value", &val)
+					: msg->FindInt32(kValueField, &val);
+				if (status != B_OK)
+					return;
+				fValue = val;
+				break;
+			}
+			
+			default:
+				LoopHandler::MessageReceived(msg);
+				return;
+		}
+		__atomic_fetch_add(&fHandled, 1, __ATOMIC_RELEASE);
+	}
+	
+	void SetByName(bool byName) { fByName = byName; }
+	int64 CountHandled() const
+		{ return __atomic_load_n(&fHandled, __ATOMIC_ACQUIRE); }
+	
+private:
+	bool				fByName;
+	int64				fHandled;
+	int32				fValue;
+	uint32				fColor;
+};
+
+
+/*	Sends its value with M_SLIDE, like a BSlider.
+*/
+class HeadlessSlider : public LoopInvoker
+{
+public:
+	HeadlessSlider(LoopHandler* target)
+		:
+		LoopInvoker(M_SLIDE, target),
+		fValue(0)
+	{
+	}
+	
+	void SetValue(int32 value) { fValue = value; }
+	
+protected:
+	virtual status_t AddFields(LoopMessage* message)
+	{
+		return message->AddInt32(kValueField, fValue);
+	}
+	
+private:
+	int32				fValue;
+};
+
+
+enum {
+	kCopied = 0,
+	kByName,
+	kInvoker,
+	kWayCount
+};
+
+static const char* kWayNames[kWayCount] = {
+	"copied with new",
+	"pool, by name",
+	"LoopInvoker"
+};
+
+const int32 kControlCount = 5;
+
+
+static MessageLoop* sLoop;
+static HeadlessWindow* sWindow;
+static LoopInvoker* sControls[kControlCount];
+static HeadlessSlider* sSlider;
+
+
+/*	Like BInvoker::Invoke() copies the message it was given, adds "when"
+	and "source" to the copy and sends it. Handing the copy to the window
+	in this thread leaves out the loop, which only makes it faster.
+*/
+static void
+invoke_copy(LoopInvoker* control, int32 value)
+{
+	LoopMessage* copy = new LoopMessage();
+	copy->SetTo(*control->Message());
+	copy->AddInt64("when", system_time());
+	copy->AddPointer("source", control);
+	if (control == sSlider)
+		copy->AddInt32("be:value", value);
+	sWindow->MessageReceived(copy);
+	delete copy;
+}
+
+
+/*	Takes a message from the loop's pool and adds the fields by name.
+*/
+static void
+invoke_by_name(LoopInvoker* control, int32 value)
+{
+	LoopMessage* message;
+	while ((message = sLoop->NewMessage(control->Command())) == NULL)
+		sched_yield();
+	
+	message->AddInt64("when", system_time());
+	message->AddPointer("source", control);
+	if (control == sSlider)
+		message->AddInt32("be:value", value);
+	sLoop->PostMessage(message, sWindow);
+}
+
+
+static void
+invoke_invoker(LoopInvoker* control, int32 value)
+{
+	if (control == sSlider)
+		sSlider->SetValue(value);
+	while (control->Invoke() == B_WOULD_BLOCK)
+		sched_yield();
+}
+
+
+/*	Invokes the controls one after the other, and waits until the window
+	handled it all. Returns the allocations, and the time in "_time".
+*/
+static int64
+run(int32 way, int32 count, bigtime_t* _time)
+{
+	sWindow->SetByName(way != kInvoker);
+	int64 handled = sWindow->CountHandled();
+	int64 allocations = count_allocations();
+	bigtime_t start = system_time();
+	
+	for (int32 i = 0; i < count; i++) {
+		LoopInvoker* control = sControls[i % kControlCount];
+		int32 value = i % 101;
+		if (way == kCopied)
+			invoke_copy(control, value);
+		else if (way == kByName)
+			invoke_by_name(control, value);
+		else
+			invoke_invoker(control, value);
+	}
+	
+	while (sWindow->CountHandled() < handled + count)
+		sched_yield();
+	
+	*_time = system_time() - start;
+	return count_allocations() - allocations;
+}
+
+
+/*	How many nanoseconds finding "be:value" in a message that has a few
+	other fields takes, by name or by key.
+*/
+static double
+time_find(bool byName, int32 count)
+{
+	LoopMessage message(M_SLIDE);
+	message.AddInt64(kWhenField, 0);
+	message.AddPointer(kSourceField, NULL);
+	message.AddInt32("be:orientation", 1);
+	message.AddInt32(kValueField, 42);
+	
+	volatile int32 sum = 0;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < count; i++) {
+		int32 value;
+		if (byName)
+			message.FindInt32("be:value", &value);
+		else
+			message.FindInt32(kValueField, &value);
+		sum = sum + value;
+	}
+	return (system_time() - start) * 1000.0 / count;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--invokes n] [--pool n]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 invokeCount = 1000000;
+	int32 poolSize = 256;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--invokes") == 0)
+			invokeCount = value;
+		else if (strcmp(argv[i], "--pool") == 0)
+			poolSize = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (invokeCount < 1 || poolSize < 1)
+		usage(argv[0]);
+	
+	sWindow = new HeadlessWindow();
+	sLoop = new MessageLoop(poolSize);
+	sLoop->AddHandler(sWindow);
+	if (sLoop->InitCheck() != B_OK || sLoop->Run() != B_OK) {
+		fprintf(stderr, "There isn't enough memory for the loop\n");
+		return 1;
+	}
+	
+	sControls[0] = new LoopInvoker(M_BUTTON_CLICKED, sWindow);
+	sControls[1] = new LoopInvoker(M_SET_COLOR_RED, sWindow);
+	sControls[2] = new LoopInvoker(M_SET_COLOR_GREEN, sWindow);
+	sControls[3] = new LoopInvoker(M_SET_COLOR_BLUE, sWindow);
+	sControls[4] = sSlider = new HeadlessSlider(sWindow);
+	
+	printf("Invoking %d controls %d times, pool of %d\n\n",
+		(int)kControlCount, (int)invokeCount, (int)poolSize);
+	printf("%-16s %14s %14s\n", "way", "allocations", "ns an invoke");
+	
+	int64 allocations[kWayCount];
+	for (int32 way = 0; way < kWayCount; way++) {
+		// Once to warm up, so that only what every invocation does counts
+		bigtime_t time;
+		run(way, kControlCount * 100, &time);
+		allocations[way] = run(way, invokeCount, &time);
+		
+		printf("%-16s %14.2f %14.1f\n", kWayNames[way],
+			(double)allocations[way] / invokeCount,
+			time * 1000.0 / invokeCount);
+	}
+	
+	int32 findCount = 10000000;
+	printf("\nFinding \"be:value\": %.1f ns by name, %.1f ns by key\n",
+		time_find(true, findCount), time_find(false, findCount));
+	
+	sLoop->Quit();
+	
+	bool complete = sWindow->CountUnhandled() == 0
+		&& sWindow->CountHandled()
+			== (int64)kWayCount * (invokeCount + kControlCount * 100);
+	if (!complete)
+		printf("Not every message was handled\n");
+	if (allocations[kInvoker] != 0)
+		printf("Invoking a LoopInvoker allocated memory\n");
+	
+	for (int32 i = 0; i < kControlCount; i++)
+		delete sControls[i];
+	delete sLoop;
+	delete sWindow;
+	return complete && allocations[kInvoker] == 0 ? 0 : 1;
+}
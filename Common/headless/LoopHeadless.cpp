@@ -0,0 +1,482 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Runs the message handlers of the ButtonPress, MenuBar,
+	VerticalSlider, ListItems and HaikuFortune windows, each in a
+	MessageLoop of its own like every window is a looper, and has a
+	number of threads post the messages of their buttons, menus,
+	sliders and lists to them as fast as they can. It prints how many
+	messages went through a second, and how long they waited to be
+	handled, and checks that every window got every message it was
+	sent, and exits with 1 if one didn't.
+*/
+
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MessageLoop.h"
+#include "Random.h"
+
+
+// The messages of the examples, with their codes
+enum {
+	M_BUTTON_CLICKED = 'btcl',
+	M_SET_COLOR_RED = 'sred',
+	M_SET_COLOR_GREEN = 'sgrn',
+	M_SET_COLOR_BLUE = 'sblu',
+	M_SET_COLOR_BLACK = 'sblk',
+	M_SLIDE = 'slde',
+	M_SET_TITLE = 'sttl',
+	M_GET_ANOTHER_FORTUNE = 'gafn',
+	M_ABOUT_REQUESTED = 'abrq'
+};
+
+
+/*	What the windows change, instead of the window and its views.
+*/
+class HeadlessWindow : public LoopHandler
+{
+public:
+	HeadlessWindow(const char* name)
+		:
+		fName(name),
+		fHandled(0)
+	{
+		fTitle[0] = '\0';
+	}
+	
+	const char* Name() const { return fName; }
+	int64 CountHandled() const { return fHandled; }
+	const char* Title() const { return fTitle; }
+	
+protected:
+	void SetTitle(const char* title)
+	{
+		snprintf(fTitle, sizeof(fTitle), "%s", title);
+	}
+	
+	const char*			fName;
+	int64				fHandled;
+	char				fTitle[128];
+};
+
+
+class ButtonPressWindow : public HeadlessWindow
+{
+public:
+	ButtonPressWindow()
+		:
+		HeadlessWindow("ButtonPress"),
+		fCount(0)
+	{
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_BUTTON_CLICKED:
+			{
+				fCount++;
+				char labelString[32];
+				snprintf(labelString, sizeof(labelString), "Clicks: %d",
+					(int)fCount);
+				SetTitle(labelString);
+				fHandled++;
+				break;
+			}
+			default:
+				HeadlessWindow::MessageReceived(msg);
+				break;
+		}
+	}
+	
+private:
+	int32				fCount;
+};
+
+
+class MenuBarWindow : public HeadlessWindow
+{
+public:
+	MenuBarWindow()
+		:
+		HeadlessWindow("MenuBar"),
+		fInvalidated(0)
+	{
+		_SetViewColor(0, 0, 160);
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_SET_COLOR_RED:
+				_SetViewColor(160, 0, 0);
+				break;
+			case M_SET_COLOR_GREEN:
+				_SetViewColor(0, 160, 0);
+				break;
+			case M_SET_COLOR_BLUE:
+				_SetViewColor(0, 0, 160);
+				break;
+			case M_SET_COLOR_BLACK:
+				_SetViewColor(0, 0, 0);
+				break;
+			default:
+				HeadlessWindow::MessageReceived(msg);
+				return;
+		}
+		fInvalidated++;
+		fHandled++;
+	}
+	
+private:
+	void _SetViewColor(uint8 red, uint8 green, uint8 blue)
+	{
+		fColor[0] = red;
+		fColor[1] = green;
+		fColor[2] = blue;
+	}
+	
+	uint8				fColor[3];
+	int64				fInvalidated;
+};
+
+
+class VerticalSliderWindow : public HeadlessWindow
+{
+public:
+	VerticalSliderWindow()
+		:
+		HeadlessWindow("VerticalSlider"),
+		fCount(0)
+	{
+		fLabel[0] = '\0';
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_BUTTON_CLICKED:
+			{
+				fCount++;
+				char labelString[32];
+				snprintf(labelString, sizeof(labelString), "Clicks: %d",
+					(int)fCount);
+				SetTitle(labelString);
+				fHandled++;
+				break;
+			}
+			case M_SLIDE:
+			{
+				int32 val;
+				if (msg->FindInt32("be:value", 0, &val) != B_OK)
+					break;
+				snprintf(fLabel, sizeof(fLabel), "%d", (int)val);
+				fHandled++;
+				break;
+			}
+			default:
+				HeadlessWindow::MessageReceived(msg);
+				break;
+		}
+	}
+	
+private:
+	int32				fCount;
+	char				fLabel[16];
+};
+
+
+static const char* kSports[] = {
+	"Toe Wrestling",
+	"Electric Toilet Racing",
+	"Bog Snorkeling",
+	"Chess Boxing",
+	"Cheese Rolling",
+	"Unicycle Polo"
+};
+static const int32 kSportCount = sizeof(kSports) / sizeof(kSports[0]);
+
+
+class ListItemsWindow : public HeadlessWindow
+{
+public:
+	ListItemsWindow()
+		:
+		HeadlessWindow("ListItems")
+	{
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_SET_TITLE:
+			{
+				// Like the selection message of a BListView
+				int32 selection;
+				if (msg->FindInt32("index", &selection) != B_OK)
+					break;
+				if (selection < 0 || selection >= kSportCount)
+					SetTitle("The Weird World of Sports");
+				else
+					SetTitle(kSports[selection]);
+				fHandled++;
+				break;
+			}
+			default:
+				HeadlessWindow::MessageReceived(msg);
+				break;
+		}
+	}
+};
+
+
+static const char* kFortunes[] = {
+	"You will be hungry again in one hour.",
+	"A closed mouth gathers no feet.",
+	"Today is a good day to compile."
+};
+static const int32 kFortuneCount = sizeof(kFortunes) / sizeof(kFortunes[0]);
+
+
+class HaikuFortuneWindow : public HeadlessWindow
+{
+public:
+	HaikuFortuneWindow()
+		:
+		HeadlessWindow("HaikuFortune"),
+		fNext(0),
+		fAbouts(0)
+	{
+		fText[0] = '\0';
+	}
+	
+	virtual void MessageReceived(LoopMessage* msg)
+	{
+		switch (msg->what) {
+			case M_GET_ANOTHER_FORTUNE:
+			{
+				int32 file = fNext++ % kFortuneCount;
+				char title[32];
+				snprintf(title, sizeof(title), "Fortune: file%d", (int)file);
+				SetTitle(title);
+				snprintf(fText, sizeof(fText), "%s", kFortunes[file]);
+				fHandled++;
+				break;
+			}
+			case M_ABOUT_REQUESTED:
+				fAbouts++;
+				fHandled++;
+				break;
+			default:
+				HeadlessWindow::MessageReceived(msg);
+				break;
+		}
+	}
+	
+private:
+	int32				fNext;
+	int64				fAbouts;
+	char				fText[128];
+};
+
+
+static const int32 kWindowCount = 5;
+
+struct producer {
+	pthread_t			thread;
+	int32				index;
+	int32				messages;
+	int64				sent[kWindowCount];
+	int64				retries;
+};
+
+static MessageLoop* sLoops[kWindowCount];
+static HeadlessWindow* sWindows[kWindowCount];
+static int32 sStarted;
+
+
+/*	What the controls of a window send, with the fields they add.
+*/
+static LoopMessage*
+make_message(int32 window, Random& random)
+{
+	static const uint32 kMenuCodes[] = { M_SET_COLOR_RED, M_SET_COLOR_GREEN,
+		M_SET_COLOR_BLUE, M_SET_COLOR_BLACK };
+	
+	MessageLoop* loop = sLoops[window];
+	LoopMessage* message;
+	switch (window) {
+		case 0:
+			return loop->NewMessage(M_BUTTON_CLICKED);
+		case 1:
+			return loop->NewMessage(kMenuCodes[random.Range(0, 3)]);
+		case 2:
+			if (random.Range(0, 9) == 0)
+				return loop->NewMessage(M_BUTTON_CLICKED);
+			message = loop->NewMessage(M_SLIDE);
+			if (message != NULL)
+				message->AddInt32("be:value", random.Range(0, 100));
+			return message;
+		case 3:
+			message = loop->NewMessage(M_SET_TITLE);
+			if (message != NULL)
+				message->AddInt32("index", random.Range(-1, kSportCount - 1));
+			return message;
+		default:
+			return loop->NewMessage(random.Range(0, 9) == 0
+				? M_ABOUT_REQUESTED : M_GET_ANOTHER_FORTUNE);
+	}
+}
+
+
+static void*
+produce(void* data)
+{
+	producer* self = (producer*)data;
+	Random random(100 + self->index);
+	
+	__atomic_fetch_add(&sStarted, 1, __ATOMIC_RELEASE);
+	while (__atomic_load_n(&sStarted, __ATOMIC_ACQUIRE) >= 0)
+		sched_yield();
+	
+	for (int32 i = 0; i < self->messages; i++) {
+		int32 window = random.Range(0, kWindowCount - 1);
+		LoopMessage* message;
+		while ((message = make_message(window, random)) == NULL) {
+			// All messages of the pool are waiting to be handled
+			self->retries++;
+			sched_yield();
+		}
+		
+		sLoops[window]->PostMessage(message, sWindows[window]);
+		self->sent[window]++;
+	}
+	return NULL;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--producers n] [--messages n] [--pool n]\n",
+		name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 producerCount = 4;
+	int32 messageCount = 2000000;
+	int32 poolSize = 1024;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--producers") == 0)
+			producerCount = value;
+		else if (strcmp(argv[i], "--messages") == 0)
+			messageCount = value;
+		else if (strcmp(argv[i], "--pool") == 0)
+			poolSize = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (producerCount < 1 || producerCount > 64 || messageCount < 1
+		|| poolSize < 1)
+		usage(argv[0]);
+	
+	printf("Message loops: %d windows, %d producers, %d messages, "
+		"pools of %d\n\n", (int)kWindowCount, (int)producerCount,
+		(int)messageCount, (int)poolSize);
+	
+	sWindows[0] = new ButtonPressWindow();
+	sWindows[1] = new MenuBarWindow();
+	sWindows[2] = new VerticalSliderWindow();
+	sWindows[3] = new ListItemsWindow();
+	sWindows[4] = new HaikuFortuneWindow();
+	
+	int32 latencies = messageCount < 1048576 ? messageCount : 1048576;
+	for (int32 i = 0; i < kWindowCount; i++) {
+		sLoops[i] = new MessageLoop(poolSize);
+		sLoops[i]->AddHandler(sWindows[i]);
+		if (sLoops[i]->InitCheck() != B_OK
+			|| sLoops[i]->KeepLatencies(latencies) != B_OK
+			|| sLoops[i]->Run() != B_OK) {
+			fprintf(stderr, "There isn't enough memory for the loops\n");
+			return 1;
+		}
+	}
+	
+	producer* producers = new producer[producerCount];
+	for (int32 i = 0; i < producerCount; i++) {
+		producer& made = producers[i];
+		memset(&made, 0, sizeof(made));
+		made.index = i;
+		made.messages = messageCount / producerCount
+			+ (i < messageCount % producerCount ? 1 : 0);
+		pthread_create(&made.thread, NULL, &produce, &made);
+	}
+	
+	// Start them all at once
+	while (__atomic_load_n(&sStarted, __ATOMIC_ACQUIRE) < producerCount)
+		sched_yield();
+	bigtime_t start = system_time();
+	__atomic_store_n(&sStarted, -1, __ATOMIC_RELEASE);
+	
+	for (int32 i = 0; i < producerCount; i++)
+		pthread_join(producers[i].thread, NULL);
+	for (int32 i = 0; i < kWindowCount; i++)
+		sLoops[i]->Quit();
+	bigtime_t time = system_time() - start;
+	
+	printf("%-16s %10s %10s %10s %10s %10s\n", "window", "sent", "handled",
+		"p50 us", "p99 us", "max us");
+	
+	bool complete = true;
+	int64 retries = 0;
+	for (int32 i = 0; i < producerCount; i++)
+		retries += producers[i].retries;
+	
+	for (int32 i = 0; i < kWindowCount; i++) {
+		int64 sent = 0;
+		for (int32 j = 0; j < producerCount; j++)
+			sent += producers[j].sent[i];
+		
+		MessageLoop* loop = sLoops[i];
+		printf("%-16s %10lld %10lld %10d %10d %10d\n", sWindows[i]->Name(),
+			(long long)sent, (long long)sWindows[i]->CountHandled(),
+			(int)loop->LatencyPercentile(50), (int)loop->LatencyPercentile(99),
+			(int)loop->LatencyPercentile(100));
+		
+		if (sent != sWindows[i]->CountHandled()
+			|| sWindows[i]->CountUnhandled() != 0)
+			complete = false;
+	}
+	
+	printf("\n%.1f ms, %.0f messages a second, %lld times a pool was "
+		"used up\n", time / 1000.0, messageCount * 1000000.0 / time,
+		(long long)retries);
+	if (!complete)
+		printf("Not every message was handled\n");
+	
+	for (int32 i = 0; i < kWindowCount; i++) {
+		delete sLoops[i];
+		delete sWindows[i];
+	}
+	delete[] producers;
+	return complete ? 0 : 1;
+}
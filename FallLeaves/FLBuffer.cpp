@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLBuffer.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "FLSprite.h"
+
+
+/*	Blend a premultiplied color over another one.
+*/
+static inline uint32
+blend(uint32 back, uint32 color)
+{
+	uint32 inverse = 255 - (color >> 24);
+	
+	uint32 rb = (back & 0x00ff00ff) * inverse + 0x00800080;
+	rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+	uint32 ag = ((back >> 8) & 0x00ff00ff) * inverse + 0x00800080;
+	ag = (ag + ((ag >> 8) & 0x00ff00ff)) & 0xff00ff00;
+	
+	return color + (ag | rb);
+}
+
+
+FLBuffer::FLBuffer(void* bits, int32 width, int32 height, int32 bytesPerRow)
+	:
+	fBits((uint8*)bits),
+	fWidth(width),
+	fHeight(height),
+	fBytesPerRow(bytesPerRow),
+	fClipTop(0),
+	fClipBottom(height)
+{
+	// Empty
+}
+
+
+void
+FLBuffer::Clear(uint32 color)
+{
+	ClearRows(0, fHeight, color);
+}
+
+
+void
+FLBuffer::ClearRows(int32 top, int32 bottom, uint32 color, bool stream)
+{
+#ifdef __SSE2__
+	if (stream) {
+		__m128i pixels = _mm_set1_epi32(color);
+		
+		for (int32 y = top; y < bottom; y++) {
+			uint32* row = (uint32*)(fBits + y * fBytesPerRow);
+			int32 x = 0;
+			
+			// Streaming stores write 16 aligned bytes at a time
+			for (; x < fWidth && ((uintptr_t)(row + x) & 15) != 0; x++)
+				row[x] = color;
+			for (; x + 4 <= fWidth; x += 4)
+				_mm_stream_si128((__m128i*)(row + x), pixels);
+			for (; x < fWidth; x++)
+				row[x] = color;
+		}
+		
+		// Make sure the streamed pixels are all out
+		// before anything else touches the buffer
+		_mm_sfence();
+		return;
+	}
+#endif
+	
+	for (int32 y = top; y < bottom; y++) {
+		uint32* row = (uint32*)(fBits + y * fBytesPerRow);
+		for (int32 x = 0; x < fWidth; x++)
+			row[x] = color;
+	}
+}
+
+
+void
+FLBuffer::SetClip(int32 top, int32 bottom)
+{
+	fClipTop = top < 0 ? 0 : top;
+	fClipBottom = bottom > fHeight ? fHeight : bottom;
+}
+
+
+void
+FLBuffer::DrawSprite(const FLSprite* sprite, int32 x, int32 y)
+{
+	// Clip the sprite to the buffer
+	int32 left = x < 0 ? -x : 0;
+	int32 top = y < fClipTop ? fClipTop - y : 0;
+	int32 right = sprite->Width();
+	int32 bottom = sprite->Height();
+	
+	if (x + right > fWidth)
+		right = fWidth - x;
+	if (y + bottom > fClipBottom)
+		bottom = fClipBottom - y;
+	
+	if (left >= right || top >= bottom)
+		return;
+	
+	for (int32 row = top; row < bottom; row++) {
+		const uint32* source = sprite->Bits() + row * sprite->Width();
+		uint32* dest = (uint32*)(fBits + (y + row) * fBytesPerRow) + x;
+		
+		for (int32 column = left; column < right; column++) {
+			uint32 color = source[column];
+			uint32 alpha = color >> 24;
+			
+			if (alpha == 0)
+				continue;
+			
+			if (alpha == 255) {
+				dest[column] = color;
+				continue;
+			}
+			
+			// The sprite is premultiplied, so this is
+			// source + dest * (1 - alpha)
+			dest[column] = blend(dest[column], color);
+		}
+	}
+}
+
+
+void
+FLBuffer::DrawSprite(const FLSprite* sprite, int32 x, int32 y, int32 size,
+	bool smooth)
+{
+	if (sprite->Width() == size && sprite->Height() == size) {
+		DrawSprite(sprite, x, y);
+		return;
+	}
+	
+	// Clip the destination square to the buffer
+	int32 left = x < 0 ? -x : 0;
+	int32 top = y < fClipTop ? fClipTop - y : 0;
+	int32 right = x + size > fWidth ? fWidth - x : size;
+	int32 bottom = y + size > fClipBottom ? fClipBottom - y : size;
+	
+	if (left >= right || top >= bottom)
+		return;
+	
+	if (!smooth) {
+		_DrawSpriteNearest(sprite, x, y, size, left, top, right, bottom);
+		return;
+	}
+	
+	const uint32* bits = sprite->Bits();
+	int32 width = sprite->Width();
+	int32 lastX = width - 1;
+	int32 lastY = sprite->Height() - 1;
+	
+	// Walk the sprite in 16.16 fixed point, sampling
+	// at the centers of the destination pixels
+	int32 step = (width << 16) / size;
+	int32 start = step / 2 - 0x8000;
+	
+	for (int32 row = top; row < bottom; row++) {
+		int32 v = start + row * step;
+		if (v < 0)
+			v = 0;
+		int32 y0 = v >> 16;
+		int32 y1 = y0 < lastY ? y0 + 1 : y0;
+		uint32 fy = (v >> 8) & 0xff;
+		
+		const uint32* line0 = bits + y0 * width;
+		const uint32* line1 = bits + y1 * width;
+		uint32* dest = (uint32*)(fBits + (y + row) * fBytesPerRow) + x;
+		
+		int32 u = start + left * step;
+		for (int32 column = left; column < right; column++, u += step) {
+			int32 clamped = u < 0 ? 0 : u;
+			int32 x0 = clamped >> 16;
+			int32 x1 = x0 < lastX ? x0 + 1 : x0;
+			uint32 fx = (clamped >> 8) & 0xff;
+			
+			uint32 a = line0[x0];
+			uint32 b = line0[x1];
+			uint32 c = line1[x0];
+			uint32 d = line1[x1];
+			
+			if ((a | b | c | d) == 0)
+				continue;
+			
+			// The four weights add up to 256
+			uint32 wd = (fx * fy + 128) >> 8;
+			uint32 wb = fx - wd;
+			uint32 wc = fy - wd;
+			uint32 wa = 256 - fx - fy + wd;
+			
+			uint32 rb = (a & 0x00ff00ff) * wa + (b & 0x00ff00ff) * wb
+				+ (c & 0x00ff00ff) * wc + (d & 0x00ff00ff) * wd;
+			uint32 ag = ((a >> 8) & 0x00ff00ff) * wa
+				+ ((b >> 8) & 0x00ff00ff) * wb
+				+ ((c >> 8) & 0x00ff00ff) * wc
+				+ ((d >> 8) & 0x00ff00ff) * wd;
+			uint32 color = ((rb >> 8) & 0x00ff00ff) | (ag & 0xff00ff00);
+			
+			if ((color >> 24) == 255)
+				dest[column] = color;
+			else
+				dest[column] = blend(dest[column], color);
+		}
+	}
+}
+
+
+/*	Draw the part of the scaled sprite from left, top to right, bottom,
+	in destination pixels, taking the sprite pixel that is closest
+	to the center of each one.
+*/
+void
+FLBuffer::_DrawSpriteNearest(const FLSprite* sprite, int32 x, int32 y,
+	int32 size, int32 left, int32 top, int32 right, int32 bottom)
+{
+	const uint32* bits = sprite->Bits();
+	int32 width = sprite->Width();
+	
+	// In 16.16 fixed point, like the bilinear path
+	int32 step = (width << 16) / size;
+	int32 start = step / 2;
+	
+	for (int32 row = top; row < bottom; row++) {
+		const uint32* line = bits + ((start + row * step) >> 16) * width;
+		uint32* dest = (uint32*)(fBits + (y + row) * fBytesPerRow) + x;
+		
+		int32 u = start + left * step;
+		for (int32 column = left; column < right; column++, u += step) {
+			uint32 color = line[u >> 16];
+			uint32 alpha = color >> 24;
+			
+			if (alpha == 255)
+				dest[column] = color;
+			else if (alpha != 0)
+				dest[column] = blend(dest[column], color);
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLBUFFER_H_
+#define _FLBUFFER_H_
+
+
+#include "FLTypes.h"
+
+
+class FLSprite;
+
+
+/*	A B_RGBA32 frame the leaves are drawn into. The buffer doesn't own
+	its pixels; on Haiku they belong to the back bitmap, in the headless
+	harness to a plain block of memory.
+
+	Drawing can be clipped to a band of rows, so that a frame can be
+	cleared and drawn one band at a time, while the band is still in
+	the cache, instead of clearing all of it and then going over it
+	again to draw.
+*/
+class FLBuffer
+{
+public:
+					FLBuffer(void* bits, int32 width, int32 height,
+						int32 bytesPerRow);
+	
+	uint8*			Bits() const { return fBits; };
+	int32			Width() const { return fWidth; };
+	int32			Height() const { return fHeight; };
+	int32			BytesPerRow() const { return fBytesPerRow; };
+	
+	void			Clear(uint32 color);
+	void			ClearRows(int32 top, int32 bottom, uint32 color,
+						bool stream = false);
+						// Fill the rows from top up to bottom. With
+						// "stream", the pixels go straight to memory
+						// without being kept in the cache, which is
+						// faster for rows that nothing is drawn on.
+	
+	void			SetClip(int32 top, int32 bottom);
+						// Only draw on the rows from top up to
+						// bottom, all of them by default
+	void			DrawSprite(const FLSprite* sprite, int32 x, int32 y);
+						// Draw the sprite over the buffer with its
+						// top left corner at x, y, clipped to the
+						// buffer
+	void			DrawSprite(const FLSprite* sprite, int32 x, int32 y,
+						int32 size, bool smooth = true);
+						// The same, but scaled to size by size
+						// pixels with bilinear filtering, or with
+						// the nearest pixel if "smooth" is false,
+						// which is faster
+	
+private:
+	void			_DrawSpriteNearest(const FLSprite* sprite, int32 x,
+						int32 y, int32 size, int32 left, int32 top,
+						int32 right, int32 bottom);
+	
+	uint8*			fBits;
+	int32			fWidth;
+	int32			fHeight;
+	int32			fBytesPerRow;
+	
+	int32			fClipTop;
+	int32			fClipBottom;
+};
+
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLDepthList.h"
+
+#include "FLLeaf.h"
+
+
+FLDepthList::FLDepthList(int32 minZ, int32 maxZ)
+	:
+	fMinZ(minZ),
+	fMaxZ(maxZ),
+	fWordCount((maxZ - minZ + 1 + 31) / 32),
+	fBuckets(NULL),
+	fNonEmpty(NULL),
+	fUsed(NULL),
+	fUsers(NULL),
+	fCount(0)
+{
+	int32 depths = fMaxZ - fMinZ + 1;
+
+	fBuckets = new Leaf*[depths];
+	fUsers = new int32[depths];
+	for (int32 i = 0; i < depths; i++) {
+		fBuckets[i] = NULL;
+		fUsers[i] = 0;
+	}
+
+	fNonEmpty = new uint32[fWordCount];
+	fUsed = new uint32[fWordCount];
+	for (int32 i = 0; i < fWordCount; i++) {
+		fNonEmpty[i] = 0;
+		fUsed[i] = 0;
+	}
+
+	// The bits past the last depth are never free
+	if (depths % 32 != 0)
+		fUsed[fWordCount - 1] = ~((1U << (depths % 32)) - 1);
+}
+
+
+FLDepthList::~FLDepthList()
+{
+	delete[] fBuckets;
+	delete[] fNonEmpty;
+	delete[] fUsed;
+	delete[] fUsers;
+}
+
+
+void
+FLDepthList::AddItem(Leaf* leaf)
+{
+	int32 index = leaf->Z() - fMinZ;
+
+	leaf->fPrevious = NULL;
+	leaf->fNext = fBuckets[index];
+	if (leaf->fNext != NULL)
+		leaf->fNext->fPrevious = leaf;
+	fBuckets[index] = leaf;
+
+	fNonEmpty[index / 32] |= 1U << (index % 32);
+	fCount++;
+}
+
+
+void
+FLDepthList::RemoveItem(Leaf* leaf)
+{
+	int32 index = leaf->Z() - fMinZ;
+
+	if (leaf->fPrevious != NULL)
+		leaf->fPrevious->fNext = leaf->fNext;
+	else
+		fBuckets[index] = leaf->fNext;
+
+	if (leaf->fNext != NULL)
+		leaf->fNext->fPrevious = leaf->fPrevious;
+
+	leaf->fPrevious = NULL;
+	leaf->fNext = NULL;
+
+	if (fBuckets[index] == NULL)
+		fNonEmpty[index / 32] &= ~(1U << (index % 32));
+	fCount--;
+}
+
+
+Leaf*
+FLDepthList::First() const
+{
+	return _FirstFrom(fMinZ);
+}
+
+
+Leaf*
+FLDepthList::Next(const Leaf* leaf) const
+{
+	if (leaf->fNext != NULL)
+		return leaf->fNext;
+
+	return _FirstFrom(leaf->Z() + 1);
+}
+
+
+int32
+FLDepthList::AllocateDepth(int32 preferred)
+{
+	int32 from = preferred - fMinZ;
+	if (from < 0 || from > fMaxZ - fMinZ)
+		from = 0;
+
+	int32 index = _FindFirst(fUsed, fWordCount, from, false);
+	if (index < 0)
+		index = _FindFirst(fUsed, fWordCount, 0, false);
+	if (index < 0)
+		index = from;
+
+	UseDepth(fMinZ + index);
+
+	return fMinZ + index;
+}
+
+
+void
+FLDepthList::UseDepth(int32 z)
+{
+	int32 index = z - fMinZ;
+	fUsed[index / 32] |= 1U << (index % 32);
+	fUsers[index]++;
+}
+
+
+void
+FLDepthList::FreeDepth(int32 z)
+{
+	int32 index = z - fMinZ;
+	if (--fUsers[index] == 0)
+		fUsed[index / 32] &= ~(1U << (index % 32));
+}
+
+
+Leaf*
+FLDepthList::_FirstFrom(int32 z) const
+{
+	if (z > fMaxZ)
+		return NULL;
+
+	int32 index = _FindFirst(fNonEmpty, fWordCount, z - fMinZ, true);
+	if (index < 0)
+		return NULL;
+
+	return fBuckets[index];
+}
+
+
+/*	Find the index of the first bit at or after "from" that is set
+	(or clear, if "set" is false). Returns -1 if there is none.
+*/
+int32
+FLDepthList::_FindFirst(const uint32* words, int32 wordCount, int32 from,
+	bool set)
+{
+	int32 word = from / 32;
+	if (word >= wordCount)
+		return -1;
+
+	// Ignore the bits before "from" in its own word
+	uint32 bits = set ? words[word] : ~words[word];
+	bits &= ~((1U << (from % 32)) - 1);
+
+	while (bits == 0) {
+		if (++word == wordCount)
+			return -1;
+		bits = set ? words[word] : ~words[word];
+	}
+
+	return word * 32 + __builtin_ctz(bits);
+}
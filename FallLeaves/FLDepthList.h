@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLDEPTHLIST_H_
+#define _FLDEPTHLIST_H_
+
+
+#include "FLTypes.h"
+
+
+class Leaf;
+
+
+/*	Keeps the leaves ordered by their Z axis without ever sorting them.
+	Z is a small bounded integer, so each depth gets its own bucket and
+	a leaf is linked into the bucket of its depth. Inserting and removing
+	a leaf are O(1), and walking the buckets from the smallest to the
+	largest Z gives the back to front drawing order.
+
+	The list also hands out the depths themselves. A bitset of the used
+	depths is searched for the first free one, a word at a time. Once
+	every depth is used, leaves share them, so there can be any number
+	of leaves.
+*/
+class FLDepthList
+{
+public:
+					FLDepthList(int32 minZ, int32 maxZ);
+					~FLDepthList();
+
+	void			AddItem(Leaf* leaf);
+	void			RemoveItem(Leaf* leaf);
+	int32			CountItems() const { return fCount; };
+
+	Leaf*			First() const;
+	Leaf*			Next(const Leaf* leaf) const;
+						// Iterate from the farthest to the closest leaf
+
+	int32			AllocateDepth(int32 preferred);
+						// Returns the first free depth at or after
+						// "preferred", wrapping around, or
+						// "preferred" itself if every depth is
+						// taken
+	void			UseDepth(int32 z);
+						// Hand out "z" itself, whether it is free
+						// or not, to put a saved leaf back
+	void			FreeDepth(int32 z);
+
+private:
+	Leaf*			_FirstFrom(int32 z) const;
+
+	static int32	_FindFirst(const uint32* words, int32 wordCount,
+						int32 from, bool set);
+
+	int32			fMinZ;
+	int32			fMaxZ;
+	int32			fWordCount;
+
+	Leaf**			fBuckets;
+						// The first leaf at each depth
+	uint32*			fNonEmpty;
+						// One bit for every bucket that holds a leaf
+	uint32*			fUsed;
+						// One bit for every depth that is handed out
+	int32*			fUsers;
+						// How many times each depth is handed out
+
+	int32			fCount;
+};
+
+
+#endif
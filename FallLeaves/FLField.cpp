@@ -0,0 +1,671 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ *
+ * The leaf logic used to live in FallLeaves.cpp, by David Couzelis.
+ */
+
+
+#include "FLField.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include "FLBuffer.h"
+#include "FLDepthList.h"
+#include "FLLeaf.h"
+#include "FLPool.h"
+#include "FLSprite.h"
+#include "FLSpriteSet.h"
+#include "FLWorkers.h"
+#include "FrameTrace.h"
+#include "Snapshot.h"
+
+
+// The rows of the frame that are cleared and drawn together. A band
+// of a wide screen still fits in the cache with the leaf images.
+static const int32 kBandHeight = 32;
+
+
+FLField::FLField(FLSpriteSource* sprites)
+	:
+	fSprites(sprites),
+	fTrace(NULL),
+	fLeaves(NULL),
+	fLeafPool(NULL),
+	fVisible(NULL),
+	fWorkers(NULL),
+	fWorkerCount(FLWorkers::CountProcessors()),
+	fBuilding(0),
+	fCachedSprites(0),
+	fWidth(0),
+	fHeight(0),
+	fSteps(0),
+	fSize(0),
+	fAmount(kDefaultAmount),
+	fSpeed(kDefaultSpeed),
+	fSmooth(true),
+	fBanded(true),
+	fDrawn(0),
+	fCulled(0),
+	fWaiting(0)
+{
+	for (int32 i = 0; i < kNumLeafTypes; i++)
+		fSpriteSets[i] = NULL;
+	
+	fCachePath[0] = '\0';
+}
+
+
+FLField::~FLField()
+{
+	_DeleteLeaves();
+	_DeleteSprites();
+	delete fWorkers;
+}
+
+
+void
+FLField::SetCachePath(const char* path)
+{
+	if (path == NULL
+		|| snprintf(fCachePath, sizeof(fCachePath), "%s", path)
+			>= (int)sizeof(fCachePath))
+		fCachePath[0] = '\0';
+}
+
+
+void
+FLField::Start(int32 width, int32 height, uint32 seed)
+{
+	_Prepare(width, height, fAmount);
+	
+	fRandom.SetSeed(seed);
+	fSteps = 0;
+	
+	// The biggest gusts are about as wide as the screen,
+	// and about as strong as the fastest leaves fall
+	fWind.Generate(fRandom, fWidth / 16.0f,
+		(fHeight * fSpeed) / kMaxSpeed * 0.5f);
+	
+	// Create some leaves
+	for (int32 i = 0; i < fAmount; i++) {
+		Leaf* leaf = _CreateLeaf(true);
+		if (leaf == NULL)
+			break;
+		fLeaves->AddItem(leaf);
+	}
+}
+
+
+void
+FLField::Step()
+{
+	fSteps++;
+	
+	float seconds = kStepTime / 1000000.0f;
+	
+	// Move all of the leaves at once, straight through the
+	// pool arrays, before looking at any of them
+	fWind.Advance(seconds);
+	fLeafPool->Integrate(seconds, fWind);
+	
+	// With the amount lowered, the extra leaves are
+	// taken away, first where they can't be seen
+	int32 extra = fLeaves->CountItems() - fAmount;
+	
+	Leaf* leaf = fLeaves->First();
+	while (leaf != NULL) {
+		Leaf* next = fLeaves->Next(leaf);
+		
+		// If the leaf is dead, remove it
+		if (leaf->IsDead())
+			_DeleteLeaf(leaf);
+		else if (extra > 0 && !fLeafPool->IsVisible(leaf->Index())) {
+			_DeleteLeaf(leaf);
+			extra--;
+		}
+		
+		leaf = next;
+	}
+	
+	// If that wasn't enough, the farthest leaves go,
+	// they are the smallest and the least missed
+	while (extra > 0 && (leaf = fLeaves->First()) != NULL) {
+		_DeleteLeaf(leaf);
+		extra--;
+	}
+	
+	// Add some new leaves if necessary
+	// to replace any dead ones
+	while (fLeaves->CountItems() < fAmount) {
+		leaf = _CreateLeaf(false);
+		if (leaf == NULL)
+			break;
+		fLeaves->AddItem(leaf);
+	}
+}
+
+
+void
+FLField::Draw(FLBuffer* buffer, float alpha)
+{
+	fDrawn = 0;
+	fCulled = 0;
+	fWaiting = 0;
+	
+	if (!fBanded) {
+		TRACE_SCOPE(fTrace, "clear");
+		buffer->Clear(kBackgroundColor);
+	}
+	
+	TRACE_SCOPE(fTrace, "compose");
+	
+	// Most of the leaves start out above the screen, so find
+	// the ones that can be seen in one pass over the pool
+	// before walking the depth list
+	fLeafPool->Classify(alpha, buffer->Width(), buffer->Height());
+	
+	if (fBanded)
+		_DrawBanded(buffer);
+	else
+		_DrawAll(buffer);
+}
+
+
+int32
+FLField::CountLeaves() const
+{
+	return fLeaves != NULL ? fLeaves->CountItems() : 0;
+}
+
+
+bool
+FLField::SpritesReady() const
+{
+	for (int32 i = 0; i < kNumLeafTypes; i++) {
+		if (fSpriteSets[i] == NULL || !fSpriteSets[i]->IsComplete())
+			return false;
+	}
+	
+	return true;
+}
+
+
+void
+FLField::WaitForSprites()
+{
+	if (fWorkers != NULL)
+		fWorkers->Wait();
+}
+
+
+int32
+FLField::MaxLeaves() const
+{
+	return fLeafPool != NULL ? fLeafPool->Capacity() : 0;
+}
+
+
+size_t
+FLField::SpriteBytes() const
+{
+	size_t bytes = 0;
+	for (int32 i = 0; i < kNumLeafTypes; i++) {
+		if (fSpriteSets[i] != NULL)
+			bytes += fSpriteSets[i]->Bytes();
+	}
+	
+	return bytes;
+}
+
+
+void
+FLField::WriteSnapshot(Snapshot& snapshot) const
+{
+	snapshot.Write(fWidth);
+	snapshot.Write(fHeight);
+	snapshot.Write(MaxLeaves());
+	snapshot.Write(fAmount);
+	snapshot.Write(fSpeed);
+	snapshot.Write(fSmooth);
+	snapshot.Write(fSteps);
+	snapshot.Write(fRandom.State());
+	fWind.WriteSnapshot(snapshot);
+	
+	// Every leaf from the farthest to the closest,
+	// the order they are drawn in
+	snapshot.Write(CountLeaves());
+	if (fLeaves == NULL)
+		return;
+	
+	for (Leaf* leaf = fLeaves->First(); leaf != NULL;
+			leaf = fLeaves->Next(leaf)) {
+		int32 type = 0;
+		while (type < kNumLeafTypes - 1
+			&& fSpriteSets[type] != leaf->Sprites())
+			type++;
+		
+		int32 index = leaf->Index();
+		snapshot.Write(leaf->Z());
+		snapshot.Write(type);
+		snapshot.Write(leaf->Width());
+		snapshot.Write(fLeafPool->X()[index]);
+		snapshot.Write(fLeafPool->Y()[index]);
+		snapshot.Write(fLeafPool->PreviousX()[index]);
+		snapshot.Write(fLeafPool->PreviousY()[index]);
+		snapshot.Write(fLeafPool->SpeedX()[index]);
+		snapshot.Write(fLeafPool->SpeedY()[index]);
+		snapshot.Write(fLeafPool->FallSpeed()[index]);
+		snapshot.Write(fLeafPool->Tilt()[index]);
+		snapshot.Write(fLeafPool->TiltSpeed()[index]);
+		snapshot.Write(fLeafPool->Sway()[index]);
+		
+		// Which leaves were seen in the last frame
+		// decides which ones go first
+		snapshot.Write(fLeafPool->IsVisible(index));
+	}
+}
+
+
+status_t
+FLField::ReadSnapshot(Snapshot& snapshot)
+{
+	int32 width;
+	int32 height;
+	int32 capacity;
+	int32 amount;
+	int32 speed;
+	bool smooth;
+	int64 steps;
+	uint32 state;
+	snapshot.Read(&width);
+	snapshot.Read(&height);
+	snapshot.Read(&capacity);
+	snapshot.Read(&amount);
+	snapshot.Read(&speed);
+	snapshot.Read(&smooth);
+	snapshot.Read(&steps);
+	snapshot.Read(&state);
+	if (snapshot.Status() != B_OK || width < 1 || height < 1
+		|| capacity < 0 || amount < 0 || speed < kMinSpeed
+		|| speed > kMaxSpeed)
+		return B_BAD_VALUE;
+	
+	_Prepare(width, height, capacity);
+	
+	fAmount = amount;
+	fSpeed = speed;
+	fSmooth = smooth;
+	fSteps = steps;
+	fRandom.SetSeed(state);
+	fWind.ReadSnapshot(snapshot);
+	
+	int32 count;
+	if (snapshot.Read(&count) != B_OK || count < 0
+		|| count > fLeafPool->Capacity())
+		return B_BAD_VALUE;
+	
+	Leaf** leaves = new Leaf*[count];
+	int32 restored = 0;
+	
+	for (; restored < count; restored++) {
+		int32 z;
+		int32 type;
+		int32 size;
+		snapshot.Read(&z);
+		snapshot.Read(&type);
+		snapshot.Read(&size);
+		if (snapshot.Status() != B_OK || z < kMinZ || z > kMaxZ
+			|| type < 0 || type >= kNumLeafTypes || size < 0)
+			break;
+		
+		Leaf* leaf = fLeafPool->Acquire();
+		leaf->SetSprites(fSpriteSets[type], size);
+		leaf->SetZ(z);
+		leaf->SetBoundary(-leaf->Width(), -fHeight, fWidth, fHeight);
+		fLeaves->UseDepth(z);
+		
+		int32 index = leaf->Index();
+		snapshot.Read(&fLeafPool->X()[index]);
+		snapshot.Read(&fLeafPool->Y()[index]);
+		snapshot.Read(&fLeafPool->PreviousX()[index]);
+		snapshot.Read(&fLeafPool->PreviousY()[index]);
+		snapshot.Read(&fLeafPool->SpeedX()[index]);
+		snapshot.Read(&fLeafPool->SpeedY()[index]);
+		snapshot.Read(&fLeafPool->FallSpeed()[index]);
+		snapshot.Read(&fLeafPool->Tilt()[index]);
+		snapshot.Read(&fLeafPool->TiltSpeed()[index]);
+		snapshot.Read(&fLeafPool->Sway()[index]);
+		
+		bool visible = false;
+		snapshot.Read(&visible);
+		fLeafPool->SetVisible(index, visible);
+		
+		leaves[restored] = leaf;
+	}
+	
+	// Every depth keeps its leaves with the last one added
+	// first, so adding them backwards keeps the order
+	for (int32 i = restored - 1; i >= 0; i--)
+		fLeaves->AddItem(leaves[i]);
+	delete[] leaves;
+	
+	if (restored < count || snapshot.Status() != B_OK) {
+		_Prepare(width, height, capacity);
+		return B_BAD_VALUE;
+	}
+	
+	return B_OK;
+}
+
+
+/*	Make room for "capacity" leaves on a width by height screen,
+	without any leaves yet. The leaf images are only built again
+	if the screen changed. There is always room for kMaxAmount,
+	so that the amount can be raised up to that at any time.
+*/
+void
+FLField::_Prepare(int32 width, int32 height, int32 capacity)
+{
+	if (capacity < kMaxAmount)
+		capacity = kMaxAmount;
+	
+	bool sameSize = fSpriteSets[0] != NULL && width == fWidth
+		&& height == fHeight;
+	
+	_DeleteLeaves();
+	if (!sameSize)
+		_DeleteSprites();
+	
+	fWidth = width;
+	fHeight = height;
+	
+	// The max size of a leaf will be about 20% the
+	// height of the screen
+	fSize = (fHeight * 2) / 10;
+	
+	// Each leaf goes straight into the bucket
+	// for its Z axis, so they never need sorting
+	fLeaves = new FLDepthList(kMinZ, kMaxZ);
+	fLeafPool = new FLLeafPool(capacity);
+	fVisible = new Leaf*[capacity > 0 ? capacity : 1];
+	
+	if (!sameSize)
+		_StartSprites();
+}
+
+
+/*
+	Create a leaf.
+	If the "above" parameter is true, it will create the leaf in
+	a random location above the screen. If it's false, the leaf
+	will be created just above the screen, ready to come it.
+	Returns NULL if the pool has no leaves left.
+*/
+Leaf*
+FLField::_CreateLeaf(bool above)
+{
+	// The Z axis (how far away the leaf is)
+	// determines the size and speed
+	
+	// Each leaf gets the next free Z value at or after a
+	// random starting point, as long as there are free
+	// ones. After that, leaves share them.
+	int32 z = fLeaves->AllocateDepth(fRandom.Range(kMinZ, kMaxZ));
+	
+	// The lower the Z axis number, the smaller the leaf
+	int32 size = (fSize * z) / 100;
+	
+	Leaf* leaf = fLeafPool->Acquire();
+	if (leaf == NULL) {
+		fLeaves->FreeDepth(z);
+		return NULL;
+	}
+	
+	// Use a randomly selected image
+	int32 type = fRandom.Range(0, kNumLeafTypes - 1);
+	leaf->SetSprites(fSpriteSets[type], (int32)((size + 1) * kFramePadding));
+	
+	leaf->SetZ(z);
+	
+	// The lower the Z axis number, the slower the leaf
+	int32 maxSpeed = (fHeight * fSpeed) / kMaxSpeed;
+	int32 speed = (maxSpeed * z) / 100;
+	leaf->SetSpeed(speed);
+	
+	// Every leaf sways a little differently
+	leaf->SetSway(fRandom.Range(30, 100) / 100.0f,
+		fRandom.Range(0, 628) / 100.0f, fRandom.Range(20, 60) / 100.0f);
+	
+	// The wind can carry the leaf off either side,
+	// it is only dead once it is all the way off
+	leaf->SetBoundary(-leaf->Width(), -fHeight, fWidth, fHeight);
+	
+	// Set it to a random position
+	int32 left = -(size / 2);
+	int32 right = fWidth - (size / 2);
+	int32 x = fRandom.Range(left, right - left);
+	int32 y = -size;
+	
+	if (above)
+		y = -fRandom.Range(size, fHeight * 2);
+	
+	leaf->SetPos(x, y);
+	
+	return leaf;
+}
+
+
+/*	Give the leaf and its depth back,
+	so they can be used for a new leaf.
+*/
+void
+FLField::_DeleteLeaf(Leaf* leaf)
+{
+	fLeaves->FreeDepth(leaf->Z());
+	fLeaves->RemoveItem(leaf);
+	fLeafPool->Release(leaf);
+}
+
+
+void
+FLField::_DeleteLeaves()
+{
+	// The pool owns the leaves
+	delete fLeaves;
+	delete fLeafPool;
+	delete[] fVisible;
+	
+	fLeaves = NULL;
+	fLeafPool = NULL;
+	fVisible = NULL;
+}
+
+
+/*	Clear the frame and draw the leaves over it one band of rows at a
+	time, so the band is still in the cache when the leaves are drawn.
+	The bands without any leaves are never read again this frame, so
+	they are cleared without going through the cache at all.
+*/
+void
+FLField::_DrawBanded(FLBuffer* buffer)
+{
+	// Gather the leaves that can be seen, from
+	// the farthest to the closest, only once
+	int32 count = 0;
+	for (Leaf* leaf = fLeaves->First(); leaf != NULL;
+			leaf = fLeaves->Next(leaf)) {
+		if (fLeafPool->IsVisible(leaf->Index()))
+			fVisible[count++] = leaf;
+		else
+			fCulled++;
+	}
+	
+	int32 height = buffer->Height();
+	for (int32 top = 0; top < height; top += kBandHeight) {
+		int32 bottom = top + kBandHeight < height
+			? top + kBandHeight : height;
+		
+		buffer->SetClip(top, bottom);
+		
+		bool cleared = false;
+		for (int32 i = 0; i < count; i++) {
+			Leaf* leaf = fVisible[i];
+			int32 y = (int32)floorf(fLeafPool->DrawY(leaf->Index()));
+			if (y >= bottom || y + leaf->Height() <= top)
+				continue;
+			
+			if (!cleared) {
+				buffer->ClearRows(top, bottom, kBackgroundColor);
+				cleared = true;
+			}
+			
+			// Every band the leaf is in draws its part of it,
+			// but it is only counted in the first one
+			bool drawn = leaf->Draw(buffer, fSmooth);
+			if (y >= top || top == 0) {
+				if (drawn)
+					fDrawn++;
+				else
+					fWaiting++;
+			}
+		}
+		
+		if (!cleared)
+			buffer->ClearRows(top, bottom, kBackgroundColor, true);
+	}
+	
+	buffer->SetClip(0, height);
+}
+
+
+/*	Draw the leaves over the whole frame, from the farthest to the
+	closest, after it has been cleared.
+*/
+void
+FLField::_DrawAll(FLBuffer* buffer)
+{
+	for (Leaf* leaf = fLeaves->First(); leaf != NULL;
+			leaf = fLeaves->Next(leaf)) {
+		if (!fLeafPool->IsVisible(leaf->Index())) {
+			fCulled++;
+			continue;
+		}
+		
+		if (leaf->Draw(buffer, fSmooth))
+			fDrawn++;
+		else
+			fWaiting++;
+	}
+}
+
+
+void
+FLField::_StartSprites()
+{
+	// Rasterize every leaf image once, big enough for the
+	// closest leaf, turn it to every tilt and scale it
+	// down from there. That is slow on a big screen, so
+	// it is done in the background, one image per job.
+	if (fWorkers == NULL && fWorkerCount > 0)
+		fWorkers = new FLWorkers(fWorkerCount, kNumLeafTypes);
+	
+	int32 biggest = (int32)(((fSize * kMaxZ) / 100 + 1) * kFramePadding);
+	
+	// But first, look for them in the cache
+	if (fCachePath[0] != '\0')
+		fSpriteCache.Open(fCachePath);
+	
+	fCachedSprites = 0;
+	int32 building = 0;
+	for (int32 type = 0; type < kNumLeafTypes; type++) {
+		FLSpriteCache::key& key = fSpriteKeys[type];
+		key.hash = fSprites->SpriteHash(type);
+		key.size = FLSpriteSet::SizeFor(biggest);
+		key.frames = kNumTilts;
+		key.angle = (int32)(kMaxTilt * 100);
+		key.colorSpace = kSpriteColorSpace;
+		
+		const uint32* bits = NULL;
+		if (key.hash != 0)
+			bits = fSpriteCache.Find(key);
+		
+		if (bits != NULL) {
+			fSpriteSets[type] = new FLSpriteSet(biggest, kNumTilts, bits);
+			fCachedSprites++;
+		} else {
+			fSpriteSets[type] = new FLSpriteSet(biggest, kNumTilts);
+			building++;
+		}
+	}
+	
+	// The last job to finish saves the cache
+	fBuilding = building;
+	
+	for (int32 type = 0; type < kNumLeafTypes; type++) {
+		if (fSpriteSets[type]->IsComplete())
+			continue;
+		
+		fSpriteJobs[type].field = this;
+		fSpriteJobs[type].type = type;
+		
+		if (fWorkers == NULL
+			|| !fWorkers->AddJob(&_BuildSprites, &fSpriteJobs[type]))
+			_BuildSprites(&fSpriteJobs[type]);
+	}
+}
+
+
+void
+FLField::_DeleteSprites()
+{
+	// The images may still be being built
+	WaitForSprites();
+	
+	for (int32 i = 0; i < kNumLeafTypes; i++) {
+		delete fSpriteSets[i];
+		fSpriteSets[i] = NULL;
+	}
+	
+	// Only now that no set uses its pixels
+	fSpriteCache.Close();
+}
+
+
+/*	Build the images for one type of leaf. This
+	runs on one of the worker threads.
+*/
+void
+FLField::_BuildSprites(void* data)
+{
+	sprite_job* job = (sprite_job*)data;
+	FLSpriteSet* set = job->field->fSpriteSets[job->type];
+	
+	TRACE_SCOPE(job->field->fTrace, "build sprites");
+	
+	job->field->fSprites->RenderSprite(job->type, set->Source());
+	set->Build(kMaxTilt);
+	
+	if (__atomic_sub_fetch(&job->field->fBuilding, 1, __ATOMIC_ACQ_REL) == 0)
+		job->field->_WriteCache();
+}
+
+
+/*	Save every leaf image, once they are all built.
+	This runs on the thread that built the last one.
+*/
+void
+FLField::_WriteCache()
+{
+	if (fCachePath[0] == '\0')
+		return;
+	
+	for (int32 i = 0; i < kNumLeafTypes; i++) {
+		if (fSpriteKeys[i].hash == 0)
+			return;
+	}
+	
+	FLSpriteCache::Write(fCachePath, fSpriteKeys, fSpriteSets,
+		kNumLeafTypes);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLFIELD_H_
+#define _FLFIELD_H_
+
+
+#include "FLRandom.h"
+#include "FLSpriteCache.h"
+#include "FLTypes.h"
+#include "FLWind.h"
+
+
+class FLBuffer;
+class FLDepthList;
+class FLLeafPool;
+class FLSprite;
+class FLSpriteSet;
+class FLWorkers;
+class FrameTrace;
+class Leaf;
+class Snapshot;
+
+
+// The number of leaves on the screen, as far as the settings
+// go. The field itself can take any number.
+const int32 kMaxAmount = 500;
+const int32 kMinAmount = 10;
+const int32 kDefaultAmount = 35;
+
+// The speed of the leaves
+const int32 kMaxSpeed = 10;
+const int32 kMinSpeed = 1;
+const int32 kDefaultSpeed = 5;
+
+// The number of different leaf images
+const int32 kNumLeafTypes = 6;
+
+// The leaves tilt up to this many degrees either way, and
+// each leaf image is turned to this many angles in between
+const float kMaxTilt = 30.0f;
+const int32 kNumTilts = 7;
+
+// The range of the Z axis
+const int32 kMinZ = 40;
+const int32 kMaxZ = 100;
+
+// The leaves move in steps of this many microseconds
+const bigtime_t kStepTime = 10000;
+
+// The background behind the leaves, opaque black
+const uint32 kBackgroundColor = 0xff000000;
+
+// The snapshots of FallLeaves, see FLField::WriteSnapshot(). Bump
+// the version whenever what goes into them changes.
+const uint32 kSnapshotType = 'FLst';
+const uint32 kSnapshotVersion = 1;
+
+
+/*	Where the images of the leaves come from. The screensaver
+	rasterizes the vector icons, the headless harness draws
+	simple shapes instead.
+*/
+class FLSpriteSource
+{
+public:
+	virtual					~FLSpriteSource() {};
+	
+	virtual void			RenderSprite(int32 type,
+								FLSprite* sprite) = 0;
+								// Draw leaf image "type", from 0 to
+								// kNumLeafTypes - 1, to fill the sprite.
+								// This is only done once for every type,
+								// when the field starts, but it can be
+								// on another thread, and for several
+								// types at the same time.
+	
+	virtual uint64			SpriteHash(int32 type) { return 0; };
+								// A hash of everything leaf image "type"
+								// is made from. The images are only
+								// saved in the sprite cache if every
+								// type has one, which isn't zero.
+};
+
+
+/*	All of the falling leaves: spawning them, blowing them about
+	in the wind, removing them once they leave the screen and
+	drawing them from back to front. Nothing in here needs a
+	BView, so it runs just the same in the screensaver and
+	headless.
+*/
+class FLField
+{
+public:
+							FLField(FLSpriteSource* sprites);
+							~FLField();
+	
+	void					SetWorkerCount(int32 count)
+								{ fWorkerCount = count; };
+								// The threads that build the leaf images
+								// in the background, one per processor
+								// by default. With none, Start() builds
+								// them all before it returns.
+	
+	void					SetCachePath(const char* path);
+								// Where the built leaf images are saved,
+								// so the next start can use them as
+								// they are. NULL, the default, never
+								// saves them.
+	
+	void					SetTrace(FrameTrace* trace)
+								{ fTrace = trace; };
+								// Times clearing and composing the
+								// frames, and building the leaf images,
+								// while the trace is enabled
+	
+	void					Start(int32 width, int32 height, uint32 seed);
+	
+	bool					SpritesReady() const;
+	void					WaitForSprites();
+								// The leaves are only drawn once their
+								// images are built, until then they
+								// just fall
+	
+	void					Step();
+								// Move every leaf one step of kStepTime
+								// and replace the ones that fell off
+								// the screen
+	void					Draw(FLBuffer* buffer, float alpha = 1.0);
+								// Draw the leaves "alpha" of the way
+								// into the last step. Leaves that are
+								// entirely off the screen are skipped.
+	int64					CountSteps() const { return fSteps; };
+								// Since the last start
+	
+	void					WriteSnapshot(Snapshot& snapshot) const;
+								// Everything the next steps depend on:
+								// the settings, the random number
+								// generator, the wind and every leaf
+	status_t				ReadSnapshot(Snapshot& snapshot);
+								// Start from a snapshot instead, on a
+								// screen of the size it was taken on.
+								// The leaf images are only built again
+								// if that is a different size. A
+								// snapshot that is no good leaves the
+								// field as it was, or without leaves.
+	
+	void					SetAmount(int32 amount) { fAmount = amount; };
+								// Takes effect at the next step, and
+								// up to kMaxAmount at any time.
+								// Lowering it takes leaves away, the
+								// ones off the screen and then the
+								// farthest ones.
+	void					SetSpeed(int32 speed) { fSpeed = speed; };
+	void					SetSmooth(bool smooth) { fSmooth = smooth; };
+								// Draw the leaves with bilinear
+								// filtering, the default, or faster
+								// without it
+	void					SetBanded(bool banded) { fBanded = banded; };
+								// Clear and draw the frame a band of
+								// rows at a time, the default, so every
+								// pixel is only brought into the cache
+								// once. Otherwise all of it is cleared
+								// first and then drawn on.
+	
+	int32					Width() const { return fWidth; };
+	int32					Height() const { return fHeight; };
+								// The screen, from the last start
+	
+	int32					CountLeaves() const;
+	int32					MaxLeaves() const;
+								// kMaxAmount, or the amount at the last
+								// start if that was more
+	size_t					SpriteBytes() const;
+								// The memory used by the leaf images
+	int32					CountCachedSprites() const
+								{ return fCachedSprites; };
+								// The leaf images that came from the
+								// cache at the last start
+	
+	int32					CountDrawn() const { return fDrawn; };
+	int32					CountCulled() const { return fCulled; };
+	int32					CountWaiting() const { return fWaiting; };
+								// The leaves that the last Draw()
+								// drew, skipped because they were off
+								// the screen, and skipped because their
+								// images weren't ready yet
+	
+private:
+	void					_Prepare(int32 width, int32 height,
+								int32 capacity);
+	Leaf*					_CreateLeaf(bool above);
+	void					_DeleteLeaf(Leaf* leaf);
+	void					_DeleteLeaves();
+	
+	void					_DrawBanded(FLBuffer* buffer);
+	void					_DrawAll(FLBuffer* buffer);
+	
+	void					_StartSprites();
+	void					_DeleteSprites();
+	static void				_BuildSprites(void* data);
+	void					_WriteCache();
+	
+	FLSpriteSource*			fSprites;
+	FrameTrace*				fTrace;
+	FLDepthList*			fLeaves;
+								// Kept in order of their Z axis
+	FLLeafPool*				fLeafPool;
+								// Every leaf comes from here, so
+								// nothing is allocated once the
+								// leaves are falling
+	Leaf**					fVisible;
+								// The leaves being drawn, back to front,
+								// with room for all of them
+	FLSpriteSet*			fSpriteSets[kNumLeafTypes];
+								// Every leaf image at every size
+	
+	struct sprite_job {
+		FLField*			field;
+		int32				type;
+	};
+	sprite_job				fSpriteJobs[kNumLeafTypes];
+	FLWorkers*				fWorkers;
+	int32					fWorkerCount;
+	int32					fBuilding;
+								// The sets that are still being built
+	
+	char					fCachePath[1024];
+	FLSpriteCache			fSpriteCache;
+	FLSpriteCache::key		fSpriteKeys[kNumLeafTypes];
+	int32					fCachedSprites;
+	
+	FLRandom				fRandom;
+	FLWind					fWind;
+	
+	int32					fWidth;
+	int32					fHeight;
+	int64					fSteps;
+	
+	int32					fSize;
+								// The size of the biggest possible leaf
+	
+	int32					fAmount;
+								// The amount of leaves on the screen
+	int32					fSpeed;
+								// The speed of the fastest leaf
+	
+	bool					fSmooth;
+	bool					fBanded;
+	
+	int32					fDrawn;
+	int32					fCulled;
+	int32					fWaiting;
+};
+
+
+#endif
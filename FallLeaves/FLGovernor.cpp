@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLGovernor.h"
+
+
+// The frames to average after a change,
+// before deciding on the next one
+static const int32 kSettleFrames = 8;
+
+// Only add leaves back when the frames take less
+// than this part of the budget, in percent
+static const int32 kHeadroom = 70;
+
+
+FLGovernor::FLGovernor(bigtime_t budget)
+	:
+	fBudget(budget),
+	fAverageCost(0),
+	fSettling(0),
+	fMaxAmount(0),
+	fMinAmount(0),
+	fAmount(0),
+	fSmooth(true),
+	fDecreases(0),
+	fIncreases(0)
+{
+	// Empty
+}
+
+
+void
+FLGovernor::Reset(int32 amount, int32 minAmount)
+{
+	fMaxAmount = amount;
+	fMinAmount = minAmount < amount ? minAmount : amount;
+	fAmount = amount;
+	fSmooth = true;
+	fAverageCost = 0;
+	fSettling = kSettleFrames;
+}
+
+
+bool
+FLGovernor::FrameDone(bigtime_t cost)
+{
+	// A moving average of the cost, weighing the last frame 1/8
+	if (fAverageCost == 0)
+		fAverageCost = cost;
+	else
+		fAverageCost += (cost - fAverageCost) / 8;
+	
+	if (fSettling > 0) {
+		fSettling--;
+		return false;
+	}
+	
+	if (fAverageCost > fBudget) {
+		// Drop leaves, about as many as it takes to get
+		// within the budget, but at least an eighth and
+		// at most half of them. Then drop the smoothing.
+		if (fAmount > fMinAmount) {
+			int32 amount = (int32)(fAmount * fBudget / fAverageCost);
+			if (amount < fAmount / 2)
+				amount = fAmount / 2;
+			if (amount > fAmount - (fAmount - fMinAmount + 7) / 8)
+				amount = fAmount - (fAmount - fMinAmount + 7) / 8;
+			fAmount = amount > fMinAmount ? amount : fMinAmount;
+		} else if (fSmooth)
+			fSmooth = false;
+		else
+			return false;
+		
+		fDecreases++;
+	} else if (fAverageCost * 100 < fBudget * kHeadroom) {
+		// Bring the smoothing back, then add
+		// leaves a little at a time
+		if (!fSmooth)
+			fSmooth = true;
+		else if (fAmount < fMaxAmount) {
+			int32 more = fMaxAmount / 32 > 0 ? fMaxAmount / 32 : 1;
+			fAmount = fAmount + more < fMaxAmount
+				? fAmount + more : fMaxAmount;
+		} else
+			return false;
+		
+		fIncreases++;
+	} else
+		return false;
+	
+	// Start the average over, so it only
+	// shows how the change turned out
+	fAverageCost = 0;
+	fSettling = kSettleFrames;
+	return true;
+}
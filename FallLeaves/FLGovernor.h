@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLGOVERNOR_H_
+#define _FLGOVERNOR_H_
+
+
+#include "FLTypes.h"
+
+
+/*	Keeps the time it takes to draw a frame within a budget, by
+	trading away leaves and quality.
+
+	When the frames take too long, there are fewer leaves, down to
+	a floor, and after that they are drawn without smoothing. When
+	there is plenty of time left over, the smoothing comes back
+	first, then the leaves, up to the amount that was asked for.
+	Every change is given time to show in the frame times before
+	the next one.
+*/
+class FLGovernor
+{
+public:
+					FLGovernor(bigtime_t budget);
+	
+	void			Reset(int32 amount, int32 minAmount);
+						// Start over at "amount" leaves with smoothing,
+						// never going below "minAmount"
+	
+	bool			FrameDone(bigtime_t cost);
+						// Returns true if Amount() or Smooth() changed
+	
+	int32			Amount() const { return fAmount; };
+	bool			Smooth() const { return fSmooth; };
+	
+	bigtime_t		Budget() const { return fBudget; };
+	bigtime_t		AverageCost() const { return fAverageCost; };
+	int64			Decreases() const { return fDecreases; };
+	int64			Increases() const { return fIncreases; };
+	
+private:
+	bigtime_t		fBudget;
+	bigtime_t		fAverageCost;
+	int32			fSettling;
+						// Frames to wait before the next change
+	
+	int32			fMaxAmount;
+	int32			fMinAmount;
+	int32			fAmount;
+	bool			fSmooth;
+	
+	int64			fDecreases;
+	int64			fIncreases;
+};
+
+
+#endif
@@ -6,47 +6,121 @@
 
 #include "FLLeaf.h"
 
+#include <math.h>
 
-Leaf::Leaf(BBitmap* bitmap)
+#include "FLBuffer.h"
+#include "FLSpriteSet.h"
+
+
+Leaf::Leaf()
 	:
-	fBitmap(bitmap),
-	fPos(BPoint()),
-	fZ(0),
-	fSpeed(0),
-	fFudge(0),
-	fBoundary(BRect()),
-	fDead(false)
+	fPool(NULL),
+	fIndex(0)
 {
-	// Empty
+	Reset();
 }
 
 
 void
-Leaf::Update(int32 ticksPerSecond)
+Leaf::Reset()
 {
-	if (fDead)
-		return;
-	
-	fFudge += fSpeed;
+	fSprites = NULL;
+	fSize = 0;
+	fZ = 0;
+	fLeft = fTop = fRight = fBottom = 0;
+	fPrevious = NULL;
+	fNext = NULL;
 	
-	while (fFudge >= ticksPerSecond) {
-		fPos.y++;
-		fFudge -= ticksPerSecond;
+	if (fPool != NULL) {
+		SetPos(0, 0);
+		SetSpeed(0);
+		SetSway(0, 0, 0);
+		fPool->SpeedX()[fIndex] = 0;
 	}
+}
+
+
+bool
+Leaf::Draw(FLBuffer* buffer, bool smooth)
+{
+	// Pick the frame turned closest to the tilt
+	int32 frames = fSprites->CountFrames();
+	int32 frame = (int32)((Tilt() + 1) * 0.5f * (frames - 1) + 0.5f);
+	if (frame < 0)
+		frame = 0;
+	else if (frame >= frames)
+		frame = frames - 1;
 	
-	// If the leaf is out of boundary...
-	if (fPos.x < fBoundary.left || fPos.x > fBoundary.right
-			|| fPos.y < fBoundary.top || fPos.y > fBoundary.bottom) {
-		fDead = true; // ...then it's dead
+	// The images may still be being built,
+	// the upright frame is always done first
+	if (!fSprites->IsReady(frame)) {
+		frame = fSprites->Upright();
+		if (!fSprites->IsReady(frame))
+			return false;
 	}
+	
+	buffer->DrawSprite(fSprites->LevelFor(frame, fSize),
+		(int32)floorf(fPool->DrawX(fIndex)),
+		(int32)floorf(fPool->DrawY(fIndex)), fSize, smooth);
+	
+	return true;
+}
+
+
+void
+Leaf::SetSprites(const FLSpriteSet* sprites, int32 size)
+{
+	fSprites = sprites;
+	fSize = size;
+	fPool->Size()[fIndex] = size;
+}
+
+
+void
+Leaf::SetPos(float x, float y)
+{
+	fPool->X()[fIndex] = fPool->PreviousX()[fIndex] = x;
+	fPool->Y()[fIndex] = fPool->PreviousY()[fIndex] = y;
 }
 
 
 void
-Leaf::Draw(BView* view)
+Leaf::SetSpeed(float speed)
 {
-	if (fDead)
-		return;
+	fPool->FallSpeed()[fIndex] = speed;
+	fPool->SpeedY()[fIndex] = speed;
+}
+
+
+void
+Leaf::SetSway(float amount, float phase, float frequency)
+{
+	float omega = 2 * (float)M_PI * frequency;
 	
-	view->DrawBitmap(fBitmap, fPos);
+	// Start somewhere along the swing, moving
+	// at the right speed for that point
+	fPool->Tilt()[fIndex] = amount * sinf(phase);
+	fPool->TiltSpeed()[fIndex] = amount * omega * cosf(phase);
+	fPool->Sway()[fIndex] = omega * omega;
+}
+
+
+bool
+Leaf::IsDead() const
+{
+	float x = X();
+	float y = Y();
+	
+	// If the leaf is out of boundary, then it's dead
+	return x < fLeft || x > fRight || y < fTop || y > fBottom;
+}
+
+
+void
+Leaf::SetBoundary(int32 left, int32 top, int32 right, int32 bottom)
+{
+	fLeft = left;
+	fTop = top;
+	fRight = right;
+	fBottom = bottom;
 }
@@ -6,49 +6,87 @@
 #define _FLLEAF_H_
 
 
-#include <Bitmap.h>
-#include <View.h>
+#include "FLPool.h"
+#include "FLTypes.h"
 
 
+class FLBuffer;
+class FLSpriteSet;
+
+
+/*	Where a leaf is and how fast it falls lives in the arrays
+	of its pool, at Index(). The leaf itself keeps the rest.
+*/
 class Leaf
 {
 public:
-					Leaf(BBitmap* bitmap);
-					~Leaf() { delete fBitmap; };
+					Leaf();
+	
+	void			Reset();
+						// Make the leaf as good as new
+	
+	int32			Index() const { return fIndex; };
+						// Where the leaf is in the pool arrays
 	
-	void			Update(int32 ticksPerSecond);
-	void			Draw(BView* view);
+	void			SetSprites(const FLSpriteSet* sprites, int32 size);
+						// The leaf is drawn size by size pixels,
+						// from the closest level of the set. It
+						// doesn't own the set.
+	const FLSpriteSet*	Sprites() const { return fSprites; };
 	
-	void			SetPos(BPoint pos) { fPos = pos; };
-	BPoint			Pos() { return fPos; };
+	bool			Draw(FLBuffer* buffer, bool smooth = true);
+						// Draw the leaf where the pool's last
+						// Classify() put it, from the frame
+						// closest to its tilt that is ready.
+						// Returns false if there is none yet.
+	
+	void			SetPos(float x, float y);
+	float			X() const { return fPool->X()[fIndex]; };
+	float			Y() const { return fPool->Y()[fIndex]; };
+						// The position on the screen
 	
 	void			SetZ(int32 z) { fZ = z; };
 	int32			Z() const { return fZ; };
 						// The Z axis controls how far "in"
 						// to the screen the leaf is
 	
-	void			SetSpeed(int32 speed) { fSpeed = speed; };
+	void			SetSpeed(float speed);
+						// How fast the leaf falls in still air,
+						// in pixels per second
+	void			SetSway(float amount, float phase, float frequency);
+						// The leaf tilts back and forth, "amount"
+						// of the way to the most it can turn,
+						// "frequency" times a second
+	float			Tilt() const { return fPool->Tilt()[fIndex]; };
 	
-	int32			Width() { return fBitmap->Bounds().IntegerWidth(); };
-	int32			Height() { return fBitmap->Bounds().IntegerHeight(); };
+	int32			Width() const { return fSize; };
+	int32			Height() const { return fSize; };
 	
-	bool			IsDead() { return fDead; };
-	void			SetBoundary(BRect boundary) { fBoundary = boundary; };
+	bool			IsDead() const;
+	void			SetBoundary(int32 left, int32 top, int32 right,
+						int32 bottom);
 						// A leaf is dead if it moves outside the boundary
 	
 private:
-	BBitmap			*fBitmap;
+	friend class FLLeafPool;
+	FLLeafPool*		fPool;
+	int32			fIndex;
+	
+	const FLSpriteSet*	fSprites;
+	int32			fSize;
 	
-	BPoint			fPos;
-						// The position on the screen
 	int32			fZ;
 	
-	int32			fSpeed;
-						// In pixels per second
-	int32			fFudge;
+	int32			fLeft;
+	int32			fTop;
+	int32			fRight;
+	int32			fBottom;
 	
-	BRect			fBoundary;
-	bool			fDead;
+	friend class FLDepthList;
+	Leaf*			fPrevious;
+	Leaf*			fNext;
+						// The neighbours at the same Z depth,
+						// or the next free leaf in the pool
 };
 
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLPacer.h"
+
+#include "Snapshot.h"
+
+
+// Never simulate more than this many steps for one frame. After a long
+// stall the leaves would otherwise jump, and catching up would make the
+// next frame late too.
+static const int32 kMaxStepsPerFrame = 25;
+
+
+FLPacer::FLPacer(bigtime_t step, bigtime_t minTick, bigtime_t maxTick)
+	:
+	fStep(step),
+	fMinTick(minTick),
+	fMaxTick(maxTick),
+	fTickSize(minTick),
+	fLastFrame(-1),
+	fAccumulator(0),
+	fAverageCost(0),
+	fFrames(0),
+	fSteps(0),
+	fOverruns(0),
+	fDroppedFrames(0)
+{
+	// Empty
+}
+
+
+int32
+FLPacer::Advance(bigtime_t now)
+{
+	fFrames++;
+	
+	if (fLastFrame < 0) {
+		fLastFrame = now;
+		return 0;
+	}
+	
+	bigtime_t elapsed = now - fLastFrame;
+	fLastFrame = now;
+	
+	// Count the ticks we should have drawn but couldn't
+	if (elapsed > fTickSize + fTickSize / 2)
+		fDroppedFrames += elapsed / fTickSize - 1;
+	
+	fAccumulator += elapsed;
+	
+	int32 steps = fAccumulator / fStep;
+	if (steps > kMaxStepsPerFrame) {
+		steps = kMaxStepsPerFrame;
+		fAccumulator = 0;
+	} else
+		fAccumulator -= steps * fStep;
+	
+	fSteps += steps;
+	
+	return steps;
+}
+
+
+float
+FLPacer::Alpha() const
+{
+	return (float)fAccumulator / fStep;
+}
+
+
+void
+FLPacer::FrameDone(bigtime_t cost)
+{
+	if (cost > fTickSize)
+		fOverruns++;
+	
+	// A moving average of the cost, weighing the last frame 1/8
+	if (fAverageCost == 0)
+		fAverageCost = cost;
+	else
+		fAverageCost += (cost - fAverageCost) / 8;
+	
+	// Leave a quarter of a tick of headroom, and only change the
+	// tick size when it is more than 10% off, so it doesn't jitter
+	bigtime_t tick = fAverageCost + fAverageCost / 4;
+	if (tick < fMinTick)
+		tick = fMinTick;
+	if (tick > fMaxTick)
+		tick = fMaxTick;
+	
+	bigtime_t difference = tick > fTickSize
+		? tick - fTickSize : fTickSize - tick;
+	if (difference * 10 > fTickSize)
+		fTickSize = tick;
+}
+
+
+void
+FLPacer::WriteSnapshot(Snapshot& snapshot) const
+{
+	snapshot.Write(fTickSize);
+	snapshot.Write(fLastFrame);
+	snapshot.Write(fAccumulator);
+	snapshot.Write(fAverageCost);
+}
+
+
+void
+FLPacer::ReadSnapshot(Snapshot& snapshot)
+{
+	snapshot.Read(&fTickSize);
+	snapshot.Read(&fLastFrame);
+	snapshot.Read(&fAccumulator);
+	snapshot.Read(&fAverageCost);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLPACER_H_
+#define _FLPACER_H_
+
+
+#include "FLTypes.h"
+
+
+class Snapshot;
+
+
+/*	Decouples the simulation from the drawing.
+
+	The leaves always move in fixed steps of simulated time, and each
+	frame runs as many steps as the real time since the last frame
+	covers. What is left over is handed out as a fraction of a step,
+	so the leaves can be drawn in between their last two positions.
+	That way the leaves fall at the same speed whether the screen is
+	drawn 100 times per second or 20.
+
+	The pacer also watches how long drawing a frame takes and suggests
+	a tick size the display can actually keep up with.
+*/
+class FLPacer
+{
+public:
+					FLPacer(bigtime_t step, bigtime_t minTick,
+						bigtime_t maxTick);
+	
+	int32			Advance(bigtime_t now);
+						// Returns the number of steps to simulate
+						// for a frame shown at "now", a monotonic
+						// time in microseconds
+	float			Alpha() const;
+						// How far into the next step the frame is,
+						// from 0 to 1
+	
+	void			FrameDone(bigtime_t cost);
+						// Report how long the frame took to draw
+	
+	void			WriteSnapshot(Snapshot& snapshot) const;
+	void			ReadSnapshot(Snapshot& snapshot);
+						// When the last frame was shown, and how
+						// far into the next step it was
+	bigtime_t		LastFrame() const { return fLastFrame; };
+	
+	bigtime_t		Step() const { return fStep; };
+	bigtime_t		TickSize() const { return fTickSize; };
+						// How often a frame should be drawn
+	
+	int64			Frames() const { return fFrames; };
+	int64			Steps() const { return fSteps; };
+	int64			Overruns() const { return fOverruns; };
+						// Frames that took longer than a tick
+	int64			DroppedFrames() const { return fDroppedFrames; };
+						// Ticks that went by without a frame
+	
+private:
+	bigtime_t		fStep;
+	bigtime_t		fMinTick;
+	bigtime_t		fMaxTick;
+	bigtime_t		fTickSize;
+	
+	bigtime_t		fLastFrame;
+	bigtime_t		fAccumulator;
+	bigtime_t		fAverageCost;
+	
+	int64			fFrames;
+	int64			fSteps;
+	int64			fOverruns;
+	int64			fDroppedFrames;
+};
+
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLPool.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "FLLeaf.h"
+#include "FLWind.h"
+
+
+static float*
+new_floats(int32 count)
+{
+	float* floats = new float[count];
+	for (int32 i = 0; i < count; i++)
+		floats[i] = 0;
+	return floats;
+}
+
+
+FLLeafPool::FLLeafPool(int32 capacity)
+	:
+	fLeaves(NULL),
+	fCapacity((capacity + kLeafBatch - 1) / kLeafBatch * kLeafBatch),
+	fFree(NULL),
+	fFreeCount(0),
+	fUsedEnd(0)
+{
+	fLeaves = new Leaf[fCapacity];
+	
+	fX = new_floats(fCapacity);
+	fY = new_floats(fCapacity);
+	fPreviousX = new_floats(fCapacity);
+	fPreviousY = new_floats(fCapacity);
+	fSpeedX = new_floats(fCapacity);
+	fSpeedY = new_floats(fCapacity);
+	fFallSpeed = new_floats(fCapacity);
+	fTilt = new_floats(fCapacity);
+	fTiltSpeed = new_floats(fCapacity);
+	fSway = new_floats(fCapacity);
+	fSize = new_floats(fCapacity);
+	fWind = new_floats(fCapacity);
+	fDrawX = new_floats(fCapacity);
+	fDrawY = new_floats(fCapacity);
+	fVisible = new uint8[fCapacity];
+	
+	for (int32 i = fCapacity - 1; i >= 0; i--) {
+		fLeaves[i].fPool = this;
+		fLeaves[i].fIndex = i;
+		Release(&fLeaves[i]);
+	}
+}
+
+
+FLLeafPool::~FLLeafPool()
+{
+	delete[] fLeaves;
+	
+	delete[] fX;
+	delete[] fY;
+	delete[] fPreviousX;
+	delete[] fPreviousY;
+	delete[] fSpeedX;
+	delete[] fSpeedY;
+	delete[] fFallSpeed;
+	delete[] fTilt;
+	delete[] fTiltSpeed;
+	delete[] fSway;
+	delete[] fSize;
+	delete[] fWind;
+	delete[] fDrawX;
+	delete[] fDrawY;
+	delete[] fVisible;
+}
+
+
+Leaf*
+FLLeafPool::Acquire()
+{
+	Leaf* leaf = fFree;
+	if (leaf == NULL)
+		return NULL;
+	
+	// A free leaf isn't in a depth list,
+	// so its link is ours to use
+	fFree = leaf->fNext;
+	fFreeCount--;
+	
+	int32 end = (leaf->Index() + kLeafBatch) / kLeafBatch * kLeafBatch;
+	if (end > fUsedEnd)
+		fUsedEnd = end;
+	
+	leaf->Reset();
+	
+	return leaf;
+}
+
+
+void
+FLLeafPool::Release(Leaf* leaf)
+{
+	// A free leaf stands still and is never visible
+	int32 index = leaf->Index();
+	fX[index] = fY[index] = 0;
+	fPreviousX[index] = fPreviousY[index] = 0;
+	fSpeedX[index] = fSpeedY[index] = 0;
+	fFallSpeed[index] = 0;
+	fTilt[index] = fTiltSpeed[index] = 0;
+	fSway[index] = 0;
+	fSize[index] = 0;
+	fVisible[index] = 0;
+	
+	leaf->fNext = fFree;
+	fFree = leaf;
+	fFreeCount++;
+}
+
+
+/*	One semi-implicit Euler step: the speeds are updated first,
+	and the new speeds move the leaves. That keeps the swaying
+	steady, where a plain Euler step would swing wider and wider.
+*/
+void
+FLLeafPool::Integrate(float seconds, const FLWind& wind)
+{
+	// Looking up the wind can't be done four at a time
+	for (int32 i = 0; i < fUsedEnd; i++)
+		fWind[i] = wind.Sample(fX[i], fY[i]);
+	
+#ifdef __SSE2__
+	__m128 dt = _mm_set1_ps(seconds);
+	__m128 drag = _mm_set1_ps(kLeafDrag);
+	__m128 glide = _mm_set1_ps(kLeafGlide);
+	
+	for (int32 i = 0; i < fUsedEnd; i += kLeafBatch) {
+		__m128 fall = _mm_loadu_ps(fFallSpeed + i);
+		__m128 tilt = _mm_loadu_ps(fTilt + i);
+		__m128 tiltSpeed = _mm_loadu_ps(fTiltSpeed + i);
+		__m128 speedX = _mm_loadu_ps(fSpeedX + i);
+		__m128 speedY = _mm_loadu_ps(fSpeedY + i);
+		
+		// Pulled along by the wind, and sideways by the tilt
+		__m128 accelX = _mm_add_ps(
+			_mm_mul_ps(drag, _mm_sub_ps(_mm_loadu_ps(fWind + i), speedX)),
+			_mm_mul_ps(glide, _mm_mul_ps(tilt, fall)));
+		__m128 accelY = _mm_mul_ps(drag, _mm_sub_ps(fall, speedY));
+		
+		speedX = _mm_add_ps(speedX, _mm_mul_ps(accelX, dt));
+		speedY = _mm_add_ps(speedY, _mm_mul_ps(accelY, dt));
+		
+		// The tilt swings back and forth around level
+		tiltSpeed = _mm_sub_ps(tiltSpeed,
+			_mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(fSway + i), tilt), dt));
+		tilt = _mm_add_ps(tilt, _mm_mul_ps(tiltSpeed, dt));
+		
+		__m128 x = _mm_loadu_ps(fX + i);
+		__m128 y = _mm_loadu_ps(fY + i);
+		_mm_storeu_ps(fPreviousX + i, x);
+		_mm_storeu_ps(fPreviousY + i, y);
+		_mm_storeu_ps(fX + i, _mm_add_ps(x, _mm_mul_ps(speedX, dt)));
+		_mm_storeu_ps(fY + i, _mm_add_ps(y, _mm_mul_ps(speedY, dt)));
+		
+		_mm_storeu_ps(fSpeedX + i, speedX);
+		_mm_storeu_ps(fSpeedY + i, speedY);
+		_mm_storeu_ps(fTilt + i, tilt);
+		_mm_storeu_ps(fTiltSpeed + i, tiltSpeed);
+	}
+#else
+	for (int32 i = 0; i < fUsedEnd; i++) {
+		// Pulled along by the wind, and sideways by the tilt
+		fSpeedX[i] += (kLeafDrag * (fWind[i] - fSpeedX[i])
+			+ kLeafGlide * fTilt[i] * fFallSpeed[i]) * seconds;
+		fSpeedY[i] += kLeafDrag * (fFallSpeed[i] - fSpeedY[i]) * seconds;
+		
+		// The tilt swings back and forth around level
+		fTiltSpeed[i] -= fSway[i] * fTilt[i] * seconds;
+		fTilt[i] += fTiltSpeed[i] * seconds;
+		
+		fPreviousX[i] = fX[i];
+		fPreviousY[i] = fY[i];
+		fX[i] += fSpeedX[i] * seconds;
+		fY[i] += fSpeedY[i] * seconds;
+	}
+#endif
+}
+
+
+int32
+FLLeafPool::Classify(float alpha, int32 width, int32 height)
+{
+	int32 visible = 0;
+	
+#ifdef __SSE2__
+	__m128 a = _mm_set1_ps(alpha);
+	__m128 zero = _mm_setzero_ps();
+	__m128 right = _mm_set1_ps((float)width);
+	__m128 bottom = _mm_set1_ps((float)height);
+	
+	for (int32 i = 0; i < fUsedEnd; i += kLeafBatch) {
+		__m128 previousX = _mm_loadu_ps(fPreviousX + i);
+		__m128 previousY = _mm_loadu_ps(fPreviousY + i);
+		__m128 x = _mm_add_ps(previousX,
+			_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(fX + i), previousX), a));
+		__m128 y = _mm_add_ps(previousY,
+			_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(fY + i), previousY), a));
+		__m128 size = _mm_loadu_ps(fSize + i);
+		
+		_mm_storeu_ps(fDrawX + i, x);
+		_mm_storeu_ps(fDrawY + i, y);
+		
+		// A leaf is visible if any part of it is on the screen
+		__m128 inside = _mm_and_ps(
+			_mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(x, size), zero),
+				_mm_cmplt_ps(x, right)),
+			_mm_and_ps(_mm_cmpgt_ps(_mm_add_ps(y, size), zero),
+				_mm_cmplt_ps(y, bottom)));
+		
+		int mask = _mm_movemask_ps(inside);
+		for (int32 j = 0; j < kLeafBatch; j++) {
+			fVisible[i + j] = (mask >> j) & 1;
+			visible += (mask >> j) & 1;
+		}
+	}
+#else
+	for (int32 i = 0; i < fUsedEnd; i++) {
+		float x = fPreviousX[i] + (fX[i] - fPreviousX[i]) * alpha;
+		float y = fPreviousY[i] + (fY[i] - fPreviousY[i]) * alpha;
+		
+		fDrawX[i] = x;
+		fDrawY[i] = y;
+		
+		// A leaf is visible if any part of it is on the screen
+		fVisible[i] = (x + fSize[i] > 0) & (x < width)
+			& (y + fSize[i] > 0) & (y < height);
+		visible += fVisible[i];
+	}
+#endif
+	
+	return visible;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLPOOL_H_
+#define _FLPOOL_H_
+
+
+#include "FLTypes.h"
+
+
+class FLWind;
+class Leaf;
+
+
+// The leaf arrays are a multiple of this long,
+// so they can be walked four leaves at a time
+const int32 kLeafBatch = 4;
+
+// How quickly a leaf is carried along to the speed of the
+// wind, and back to its own falling speed, per second
+const float kLeafDrag = 1.5f;
+
+// How much a tilted leaf glides towards its lower edge, as
+// a part of its falling speed, per second
+const float kLeafGlide = 1.2f;
+
+
+/*	A fixed number of leaf records, allocated once.
+	A dead leaf goes back on the free list and is
+	handed out again for the next new leaf.
+
+	Where the leaves are and how they move is kept in arrays with
+	one entry per leaf (Leaf::Index()), instead of in the leaves
+	themselves. That way the passes that touch every leaf, like
+	moving them or finding the ones on the screen, run over a few
+	tightly packed arrays of floats. They only run up to the last
+	leaf that was ever handed out, as the pool is often much bigger
+	than the number of leaves falling.
+*/
+class FLLeafPool
+{
+public:
+					FLLeafPool(int32 capacity);
+					~FLLeafPool();
+	
+	Leaf*			Acquire();
+						// Returns NULL if every leaf is in use
+	void			Release(Leaf* leaf);
+	
+	int32			Capacity() const { return fCapacity; };
+	int32			CountFree() const { return fFreeCount; };
+	
+	float*			X() const { return fX; };
+	float*			Y() const { return fY; };
+	float*			PreviousX() const { return fPreviousX; };
+	float*			PreviousY() const { return fPreviousY; };
+						// Where the leaves were one step ago
+	float*			SpeedX() const { return fSpeedX; };
+	float*			SpeedY() const { return fSpeedY; };
+						// In pixels per second
+	float*			FallSpeed() const { return fFallSpeed; };
+						// How fast the leaves fall in still air
+	float*			Tilt() const { return fTilt; };
+						// From -1 to 1, the angle of the leaf as
+						// a part of the most it can turn
+	float*			TiltSpeed() const { return fTiltSpeed; };
+	float*			Sway() const { return fSway; };
+						// How strongly a tilted leaf swings back,
+						// the square of its angular frequency
+	float*			Size() const { return fSize; };
+						// Zero for the free leaves
+	
+	void			Integrate(float seconds, const FLWind& wind);
+						// Move every leaf through the wind
+	
+	int32			Classify(float alpha, int32 width, int32 height);
+						// Find where each leaf is drawn, "alpha" of
+						// the way into the last step, and whether
+						// that is on a width by height screen.
+						// Returns the number of visible leaves.
+	float			DrawX(int32 index) const
+						{ return fDrawX[index]; };
+	float			DrawY(int32 index) const
+						{ return fDrawY[index]; };
+	bool			IsVisible(int32 index) const
+						{ return fVisible[index] != 0; };
+	void			SetVisible(int32 index, bool visible)
+						{ fVisible[index] = visible ? 1 : 0; };
+						// Only to put back a saved leaf, the
+						// next Classify() finds it again
+	
+private:
+	Leaf*			fLeaves;
+	int32			fCapacity;
+	
+	Leaf*			fFree;
+	int32			fFreeCount;
+	int32			fUsedEnd;
+						// Every leaf handed out so far is below
+						// this, a multiple of kLeafBatch
+	
+	float*			fX;
+	float*			fY;
+	float*			fPreviousX;
+	float*			fPreviousY;
+	float*			fSpeedX;
+	float*			fSpeedY;
+	float*			fFallSpeed;
+	float*			fTilt;
+	float*			fTiltSpeed;
+	float*			fSway;
+	float*			fSize;
+	
+	float*			fWind;
+						// The wind at each leaf, for this step
+	
+	float*			fDrawX;
+	float*			fDrawY;
+	uint8*			fVisible;
+};
+
+
+#endif
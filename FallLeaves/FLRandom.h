@@ -0,0 +1,22 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLRANDOM_H_
+#define _FLRANDOM_H_
+
+
+#include "Random.h"
+
+
+/*	Every FLField has its own random number generator, so
+	the same seed always gives the same falling leaves.
+*/
+class FLRandom : public Random
+{
+public:
+					FLRandom(uint32 seed = 1) : Random(seed) {};
+};
+
+
+#endif
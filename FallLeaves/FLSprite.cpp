@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLSprite.h"
+
+
+FLSprite::FLSprite(int32 width, int32 height)
+	:
+	fBits(new uint32[width * height]),
+	fWidth(width),
+	fHeight(height),
+	fOwnsBits(true)
+{
+	for (int32 i = 0; i < width * height; i++)
+		fBits[i] = 0;
+}
+
+
+FLSprite::FLSprite(uint32* bits, int32 width, int32 height)
+	:
+	fBits(bits),
+	fWidth(width),
+	fHeight(height),
+	fOwnsBits(false)
+{
+}
+
+
+FLSprite::~FLSprite()
+{
+	if (fOwnsBits)
+		delete[] fBits;
+}
+
+
+void
+FLSprite::SetBits(const uint8* bits, int32 bytesPerRow)
+{
+	for (int32 y = 0; y < fHeight; y++) {
+		const uint32* source = (const uint32*)(bits + y * bytesPerRow);
+		uint32* dest = fBits + y * fWidth;
+		
+		for (int32 x = 0; x < fWidth; x++)
+			dest[x] = source[x];
+	}
+	
+	Premultiply();
+}
+
+
+void
+FLSprite::Premultiply()
+{
+	for (int32 i = 0; i < fWidth * fHeight; i++) {
+		uint32 color = fBits[i];
+		uint32 alpha = color >> 24;
+		
+		// Multiply the red and blue, then the green, by the alpha
+		uint32 rb = (color & 0x00ff00ff) * alpha + 0x00800080;
+		rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+		uint32 g = (color & 0x0000ff00) * alpha + 0x00008000;
+		g = ((g + ((g >> 8) & 0x0000ff00)) >> 8) & 0x0000ff00;
+		
+		fBits[i] = (alpha << 24) | rb | g;
+	}
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLSPRITE_H_
+#define _FLSPRITE_H_
+
+
+#include "FLTypes.h"
+
+
+/*	The image of a leaf, in the same layout as a B_RGBA32 bitmap
+	(one uint32 per pixel, 0xAARRGGBB), except that the color
+	is premultiplied by the alpha. That makes drawing a leaf
+	over the background a single multiply and add.
+*/
+class FLSprite
+{
+public:
+					FLSprite(int32 width, int32 height);
+					FLSprite(uint32* bits, int32 width, int32 height);
+						// Use someone else's pixels, which
+						// must outlive the sprite
+					~FLSprite();
+	
+	uint32*			Bits() const { return fBits; };
+	int32			Width() const { return fWidth; };
+	int32			Height() const { return fHeight; };
+	
+	void			SetBits(const uint8* bits, int32 bytesPerRow);
+						// Copy straight (not premultiplied)
+						// B_RGBA32 data into the sprite
+	void			Premultiply();
+						// Turn straight data that was written
+						// to Bits() into premultiplied data
+	
+private:
+	uint32*			fBits;
+	int32			fWidth;
+	int32			fHeight;
+	bool			fOwnsBits;
+};
+
+
+#endif
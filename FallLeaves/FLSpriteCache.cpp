@@ -0,0 +1,325 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLSpriteCache.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FLSpriteSet.h"
+
+
+static const uint32 kSpriteCacheMagic = 'FLsc';
+
+// Every set starts on a cache line
+static const uint64 kDataAlignment = 64;
+
+static const int32 kMaxEntries = 64;
+
+
+struct FLSpriteCache::header {
+	uint32			magic;
+	uint32			version;
+	uint32			entryCount;
+	uint32			reserved;
+	uint64			fileSize;
+	uint64			tableChecksum;
+};
+
+
+struct FLSpriteCache::entry {
+	key				setKey;
+	uint64			checksum;
+						// Of the pixels
+	uint64			offset;
+	uint64			bytes;
+};
+
+
+static bool
+keys_equal(const FLSpriteCache::key& a, const FLSpriteCache::key& b)
+{
+	return a.hash == b.hash && a.size == b.size && a.frames == b.frames
+		&& a.angle == b.angle && a.colorSpace == b.colorSpace;
+}
+
+
+static uint64
+align(uint64 offset)
+{
+	return (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+}
+
+
+static bool
+write_fully(int fd, const void* data, size_t size)
+{
+	const uint8* bytes = (const uint8*)data;
+	while (size > 0) {
+		ssize_t written = write(fd, bytes, size);
+		if (written <= 0)
+			return false;
+		bytes += written;
+		size -= written;
+	}
+	
+	return true;
+}
+
+
+FLSpriteCache::FLSpriteCache()
+	:
+	fMapping(NULL),
+	fMappingSize(0),
+	fEntries(NULL),
+	fEntryCount(0)
+{
+}
+
+
+FLSpriteCache::~FLSpriteCache()
+{
+	Close();
+}
+
+
+status_t
+FLSpriteCache::Open(const char* path)
+{
+	Close();
+	
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return B_ERROR;
+	
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(header)) {
+		close(fd);
+		return B_ERROR;
+	}
+	
+	void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return B_ERROR;
+	
+	fMapping = mapping;
+	fMappingSize = info.st_size;
+	
+	// Check everything before trusting any of it
+	const header* fileHeader = (const header*)fMapping;
+	if (fileHeader->magic != kSpriteCacheMagic
+		|| fileHeader->version != kSpriteCacheVersion
+		|| fileHeader->fileSize != fMappingSize
+		|| fileHeader->entryCount > (uint32)kMaxEntries
+		|| sizeof(header) + fileHeader->entryCount * sizeof(entry)
+			> fMappingSize) {
+		Close();
+		return B_BAD_VALUE;
+	}
+	
+	const entry* entries = (const entry*)(fileHeader + 1);
+	int32 count = fileHeader->entryCount;
+	
+	if (_TableChecksum(entries, count) != fileHeader->tableChecksum) {
+		Close();
+		return B_BAD_VALUE;
+	}
+	
+	for (int32 i = 0; i < count; i++) {
+		const entry& set = entries[i];
+		if (set.setKey.size <= 0 || set.setKey.size > kMaxSpriteSize
+			|| set.setKey.frames <= 0 || set.setKey.frames > 31
+			|| set.bytes != FLSpriteSet::BytesFor(set.setKey.size,
+				set.setKey.frames)
+			|| set.offset % kDataAlignment != 0
+			|| set.offset > fMappingSize
+			|| set.bytes > fMappingSize - set.offset) {
+			Close();
+			return B_BAD_VALUE;
+		}
+	}
+	
+	fEntries = entries;
+	fEntryCount = count;
+	
+	return B_OK;
+}
+
+
+void
+FLSpriteCache::Close()
+{
+	if (fMapping != NULL)
+		munmap(fMapping, fMappingSize);
+	
+	fMapping = NULL;
+	fMappingSize = 0;
+	fEntries = NULL;
+	fEntryCount = 0;
+}
+
+
+const uint32*
+FLSpriteCache::Find(const key& wanted) const
+{
+	for (int32 i = 0; i < fEntryCount; i++) {
+		if (!keys_equal(fEntries[i].setKey, wanted))
+			continue;
+		
+		if (!_IsIntact(fEntries[i]))
+			return NULL;
+		return (const uint32*)((const uint8*)fMapping + fEntries[i].offset);
+	}
+	
+	return NULL;
+}
+
+
+status_t
+FLSpriteCache::Write(const char* path, const key* keys,
+	FLSpriteSet* const* sets, int32 count)
+{
+	if (count > kMaxEntries)
+		return B_BAD_VALUE;
+	
+	entry entries[kMaxEntries];
+	const void* data[kMaxEntries];
+	memset(entries, 0, sizeof(entries));
+	
+	int32 total = 0;
+	for (int32 i = 0; i < count; i++) {
+		entries[total].setKey = keys[i];
+		entries[total].bytes = sets[i]->Bytes();
+		entries[total].checksum = _DataChecksum(sets[i]->Bits(),
+			entries[total].bytes);
+		data[total++] = sets[i]->Bits();
+	}
+	
+	// Keep the sets already in the file behind the new ones, as many as
+	// fit, unless they are replaced or damaged. The file is mapped again
+	// here, as another saver could have written it since it was opened.
+	FLSpriteCache old;
+	old.Open(path);
+	for (int32 i = 0; i < old.fEntryCount && total < kMaxEntries; i++) {
+		const entry& set = old.fEntries[i];
+		bool replaced = false;
+		for (int32 j = 0; j < count && !replaced; j++)
+			replaced = keys_equal(set.setKey, keys[j]);
+		if (replaced || !old._IsIntact(set))
+			continue;
+		
+		entries[total] = set;
+		data[total++] = (const uint8*)old.fMapping + set.offset;
+	}
+	
+	header fileHeader;
+	memset(&fileHeader, 0, sizeof(fileHeader));
+	fileHeader.magic = kSpriteCacheMagic;
+	fileHeader.version = kSpriteCacheVersion;
+	fileHeader.entryCount = total;
+	
+	uint64 offset = align(sizeof(header) + total * sizeof(entry));
+	for (int32 i = 0; i < total; i++) {
+		entries[i].offset = offset;
+		offset = align(offset + entries[i].bytes);
+	}
+	
+	fileHeader.fileSize = offset;
+	fileHeader.tableChecksum = _TableChecksum(entries, total);
+	
+	// A name of its own, so that two savers never write the same file
+	char temporary[1024];
+	if (snprintf(temporary, sizeof(temporary), "%s.XXXXXX", path)
+			>= (int)sizeof(temporary))
+		return B_BAD_VALUE;
+	
+	int fd = mkstemp(temporary);
+	if (fd < 0)
+		return B_ERROR;
+	
+	static const uint8 kPadding[kDataAlignment] = { 0 };
+	
+	bool ok = fchmod(fd, 0644) == 0
+		&& write_fully(fd, &fileHeader, sizeof(header))
+		&& write_fully(fd, entries, total * sizeof(entry));
+	
+	uint64 written = sizeof(header) + total * sizeof(entry);
+	for (int32 i = 0; ok && i < total; i++) {
+		ok = write_fully(fd, kPadding, entries[i].offset - written)
+			&& write_fully(fd, data[i], entries[i].bytes);
+		written = entries[i].offset + entries[i].bytes;
+	}
+	if (ok)
+		ok = write_fully(fd, kPadding, fileHeader.fileSize - written);
+	
+	if (close(fd) != 0)
+		ok = false;
+	
+	if (!ok || rename(temporary, path) != 0) {
+		unlink(temporary);
+		return B_ERROR;
+	}
+	
+	return B_OK;
+}
+
+
+uint64
+FLSpriteCache::Hash(const void* data, size_t size)
+{
+	// 64 bit FNV-1a
+	const uint8* bytes = (const uint8*)data;
+	uint64 hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	
+	return hash;
+}
+
+
+uint64
+FLSpriteCache::_TableChecksum(const entry* entries, int32 count)
+{
+	return Hash(entries, count * sizeof(entry));
+}
+
+
+/*	Goes through the pixels eight bytes at a time, as a set can be
+	megabytes big, and FNV-1a only takes one byte at a time.
+*/
+uint64
+FLSpriteCache::_DataChecksum(const void* data, size_t size)
+{
+	const uint8* bytes = (const uint8*)data;
+	uint64 hash = 14695981039346656037ULL ^ size;
+	for (; size > 0; bytes += sizeof(uint64)) {
+		uint64 word = 0;
+		size_t length = size < sizeof(uint64) ? size : sizeof(uint64);
+		memcpy(&word, bytes, length);
+		size -= length;
+		
+		hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+		hash ^= hash >> 32;
+	}
+	
+	return hash;
+}
+
+
+bool
+FLSpriteCache::_IsIntact(const entry& set) const
+{
+	return _DataChecksum((const uint8*)fMapping + set.offset, set.bytes)
+		== set.checksum;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLSPRITECACHE_H_
+#define _FLSPRITECACHE_H_
+
+
+#include "FLTypes.h"
+
+
+class FLSpriteSet;
+
+
+// Bump this whenever the file, or the way the sprite sets
+// are built changes, to throw away every old cache file
+const uint32 kSpriteCacheVersion = 2;
+
+// The pixels are premultiplied B_RGBA32
+const uint32 kSpriteColorSpace = 'pARG';
+
+
+/*	Built sprite sets, saved to a file so the next start doesn't
+	need to rasterize and rotate them again. The file is mapped
+	into memory, and the sets use the pixels straight from the
+	mapping.
+
+	A set is found by the hash of what its image was made from,
+	its size, its frames and the color space of its pixels, so
+	changing the leaf images makes the old sets useless instead
+	of wrong. A file that doesn't look exactly right, from an
+	older version, or a different machine, or cut short, is not
+	used at all, and a set whose pixels don't match their
+	checksum is not found.
+
+	The sets of every screen size stay in the file, the newest
+	first, so the preview and the full screen saver don't keep
+	replacing each other's.
+*/
+class FLSpriteCache
+{
+public:
+	struct key {
+		uint64		hash;
+		int32		size;
+		int32		frames;
+		int32		angle;
+						// In hundredths of a degree
+		uint32		colorSpace;
+	};
+	
+					FLSpriteCache();
+					~FLSpriteCache();
+	
+	status_t		Open(const char* path);
+						// Map the file, if there is a valid one
+	void			Close();
+	
+	const uint32*	Find(const key& wanted) const;
+						// The bits for a set with this key, or NULL.
+						// They stay valid until Close().
+	
+	static status_t	Write(const char* path, const key* keys,
+						FLSpriteSet* const* sets, int32 count);
+						// Add these sets to the file, in front of
+						// the ones already there, and drop the
+						// oldest ones when it gets too full. A new
+						// file is written first and then renamed,
+						// so the old one stays whole until then.
+						// Of two writing at the same time, the
+						// sets of the last to finish are kept.
+	
+	static uint64	Hash(const void* data, size_t size);
+	
+private:
+	struct header;
+	struct entry;
+	
+	static uint64	_TableChecksum(const entry* entries, int32 count);
+	static uint64	_DataChecksum(const void* data, size_t size);
+	
+	bool			_IsIntact(const entry& set) const;
+	
+	void*			fMapping;
+	size_t			fMappingSize;
+	
+	const entry*	fEntries;
+	int32			fEntryCount;
+};
+
+
+#endif
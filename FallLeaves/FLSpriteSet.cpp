@@ -0,0 +1,240 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLSpriteSet.h"
+
+#include <math.h>
+
+#include "FLSprite.h"
+
+
+FLSpriteSet::FLSpriteSet(int32 size, int32 frames)
+	:
+	fSource(NULL),
+	fBits(NULL),
+	fOwnsBits(true),
+	fLevels(NULL),
+	fSize(SizeFor(size)),
+	fLevelCount(0),
+	fFrameCount(frames),
+	fReady(0)
+{
+	fSource = new FLSprite(fSize, fSize);
+	
+	// Every pixel is written by Build()
+	_Init(new uint32[BytesFor(fSize, fFrameCount) / 4]);
+}
+
+
+FLSpriteSet::FLSpriteSet(int32 size, int32 frames, const uint32* bits)
+	:
+	fSource(NULL),
+	fBits(NULL),
+	fOwnsBits(false),
+	fLevels(NULL),
+	fSize(SizeFor(size)),
+	fLevelCount(0),
+	fFrameCount(frames),
+	fReady((1U << frames) - 1)
+{
+	// The sprites are never written to once they are built
+	_Init(const_cast<uint32*>(bits));
+}
+
+
+FLSpriteSet::~FLSpriteSet()
+{
+	delete fSource;
+	
+	for (int32 i = 0; i < fFrameCount * fLevelCount; i++)
+		delete fLevels[i];
+	delete[] fLevels;
+	
+	if (fOwnsBits)
+		delete[] fBits;
+}
+
+
+void
+FLSpriteSet::Build(float maxAngle)
+{
+	// From the upright frame outwards, so the
+	// most useful frames are ready first
+	for (int32 i = 0; i < fFrameCount; i++) {
+		int32 frame = Upright() + (i % 2 == 0 ? i / 2 : -(i + 1) / 2);
+		
+		float angle = 0;
+		if (fFrameCount > 1)
+			angle = maxAngle * (2.0f * frame / (fFrameCount - 1) - 1);
+		
+		_Rotate(Level(frame, 0), angle);
+		_BuildLevels(frame);
+		
+		// The pixels are all written before the frame is
+		// marked as ready to anyone drawing it
+		__atomic_fetch_or(&fReady, 1U << frame, __ATOMIC_RELEASE);
+	}
+	
+	// Only the frames are ever drawn
+	delete fSource;
+	fSource = NULL;
+}
+
+
+const FLSprite*
+FLSpriteSet::LevelFor(int32 frame, int32 size) const
+{
+	FLSprite* const* levels = fLevels + frame * fLevelCount;
+	
+	int32 index = 0;
+	while (index + 1 < fLevelCount && levels[index + 1]->Width() >= size)
+		index++;
+	
+	return levels[index];
+}
+
+
+/*	Round up to a power of two, within the limits.
+*/
+int32
+FLSpriteSet::SizeFor(int32 size)
+{
+	int32 top = kMinSpriteSize;
+	while (top < size && top < kMaxSpriteSize)
+		top *= 2;
+	
+	return top;
+}
+
+
+size_t
+FLSpriteSet::BytesFor(int32 size, int32 frames)
+{
+	size_t pixels = 0;
+	for (int32 level = SizeFor(size); level >= kMinSpriteSize; level /= 2)
+		pixels += level * level;
+	
+	return pixels * frames * 4;
+}
+
+
+/*	Make the sprites for every level of every frame,
+	one after the other in "bits".
+*/
+void
+FLSpriteSet::_Init(uint32* bits)
+{
+	fBits = bits;
+	
+	for (int32 level = fSize; level >= kMinSpriteSize; level /= 2)
+		fLevelCount++;
+	
+	fLevels = new FLSprite*[fFrameCount * fLevelCount];
+	for (int32 frame = 0; frame < fFrameCount; frame++) {
+		for (int32 i = 0; i < fLevelCount; i++) {
+			int32 level = fSize >> i;
+			fLevels[frame * fLevelCount + i]
+				= new FLSprite(bits, level, level);
+			bits += level * level;
+		}
+	}
+}
+
+
+/*	Turn the source image "angle" degrees clockwise around its
+	center, shrunk by kFramePadding so that no corner is cut off,
+	and sample it with a bilinear filter into "dest".
+*/
+void
+FLSpriteSet::_Rotate(FLSprite* dest, float angle) const
+{
+	int32 size = fSource->Width();
+	const uint32* source = fSource->Bits();
+	
+	float radians = angle * (float)M_PI / 180.0f;
+	float cosine = cosf(radians) * kFramePadding;
+	float sine = sinf(radians) * kFramePadding;
+	float center = size / 2.0f;
+	
+	for (int32 y = 0; y < size; y++) {
+		uint32* row = dest->Bits() + y * size;
+		float dy = y + 0.5f - center;
+		
+		for (int32 x = 0; x < size; x++) {
+			float dx = x + 0.5f - center;
+			
+			// Where this pixel comes from, turned back
+			// the other way, in source pixel centers
+			float sx = cosine * dx + sine * dy + center - 0.5f;
+			float sy = -sine * dx + cosine * dy + center - 0.5f;
+			
+			int32 x0 = (int32)floorf(sx);
+			int32 y0 = (int32)floorf(sy);
+			uint32 fx = (uint32)((sx - x0) * 256);
+			uint32 fy = (uint32)((sy - y0) * 256);
+			
+			// Everything outside the source is transparent
+			uint32 p[4] = { 0, 0, 0, 0 };
+			for (int32 i = 0; i < 4; i++) {
+				int32 px = x0 + (i & 1);
+				int32 py = y0 + (i >> 1);
+				if (px >= 0 && px < size && py >= 0 && py < size)
+					p[i] = source[py * size + px];
+			}
+			
+			uint32 w[4] = {
+				(256 - fx) * (256 - fy), fx * (256 - fy),
+				(256 - fx) * fy, fx * fy
+			};
+			
+			// The weights add up to 65536
+			uint32 color = 0;
+			for (int32 shift = 0; shift < 32; shift += 8) {
+				uint32 sum = 0;
+				for (int32 i = 0; i < 4; i++)
+					sum += ((p[i] >> shift) & 0xff) * w[i];
+				color |= ((sum + 32768) >> 16) << shift;
+			}
+			
+			row[x] = color;
+		}
+	}
+}
+
+
+void
+FLSpriteSet::_BuildLevels(int32 frame)
+{
+	for (int32 i = 1; i < fLevelCount; i++) {
+		const FLSprite* source = Level(frame, i - 1);
+		FLSprite* dest = Level(frame, i);
+		
+		// Every pixel is the average of four pixels one level up.
+		// The sprites are premultiplied, so the channels can
+		// simply be averaged, two at a time.
+		for (int32 y = 0; y < dest->Height(); y++) {
+			const uint32* top = source->Bits() + y * 2 * source->Width();
+			const uint32* bottom = top + source->Width();
+			uint32* row = dest->Bits() + y * dest->Width();
+			
+			for (int32 x = 0; x < dest->Width(); x++) {
+				uint32 a = top[x * 2];
+				uint32 b = top[x * 2 + 1];
+				uint32 c = bottom[x * 2];
+				uint32 d = bottom[x * 2 + 1];
+				
+				uint32 rb = (a & 0x00ff00ff) + (b & 0x00ff00ff)
+					+ (c & 0x00ff00ff) + (d & 0x00ff00ff) + 0x00020002;
+				uint32 ag = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff)
+					+ ((c >> 8) & 0x00ff00ff) + ((d >> 8) & 0x00ff00ff)
+					+ 0x00020002;
+				
+				row[x] = ((rb >> 2) & 0x00ff00ff)
+					| ((ag << 6) & 0xff00ff00);
+			}
+		}
+	}
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLSPRITESET_H_
+#define _FLSPRITESET_H_
+
+
+#include "FLTypes.h"
+
+
+class FLSprite;
+
+
+// No leaf image is ever rasterized bigger than this, whatever the
+// size of the screen. Bigger leaves are scaled up from it.
+const int32 kMaxSpriteSize = 256;
+
+// The smallest level of a sprite set
+const int32 kMinSpriteSize = 4;
+
+// A rotated frame has room for the leaf at any angle, so it
+// is this much bigger than the leaf in it
+const float kFramePadding = 1.41421356f;
+
+
+/*	One leaf image turned to a few fixed angles, each at every
+	power of two size from the biggest one that is needed down to
+	kMinSpriteSize. The image is rasterized once, upright, into
+	Source(). Every angle is rotated from that when the set is
+	built, and every level is half the size of the one above it.
+
+	A leaf is drawn from the frame closest to its angle, by
+	scaling down the closest level that is at least as big as
+	the leaf, so nothing is rotated while the leaves fall.
+
+	A set can be built on another thread while it is being drawn.
+	The upright frame is built first, and every frame is marked as
+	ready once it is done, so the leaves can be drawn with whatever
+	frames there are so far.
+
+	All of the pixels of a set are in one block, every level of
+	every frame one after the other, so a whole set can be saved
+	and loaded (or mapped) in one piece.
+*/
+class FLSpriteSet
+{
+public:
+					FLSpriteSet(int32 size, int32 frames);
+						// Size is the size of the biggest leaf,
+						// there can be up to 31 frames
+					FLSpriteSet(int32 size, int32 frames,
+						const uint32* bits);
+						// A set that is already built, from the
+						// Bits() of another one. The bits are
+						// not copied and must outlive the set.
+					~FLSpriteSet();
+	
+	FLSprite*		Source() const { return fSource; };
+						// Draw the upright image here, then call
+						// Build(). It is gone after that.
+	void			Build(float maxAngle);
+						// Fill every frame, from -maxAngle to
+						// maxAngle degrees clockwise, and every
+						// level of it
+	
+	bool			IsReady(int32 frame) const
+						{ return (_ReadyFrames() & (1U << frame)) != 0; };
+	bool			IsComplete() const
+						{ return _ReadyFrames()
+							== (1U << fFrameCount) - 1; };
+	int32			Upright() const { return fFrameCount / 2; };
+						// The frame that isn't turned at all
+	
+	FLSprite*		Level(int32 frame, int32 index) const
+						{ return fLevels[frame * fLevelCount + index]; };
+	int32			CountLevels() const { return fLevelCount; };
+	int32			CountFrames() const { return fFrameCount; };
+	
+	const FLSprite*	LevelFor(int32 frame, int32 size) const;
+	
+	int32			Size() const { return fSize; };
+						// The biggest level, a power of two
+	const uint32*	Bits() const { return fBits; };
+	size_t			Bytes() const
+						{ return BytesFor(fSize, fFrameCount); };
+						// The memory used by the pixels
+	
+	static int32	SizeFor(int32 size);
+	static size_t	BytesFor(int32 size, int32 frames);
+						// For a set whose biggest level is "size"
+	
+private:
+	void			_Init(uint32* bits);
+	void			_Rotate(FLSprite* dest, float angle) const;
+	void			_BuildLevels(int32 frame);
+	uint32			_ReadyFrames() const
+						{ return __atomic_load_n(&fReady,
+							__ATOMIC_ACQUIRE); };
+	
+	FLSprite*		fSource;
+	uint32*			fBits;
+	bool			fOwnsBits;
+	FLSprite**		fLevels;
+	int32			fSize;
+	int32			fLevelCount;
+	int32			fFrameCount;
+	uint32			fReady;
+						// One bit for every frame that is built
+};
+
+
+#endif
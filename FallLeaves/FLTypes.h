@@ -0,0 +1,17 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLTYPES_H_
+#define _FLTYPES_H_
+
+
+/*	The leaf simulation doesn't use anything from the Haiku API besides
+	its basic types, so it can also be built on other systems, like
+	the headless harness in the "headless" folder. The types are shared
+	with everything in the "Common" folder.
+*/
+#include "PortableDefs.h"
+
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLWind.h"
+
+#include <math.h>
+
+#include "FLRandom.h"
+#include "Snapshot.h"
+
+
+// The noise is made of random values on a coarse
+// grid, and half as much again on a finer one
+static const int32 kCoarseCells = 4;
+static const int32 kFineCells = 16;
+
+
+static float
+random_unit(FLRandom& random)
+{
+	// From -1 to 1
+	return random.Range(0, 65536) / 32768.0f - 1;
+}
+
+
+static float
+smooth(float t)
+{
+	return t * t * (3 - 2 * t);
+}
+
+
+/*	Add smooth noise with "cells" random values on each side,
+	wrapping around at the edges so the texture tiles.
+*/
+static void
+add_noise(float* texture, FLRandom& random, int32 cells, float amount)
+{
+	float lattice[kFineCells * kFineCells];
+	for (int32 i = 0; i < cells * cells; i++)
+		lattice[i] = random_unit(random) * amount;
+	
+	int32 step = kWindSize / cells;
+	
+	for (int32 y = 0; y < kWindSize; y++) {
+		int32 y0 = y / step;
+		int32 y1 = (y0 + 1) % cells;
+		float fy = smooth((float)(y % step) / step);
+		
+		for (int32 x = 0; x < kWindSize; x++) {
+			int32 x0 = x / step;
+			int32 x1 = (x0 + 1) % cells;
+			float fx = smooth((float)(x % step) / step);
+			
+			float top = lattice[y0 * cells + x0]
+				+ (lattice[y0 * cells + x1] - lattice[y0 * cells + x0]) * fx;
+			float bottom = lattice[y1 * cells + x0]
+				+ (lattice[y1 * cells + x1] - lattice[y1 * cells + x0]) * fx;
+			
+			texture[y * kWindSize + x] += top + (bottom - top) * fy;
+		}
+	}
+}
+
+
+FLWind::FLWind()
+	:
+	fScale(0),
+	fOffsetX(0),
+	fOffsetY(0),
+	fDriftX(0),
+	fDriftY(0)
+{
+	for (int32 i = 0; i < kWindSize * kWindSize; i++)
+		fTexture[i] = 0;
+}
+
+
+void
+FLWind::Generate(FLRandom& random, float cellSize, float strength)
+{
+	// The wind mostly blows one way, with gusts
+	// both ways on top of that
+	float bias = random_unit(random) * 0.4f;
+	for (int32 i = 0; i < kWindSize * kWindSize; i++)
+		fTexture[i] = bias;
+	
+	add_noise(fTexture, random, kCoarseCells, 0.4f);
+	add_noise(fTexture, random, kFineCells, 0.2f);
+	
+	for (int32 i = 0; i < kWindSize * kWindSize; i++)
+		fTexture[i] *= strength;
+	
+	fScale = 1.0f / cellSize;
+	fOffsetX = 0;
+	fOffsetY = 0;
+	
+	// Gusts move with the wind, a few samples a second
+	fDriftX = -bias * 4;
+	fDriftY = -0.5f;
+}
+
+
+void
+FLWind::Advance(float seconds)
+{
+	fOffsetX = fmodf(fOffsetX + fDriftX * seconds, kWindSize);
+	fOffsetY = fmodf(fOffsetY + fDriftY * seconds, kWindSize);
+}
+
+
+float
+FLWind::Sample(float x, float y) const
+{
+	float u = x * fScale + fOffsetX;
+	float v = y * fScale + fOffsetY;
+	
+	float u0 = floorf(u);
+	float v0 = floorf(v);
+	float fu = u - u0;
+	float fv = v - v0;
+	
+	// The size is a power of two, so wrapping
+	// around works for negative samples as well
+	int32 x0 = (int32)u0 & (kWindSize - 1);
+	int32 y0 = (int32)v0 & (kWindSize - 1);
+	int32 x1 = (x0 + 1) & (kWindSize - 1);
+	int32 y1 = (y0 + 1) & (kWindSize - 1);
+	
+	const float* top = fTexture + y0 * kWindSize;
+	const float* bottom = fTexture + y1 * kWindSize;
+	
+	float upper = top[x0] + (top[x1] - top[x0]) * fu;
+	float lower = bottom[x0] + (bottom[x1] - bottom[x0]) * fu;
+	
+	return upper + (lower - upper) * fv;
+}
+
+
+void
+FLWind::WriteSnapshot(Snapshot& snapshot) const
+{
+	snapshot.WriteData(fTexture, sizeof(fTexture));
+	snapshot.Write(fScale);
+	snapshot.Write(fOffsetX);
+	snapshot.Write(fOffsetY);
+	snapshot.Write(fDriftX);
+	snapshot.Write(fDriftY);
+}
+
+
+void
+FLWind::ReadSnapshot(Snapshot& snapshot)
+{
+	snapshot.ReadData(fTexture, sizeof(fTexture));
+	snapshot.Read(&fScale);
+	snapshot.Read(&fOffsetX);
+	snapshot.Read(&fOffsetY);
+	snapshot.Read(&fDriftX);
+	snapshot.Read(&fDriftY);
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLWIND_H_
+#define _FLWIND_H_
+
+
+#include "FLTypes.h"
+
+
+class FLRandom;
+class Snapshot;
+
+
+// The wind texture is this many samples on each side
+const int32 kWindSize = 64;
+
+
+/*	The horizontal wind over the screen. A small tiling texture of
+	smooth noise is made once, stretched over the screen and slowly
+	blown across it, so finding the wind anywhere is only a lookup
+	and a bilinear blend, however many leaves ask.
+*/
+class FLWind
+{
+public:
+					FLWind();
+	
+	void			Generate(FLRandom& random, float cellSize,
+						float strength);
+						// Every "cellSize" pixels of the screen is
+						// one sample of the texture. The wind blows
+						// at up to "strength" pixels per second.
+	
+	void			Advance(float seconds);
+						// Blow the texture across the screen
+	
+	float			Sample(float x, float y) const;
+						// The wind speed at (x, y), in pixels per
+						// second. Positive blows to the right.
+	
+	void			WriteSnapshot(Snapshot& snapshot) const;
+	void			ReadSnapshot(Snapshot& snapshot);
+						// All of the wind, as it was generated and
+						// as far as it was blown
+	
+private:
+	float			fTexture[kWindSize * kWindSize];
+	float			fScale;
+						// Texture samples per pixel
+	float			fOffsetX;
+	float			fOffsetY;
+						// How far the texture has been blown,
+						// in samples
+	float			fDriftX;
+	float			fDriftY;
+						// In samples per second
+};
+
+
+#endif
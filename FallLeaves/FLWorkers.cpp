@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FLWorkers.h"
+
+#include <unistd.h>
+
+
+FLWorkers::FLWorkers(int32 threads, int32 maxJobs)
+	:
+	fThreads(NULL),
+	fThreadCount(0),
+	fJobs(NULL),
+	fMaxJobs(maxJobs),
+	fFirst(0),
+	fQueued(0),
+	fPending(0),
+	fQuitting(false)
+{
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fJobAdded, NULL);
+	pthread_cond_init(&fJobDone, NULL);
+	
+	fJobs = new job[fMaxJobs];
+	
+	fThreads = new pthread_t[threads > 0 ? threads : 1];
+	for (int32 i = 0; i < threads; i++) {
+		if (pthread_create(&fThreads[fThreadCount], NULL, &_Run, this) != 0)
+			break;
+		fThreadCount++;
+	}
+}
+
+
+FLWorkers::~FLWorkers()
+{
+	Wait();
+	
+	pthread_mutex_lock(&fLock);
+	fQuitting = true;
+	pthread_cond_broadcast(&fJobAdded);
+	pthread_mutex_unlock(&fLock);
+	
+	for (int32 i = 0; i < fThreadCount; i++)
+		pthread_join(fThreads[i], NULL);
+	
+	delete[] fThreads;
+	delete[] fJobs;
+	
+	pthread_cond_destroy(&fJobDone);
+	pthread_cond_destroy(&fJobAdded);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+bool
+FLWorkers::AddJob(job_function function, void* data)
+{
+	if (fThreadCount == 0) {
+		function(data);
+		return true;
+	}
+	
+	pthread_mutex_lock(&fLock);
+	
+	if (fQueued == fMaxJobs) {
+		pthread_mutex_unlock(&fLock);
+		return false;
+	}
+	
+	job& added = fJobs[(fFirst + fQueued) % fMaxJobs];
+	added.function = function;
+	added.data = data;
+	fQueued++;
+	fPending++;
+	
+	pthread_cond_signal(&fJobAdded);
+	pthread_mutex_unlock(&fLock);
+	
+	return true;
+}
+
+
+void
+FLWorkers::Wait()
+{
+	pthread_mutex_lock(&fLock);
+	while (fPending > 0)
+		pthread_cond_wait(&fJobDone, &fLock);
+	pthread_mutex_unlock(&fLock);
+}
+
+
+int32
+FLWorkers::CountProcessors()
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int32)count : 1;
+}
+
+
+void*
+FLWorkers::_Run(void* data)
+{
+	FLWorkers* workers = (FLWorkers*)data;
+	
+	pthread_mutex_lock(&workers->fLock);
+	
+	while (true) {
+		while (workers->fQueued == 0 && !workers->fQuitting)
+			pthread_cond_wait(&workers->fJobAdded, &workers->fLock);
+		
+		if (workers->fQueued == 0)
+			break;
+		
+		job next = workers->fJobs[workers->fFirst];
+		workers->fFirst = (workers->fFirst + 1) % workers->fMaxJobs;
+		workers->fQueued--;
+		
+		// Run the job without holding the lock
+		pthread_mutex_unlock(&workers->fLock);
+		next.function(next.data);
+		pthread_mutex_lock(&workers->fLock);
+		
+		if (--workers->fPending == 0)
+			pthread_cond_broadcast(&workers->fJobDone);
+	}
+	
+	pthread_mutex_unlock(&workers->fLock);
+	
+	return NULL;
+}
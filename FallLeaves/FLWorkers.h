@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _FLWORKERS_H_
+#define _FLWORKERS_H_
+
+
+#include <pthread.h>
+
+#include "FLTypes.h"
+
+
+/*	A few threads that run jobs from a fixed size queue, so slow
+	work can be done in the background while the leaves are
+	already falling. POSIX threads are used, rather than
+	spawn_thread(), so the headless harness can run it too.
+*/
+class FLWorkers
+{
+public:
+	typedef void	(*job_function)(void* data);
+	
+					FLWorkers(int32 threads, int32 maxJobs);
+					~FLWorkers();
+						// Waits for every job that was added
+	
+	int32			CountThreads() const { return fThreadCount; };
+	
+	bool			AddJob(job_function function, void* data);
+						// Returns false if the queue is full.
+						// With no threads, the job is run right
+						// away on the calling thread.
+	void			Wait();
+						// Until every job that was added is done
+	
+	static int32	CountProcessors();
+	
+private:
+	struct job {
+		job_function	function;
+		void*			data;
+	};
+	
+	static void*	_Run(void* data);
+	
+	pthread_t*		fThreads;
+	int32			fThreadCount;
+	
+	job*			fJobs;
+	int32			fMaxJobs;
+	int32			fFirst;
+	int32			fQueued;
+	int32			fPending;
+						// The queued jobs and the running ones
+	bool			fQuitting;
+	
+	pthread_mutex_t	fLock;
+	pthread_cond_t	fJobAdded;
+	pthread_cond_t	fJobDone;
+};
+
+
+#endif
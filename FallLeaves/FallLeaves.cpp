@@ -14,19 +14,31 @@
 
 
 #include <stdlib.h>
+#include <string.h>
+
+#include <Bitmap.h>
+#include <FindDirectory.h>
+#include <Path.h>
 
 #include "IconUtils.h" // TEMP local, soon to be made a public Haiku API
 
 #include "FallLeaves.h"
+#include "FLBuffer.h"
 #include "FLConfigView.h"
-#include "FLLeaf.h"
-
+#include "FLSprite.h"
+#include "FLSpriteCache.h"
 
-#define RAND_NUM(low, high) ((rand() % ((high) - (low) + 1) + (low)))
 
 #define TICKS_PER_SECOND 100
 #define MICROSECS_IN_SEC 1000000
 
+// Never draw less than this many times per second
+#define MIN_TICKS_PER_SECOND 20
+
+// Rather draw fewer leaves than take longer than this
+// to draw them
+#define BUDGET_TICKS_PER_SECOND 50
+
 
 const char* kArchiveAmountStr = "FallLeaves amount";
 const char* kArchiveSpeedStr = "FallLeaves speed";
@@ -35,15 +47,18 @@ const char* kArchiveSpeedStr = "FallLeaves speed";
 FallLeaves::FallLeaves(BMessage* archive, image_id thisImage)
 	:
 	BScreenSaver(archive, thisImage),
-	fLeaves(NULL),
-	fSize(0),
+	fField(NULL),
+	fPacer(kStepTime, MICROSECS_IN_SEC / TICKS_PER_SECOND,
+		MICROSECS_IN_SEC / MIN_TICKS_PER_SECOND),
+	fGovernor(MICROSECS_IN_SEC / BUDGET_TICKS_PER_SECOND),
+	fSnapshot(kSnapshotType, kSnapshotVersion),
+	fSnapshotPath(getenv(SNAPSHOT_VARIABLE)),
+	fSlowestFrame(0),
 	fAmount(kDefaultAmount),
 	fSpeed(kDefaultSpeed),
-	fBackBitmap(NULL),
-	fBackView(NULL)
+	fBackBitmap(NULL)
 {
-	for (int32 i = 0; i < 101; i++)
-		fZUsed[i] = false;
+	fTrace.ConfigureFromEnvironment();
 	
 	if (archive) {
 		if (archive->FindInt32(kArchiveAmountStr, &fAmount) != B_OK)
@@ -56,19 +71,11 @@ FallLeaves::FallLeaves(BMessage* archive, image_id thisImage)
 
 FallLeaves::~FallLeaves()
 {
-	for (int32 i = 0; ; i++) {
-		Leaf* leaf = fLeaves->ItemAt(i);
-		if (leaf == NULL)
-			break;
-		delete leaf;
-	}
-	
-	delete fLeaves;
-	
-	fBackBitmap->RemoveChild(fBackView);
-	
-	delete fBackView;
+	delete fField;
 	delete fBackBitmap;
+	
+	if (fTrace.DumpPath() != NULL)
+		fTrace.DumpChromeTrace(fTrace.DumpPath());
 }
 
 
@@ -82,59 +89,36 @@ FallLeaves::StartConfig(BView* configView)
 }
 
 
-/*	A small helper function to sort leaves.
-	Sort the leaves in order of their Z axis,
-	from large to small.
-*/
-int
-cmpz(const Leaf* leaf1, const Leaf* leaf2)
-{
-	if (leaf1->Z() < leaf2->Z())
-		return 1;
-	
-	if (leaf1->Z() > leaf2->Z())
-		return -1;
-	
-	return 0;
-}
-
-
 status_t
 FallLeaves::StartSaver(BView* view, bool preview)
 {
 	BRect screenRect = view->Bounds();
 	
-	// Initialize the screen buffer
-	fBackBitmap = new BBitmap(screenRect, B_RGBA32, true);
-	fBackView = new BView(screenRect, NULL, 0, 0);
-
-	fBackBitmap->AddChild(fBackView);
+	// Initialize the screen buffer. The leaves are drawn
+	// right into its bits, so it doesn't need a view.
+	fBackBitmap = new BBitmap(screenRect, B_RGBA32);
 	
-	if (fBackBitmap->Lock()) {
-		fBackView->FillRect(fBackView->Bounds());
-		fBackView->SetDrawingMode(B_OP_OVER); // Leaf transparency
-		fBackBitmap->Unlock();
-	}
-
-	// Set the rate the screensaver to be updated 100 times per second
+	// Start out updating the screensaver 100 times per second,
+	// the pacer slows that down if drawing can't keep up.
 	// The argument here is in microseconds
-	SetTickSize(MICROSECS_IN_SEC / TICKS_PER_SECOND);
-	
-	// Initialize the random number generator
-	srand(system_time() % INT_MAX);
+	SetTickSize(fPacer.TickSize());
 	
-	// The max size of a leaf will be about 20% the
-	// height of the screen
-	fSize = (view->Bounds().IntegerHeight() * 2) / 10;
+	fField = new FLField(this);
+	fField->SetTrace(&fTrace);
+	fField->SetAmount(fAmount);
+	fGovernor.Reset(fAmount, kMinAmount);
+	fField->SetSpeed(fSpeed);
 	
-	fLeaves = new BObjectList<Leaf>();
+	// Keep the rasterized leaves around for next time
+	BPath cachePath;
+	if (find_directory(B_USER_CACHE_DIRECTORY, &cachePath, true) == B_OK
+		&& cachePath.Append("FallLeaves sprites") == B_OK)
+		fField->SetCachePath(cachePath.Path());
 	
-	// Create some leaves
-	for (int32 i = 0; i < fAmount; i++)
-		fLeaves->AddItem(_CreateLeaf(view, true));
-	
-	// Sort the leaves by Z axis
-	fLeaves->SortItems(cmpz);
+	// Create some leaves, with the random
+	// number generator seeded from the clock
+	fField->Start(screenRect.IntegerWidth() + 1,
+		screenRect.IntegerHeight() + 1, (uint32)system_time());
 	
 	return B_OK;
 }
@@ -156,44 +140,66 @@ FallLeaves::SaveState(BMessage* into) const
 void
 FallLeaves::Draw(BView* view, int32 frame)
 {
-	if (fBackBitmap->Lock()) {
-		
-		// Clear the offscreen buffer
-		fBackView->FillRect(fBackView->Bounds());
-		
-		// Update and draw the leaves
-		for (int32 i = fLeaves->CountItems() - 1; ; i--) {
-			Leaf* leaf = fLeaves->ItemAt(i);
-			if (leaf == NULL)
-				break;
-			leaf->Update(TICKS_PER_SECOND);
-			leaf->Draw(fBackView);
-			
-			// If the leaf is dead, remove it
-			if (leaf->IsDead()) {
-				fZUsed[leaf->Z()] = false;
-				fLeaves->RemoveItem(leaf);
-				delete leaf;
-			}
-		}
-		
-		fBackBitmap->Unlock();
+	bigtime_t now = system_time();
+	fTrace.BeginFrame();
+	
+	// Keep what the frame starts from, in case it is the slowest.
+	// The first frames are slow anyway, while the leaf images
+	// are being built.
+	bool snapshot = fSnapshotPath != NULL && fField->SpritesReady();
+	if (snapshot) {
+		fSnapshot.MakeEmpty();
+		fField->WriteSnapshot(fSnapshot);
+		fPacer.WriteSnapshot(fSnapshot);
+	}
+	
+	// Update the leaves for the time that went by since
+	// the last frame, replacing any dead ones
+	{
+		TRACE_SCOPE(&fTrace, "update");
+		int32 steps = fPacer.Advance(now);
+		for (int32 i = 0; i < steps; i++)
+			fField->Step();
 	}
 	
-	bool sort = false;
+	// Draw them into the offscreen buffer, in between
+	// where they were and where they are now
+	FLBuffer buffer(fBackBitmap->Bits(), fBackBitmap->Bounds().IntegerWidth()
+		+ 1, fBackBitmap->Bounds().IntegerHeight() + 1,
+		fBackBitmap->BytesPerRow());
+	fField->Draw(&buffer, fPacer.Alpha());
 	
-	// Add some new leaves if necessary
-	// to replace any dead ones
-	while (fLeaves->CountItems() < fAmount) {
-		fLeaves->AddItem(_CreateLeaf(view, false));
-		sort = true;
+	{
+		TRACE_SCOPE(&fTrace, "present");
+		view->DrawBitmap(fBackBitmap);
+		
+		// Otherwise this only times asking the
+		// app_server to draw it
+		if (fTrace.IsEnabled())
+			view->Sync();
 	}
 	
-	// Keep the leaves sorted by Z axis
-	if (sort)
-		fLeaves->SortItems(cmpz);
+	if (fTrace.ShowsOverlay())
+		_DrawOverlay(view);
+	
+	fTrace.EndFrame();
+	
+	// Don't ask for more frames than we can draw,
+	// or for more leaves
+	bigtime_t cost = system_time() - now;
+	fPacer.FrameDone(cost);
+	if (fPacer.TickSize() != TickSize())
+		SetTickSize(fPacer.TickSize());
+	
+	if (fGovernor.FrameDone(cost)) {
+		fField->SetAmount(fGovernor.Amount());
+		fField->SetSmooth(fGovernor.Smooth());
+	}
 	
-	view->DrawBitmap(fBackBitmap);
+	if (snapshot && cost > fSlowestFrame) {
+		fSlowestFrame = cost;
+		fSnapshot.WriteFile(fSnapshotPath);
+	}
 }
 
 
@@ -201,6 +207,11 @@ void
 FallLeaves::SetAmount(int32 amount)
 {
 	fAmount = amount;
+	if (fField != NULL) {
+		fGovernor.Reset(amount, kMinAmount);
+		fField->SetAmount(amount);
+		fField->SetSmooth(true);
+	}
 }
 
 
@@ -208,59 +219,8 @@ void
 FallLeaves::SetSpeed(int32 speed)
 {
 	fSpeed = speed;
-}
-
-
-/*
-	Create a leaf.
-	If the "above" parameter is true, it will create the leaf in
-	a random location above the screen. If it's false, the leaf
-	will be created just above the screen, ready to come it.
-*/
-Leaf*
-FallLeaves::_CreateLeaf(BView* view, bool above)
-{
-	// The Z axis (how far away the leaf is)
-	// determines the size and speed
-	int32 z = RAND_NUM(40, 100);
-	
-	// Use this array to ensure unique Z values.
-	while (fZUsed[z]) {
-		z++;
-		if (z > 100)
-			z = 40;
-	}
-	fZUsed[z] = true;
-	
-	// The lower the Z axis number, the smaller the leaf
-	int32 size = (fSize * z) / 100;
-	
-	// Create the leaf
-	Leaf* leaf = new Leaf(_RandomBitmap(size));
-	
-	leaf->SetZ(z);
-	
-	// The lower the Z axis number, the slower the leaf
-	int32 maxSpeedFromScreenSize = view->Bounds().IntegerHeight();
-	int32 maxSpeed = (maxSpeedFromScreenSize * fSpeed) / kMaxSpeed;
-	int32 speed = (maxSpeed * z) / 100;
-	leaf->SetSpeed(speed);
-	
-	BRect boundary(-(size / 2), -view->Bounds().Height(),
-			view->Bounds().Width() - (size / 2), view->Bounds().Height());
-	leaf->SetBoundary(boundary);
-	
-	// Set it to a random position
-	BPoint pos;
-	pos.x = RAND_NUM((int32)boundary.left, boundary.IntegerWidth());
-	pos.y = -size;
-	
-	if (above)
-		pos.y = -(RAND_NUM(size, boundary.IntegerHeight()));
-	
-	leaf->SetPos(pos);
-	
-	return leaf;
+	if (fField != NULL)
+		fField->SetSpeed(speed);
 }
 
 
@@ -607,38 +567,55 @@ const unsigned char kLeaf6[] = {
 };
 
 
-const int32 kNumLeafTypes = 6;
+const unsigned char* kLeafIcons[kNumLeafTypes] = {
+	kLeaf1, kLeaf2, kLeaf3, kLeaf4, kLeaf5, kLeaf6
+};
+
+const size_t kLeafIconSizes[kNumLeafTypes] = {
+	sizeof(kLeaf1), sizeof(kLeaf2), sizeof(kLeaf3),
+	sizeof(kLeaf4), sizeof(kLeaf5), sizeof(kLeaf6)
+};
 
 
-BBitmap*
-FallLeaves::_RandomBitmap(int32 size)
+/*	Rasterize one of the leaf images into a sprite.
+	The FLField calls this once for every leaf image when it
+	starts, and scales the sprite from there on.
+*/
+void
+FallLeaves::RenderSprite(int32 type, FLSprite* sprite)
 {
-	BBitmap* bitmap = new BBitmap(BRect(0, 0, size, size), B_RGBA32);
+	BBitmap bitmap(BRect(0, 0, sprite->Width() - 1, sprite->Height() - 1),
+		B_BITMAP_NO_SERVER_LINK, B_RGBA32);
 	
-	// Randomly select one of the leaf images
-	switch (RAND_NUM(1, kNumLeafTypes)) {
-		
-		case 1:
-			BIconUtils::GetVectorIcon(kLeaf1, sizeof(kLeaf1), bitmap);
-			break;
-		case 2:
-			BIconUtils::GetVectorIcon(kLeaf2, sizeof(kLeaf2), bitmap);
-			break;
-		case 3:
-			BIconUtils::GetVectorIcon(kLeaf3, sizeof(kLeaf3), bitmap);
-			break;
-		case 4:
-			BIconUtils::GetVectorIcon(kLeaf4, sizeof(kLeaf4), bitmap);
-			break;
-		case 5:
-			BIconUtils::GetVectorIcon(kLeaf5, sizeof(kLeaf5), bitmap);
-			break;
-		case 6:
-			BIconUtils::GetVectorIcon(kLeaf6, sizeof(kLeaf6), bitmap);
-			break;
-	}
+	memset(bitmap.Bits(), 0, bitmap.BitsLength());
+	BIconUtils::GetVectorIcon(kLeafIcons[type], kLeafIconSizes[type],
+		&bitmap);
+	
+	sprite->SetBits((const uint8*)bitmap.Bits(), bitmap.BytesPerRow());
+}
+
+
+uint64
+FallLeaves::SpriteHash(int32 type)
+{
+	// The images only change with the icon data
+	return FLSpriteCache::Hash(kLeafIcons[type], kLeafIconSizes[type]);
+}
+
+
+/*	Show how long the frames took, in the top left corner.
+	The leaves are drawn over it again in the next frame.
+*/
+void
+FallLeaves::_DrawOverlay(BView* view)
+{
+	char summary[256];
+	fTrace.GetSummary(summary, sizeof(summary));
 	
-	return bitmap;
+	view->SetDrawingMode(B_OP_OVER);
+	view->SetHighColor(255, 255, 255);
+	view->DrawString(summary, BPoint(10, 20));
+	view->SetDrawingMode(B_OP_COPY);
 }
 
 
@@ -6,25 +6,16 @@
 #define _FALLLEAVES_H_
 
 
-#include <ObjectList.h>
 #include <ScreenSaver.h>
 
+#include "FLField.h"
+#include "FLGovernor.h"
+#include "FLPacer.h"
+#include "FrameTrace.h"
+#include "Snapshot.h"
 
-// The number of leaves on the screen
-const int32 kMaxAmount = 50;
-const int32 kMinAmount = 10;
-const int32 kDefaultAmount = 35;
 
-// The speed of the leaves
-const int32 kMaxSpeed = 10;
-const int32 kMinSpeed = 1;
-const int32 kDefaultSpeed = 5;
-
-
-typedef class Leaf;
-
-
-class FallLeaves : public BScreenSaver
+class FallLeaves : public BScreenSaver, public FLSpriteSource
 {
 public:
 							FallLeaves(BMessage* archive, image_id thisImage);
@@ -38,14 +29,29 @@ public:
 	
 	void					SetAmount(int32 amount);
 	void					SetSpeed(int32 speed);
-private:
-	Leaf*					_CreateLeaf(BView* view, bool above);
-	BBitmap*				_RandomBitmap(int32 size);
 	
-	BObjectList<Leaf>*		fLeaves;
+	void					RenderSprite(int32 type, FLSprite* sprite);
+	uint64					SpriteHash(int32 type);
+private:
+	void					_DrawOverlay(BView* view);
 	
-	int32					fSize;
-								// The size of the biggest possible leaf
+	FLField*				fField;
+								// The leaves themselves
+	FLPacer					fPacer;
+								// Decides how far the leaves
+								// move each frame
+	FLGovernor				fGovernor;
+								// Takes leaves away when there
+								// are too many to draw in time
+	FrameTrace				fTrace;
+								// How long the frames take, only
+								// when asked for in the environment
+	Snapshot				fSnapshot;
+	const char*				fSnapshotPath;
+	bigtime_t				fSlowestFrame;
+								// The leaves before the slowest frame
+								// are saved, only when asked for in
+								// the environment too
 	
 	int32					fAmount;
 								// The amount of leaves on the screen
@@ -53,12 +59,8 @@ private:
 								// The speed of the fastest leaf
 	
 	BBitmap*				fBackBitmap;
-	BView*					fBackView;
 								// For double buffering,
 								// used to reduce flicker
-	
-	bool					fZUsed[101];
-								// Used to give each leaf a unique Z depth
 };
 
 
@@ -0,0 +1,604 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Runs the FallLeaves simulation without the screensaver host,
+	drawing into a plain block of memory instead of a BBitmap.
+	It prints how long the frames took and a checksum of the
+	last frame, which is the same for every run with the same
+	settings. It also counts every allocation made while the
+	leaves are falling, which should be none.
+
+	After that, it times moving and culling a much bigger number
+	of leaves through the wind, without drawing them, and clearing
+	and drawing the frame the different ways it can be done.
+
+	It can also save a snapshot of the leaves before one frame, and
+	run on from a snapshot instead of starting, from this harness or
+	from the screensaver, to look at one slow frame on its own.
+*/
+
+
+#include <algorithm>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FLBuffer.h"
+#include "FLField.h"
+#include "FLGovernor.h"
+#include "FLLeaf.h"
+#include "FLPacer.h"
+#include "FLPool.h"
+#include "FLWind.h"
+#include "FLWorkers.h"
+#include "FrameTrace.h"
+#include "ShapeSprites.h"
+#include "Snapshot.h"
+
+
+// Counts every operator new, see below
+static int64 sAllocations = 0;
+
+
+/*	Both forms of operator new allocate with this, and both forms of
+	operator delete free with free(), so that they always match, even
+	where the compiler sees through one calling the other.
+*/
+static void*
+counted_malloc(size_t size)
+{
+	sAllocations++;
+	void* memory = malloc(size != 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+
+void*
+operator new(size_t size)
+{
+	return counted_malloc(size);
+}
+
+
+void*
+operator new[](size_t size)
+{
+	return counted_malloc(size);
+}
+
+
+void
+operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete[](void* memory) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete(void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+
+void
+operator delete[](void* memory, size_t) throw()
+{
+	free(memory);
+}
+
+
+static bigtime_t
+monotonic_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (bigtime_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+
+static uint32
+checksum(const FLBuffer& buffer)
+{
+	// FNV-1a over every pixel
+	uint32 hash = 2166136261U;
+	for (int32 y = 0; y < buffer.Height(); y++) {
+		const uint8* row = buffer.Bits() + y * buffer.BytesPerRow();
+		for (int32 i = 0; i < buffer.Width() * 4; i++) {
+			hash ^= row[i];
+			hash *= 16777619U;
+		}
+	}
+	return hash;
+}
+
+
+static bigtime_t
+percentile(const bigtime_t* sorted, int32 count, int32 percent)
+{
+	return sorted[(int64)(count - 1) * percent / 100];
+}
+
+
+/*	Time the physics on their own: "count" leaves spread over
+	the screen and above it, moved and culled for "steps" steps.
+*/
+static void
+physics_benchmark(int32 count, int32 width, int32 height, int32 speed,
+	uint32 seed, int32 steps)
+{
+	FLRandom random(seed);
+	FLWind wind;
+	wind.Generate(random, width / 16.0f,
+		(height * speed) / kMaxSpeed * 0.5f);
+	
+	FLLeafPool pool(count);
+	for (int32 i = 0; i < count; i++) {
+		Leaf* leaf = pool.Acquire();
+		int32 z = random.Range(kMinZ, kMaxZ);
+		int32 size = (height * 2 / 10) * z / 100;
+		
+		leaf->SetSprites(NULL, size);
+		leaf->SetSpeed((float)(height * speed) / kMaxSpeed * z / 100);
+		leaf->SetSway(random.Range(30, 100) / 100.0f,
+			random.Range(0, 628) / 100.0f, random.Range(20, 60) / 100.0f);
+		leaf->SetPos(random.Range(-size, width),
+			random.Range(-height, height));
+	}
+	
+	bigtime_t* integrate = new bigtime_t[steps];
+	bigtime_t* classify = new bigtime_t[steps];
+	for (int32 step = 0; step < steps; step++) {
+		bigtime_t start = monotonic_time();
+		wind.Advance(kStepTime / 1000000.0f);
+		pool.Integrate(kStepTime / 1000000.0f, wind);
+		integrate[step] = monotonic_time() - start;
+		
+		start = monotonic_time();
+		pool.Classify(0.5f, width, height);
+		classify[step] = monotonic_time() - start;
+	}
+	
+	std::sort(integrate, integrate + steps);
+	std::sort(classify, classify + steps);
+	
+	// Scaled to 10000 leaves, to compare different counts
+	double scale = 10000.0 / count;
+	printf("physics, %d leaves, %d steps: integrate p50 %lld us  p99 %lld us,"
+		"  cull p50 %lld us  p99 %lld us\n", (int)count, (int)steps,
+		(long long)percentile(integrate, steps, 50),
+		(long long)percentile(integrate, steps, 99),
+		(long long)percentile(classify, steps, 50),
+		(long long)percentile(classify, steps, 99));
+	printf("physics per 10k leaves: %.1f us a step\n",
+		(percentile(integrate, steps, 50) + percentile(classify, steps, 50))
+			* scale);
+	
+	delete[] integrate;
+	delete[] classify;
+}
+
+
+static void
+print_rate(const char* name, int64 bytes, bigtime_t time)
+{
+	printf("  %-28s %6lld us  %6.2f GB/s\n", name, (long long)time,
+		time > 0 ? bytes / (time * 1000.0) : 0.0);
+}
+
+
+/*	Time clearing the frame with memset(), with the plain loop and
+	with streaming stores, "rounds" times each, and then drawing the
+	same leaves over a frame that was cleared first and one band at
+	a time. Both have to give the same frame.
+*/
+static void
+buffer_benchmark(int32 rounds, int32 width, int32 height, int32 amount,
+	int32 speed, uint32 seed)
+{
+	uint8* bits = new uint8[width * height * 4];
+	FLBuffer buffer(bits, width, height, width * 4);
+	int64 bytes = (int64)width * height * 4 * rounds;
+	
+	printf("buffer, %dx%d, %d rounds:\n", (int)width, (int)height,
+		(int)rounds);
+	
+	bigtime_t start = monotonic_time();
+	for (int32 i = 0; i < rounds; i++)
+		memset(bits, i, width * height * 4);
+	print_rate("clear with memset", bytes, monotonic_time() - start);
+	
+	start = monotonic_time();
+	for (int32 i = 0; i < rounds; i++)
+		buffer.ClearRows(0, height, kBackgroundColor + i);
+	print_rate("clear", bytes, monotonic_time() - start);
+	
+	start = monotonic_time();
+	for (int32 i = 0; i < rounds; i++)
+		buffer.ClearRows(0, height, kBackgroundColor + i, true);
+	print_rate("clear, streaming", bytes, monotonic_time() - start);
+	
+	// The same leaves, well into their fall
+	ShapeSprites sprites;
+	FLField field(&sprites);
+	field.SetAmount(amount);
+	field.SetSpeed(speed);
+	field.SetWorkerCount(0);
+	field.Start(width, height, seed);
+	for (int32 i = 0; i < 500; i++)
+		field.Step();
+	
+	uint32 hashes[2];
+	for (int32 banded = 0; banded < 2; banded++) {
+		field.SetBanded(banded != 0);
+		start = monotonic_time();
+		for (int32 i = 0; i < rounds; i++)
+			field.Draw(&buffer, 0.5f);
+		print_rate(banded ? "clear and draw, banded"
+			: "clear, then draw", bytes, monotonic_time() - start);
+		hashes[banded] = checksum(buffer);
+	}
+	
+	printf("  %d leaves drawn, frames %s\n", (int)field.CountDrawn(),
+		hashes[0] == hashes[1] ? "the same" : "DIFFERENT");
+	
+	delete[] bits;
+}
+
+
+/*	Run "frames" frames on from the snapshot, "repeat" times over,
+	and print how long they took and whether every run ended with
+	the same frame.
+*/
+static int
+replay(const char* path, int32 frames, int32 fps, int32 repeat,
+	int32 threads)
+{
+	Snapshot snapshot(kSnapshotType, kSnapshotVersion);
+	if (snapshot.ReadFile(path) != B_OK) {
+		fprintf(stderr, "%s is not a FallLeaves snapshot\n", path);
+		return 1;
+	}
+	
+	ShapeSprites sprites;
+	FLField field(&sprites);
+	field.SetWorkerCount(threads);
+	FLPacer pacer(kStepTime, 10000, 50000);
+	
+	if (field.ReadSnapshot(snapshot) != B_OK) {
+		fprintf(stderr, "%s is damaged\n", path);
+		return 1;
+	}
+	pacer.ReadSnapshot(snapshot);
+	
+	// Time the frames, not building the images
+	field.WaitForSprites();
+	
+	int32 width = field.Width();
+	int32 height = field.Height();
+	int64 step = field.CountSteps();
+	uint8* bits = new uint8[width * height * 4];
+	FLBuffer buffer(bits, width, height, width * 4);
+	bigtime_t* times = new bigtime_t[frames * repeat];
+	
+	uint32 first = 0;
+	bool same = true;
+	int64 allocations = 0;
+	
+	for (int32 run = 0; run < repeat; run++) {
+		if (run > 0) {
+			snapshot.Rewind();
+			field.ReadSnapshot(snapshot);
+			pacer.ReadSnapshot(snapshot);
+		}
+		
+		int64 started = sAllocations;
+		bigtime_t origin = pacer.LastFrame();
+		
+		for (int32 frame = 0; frame < frames; frame++) {
+			bigtime_t start = monotonic_time();
+			
+			int32 steps = pacer.Advance(origin
+				+ (bigtime_t)(frame + 1) * 1000000 / fps);
+			for (int32 i = 0; i < steps; i++)
+				field.Step();
+			field.Draw(&buffer, pacer.Alpha());
+			
+			times[run * frames + frame] = monotonic_time() - start;
+			pacer.FrameDone(times[run * frames + frame]);
+		}
+		
+		allocations += sAllocations - started;
+		
+		uint32 sum = checksum(buffer);
+		if (run == 0)
+			first = sum;
+		else if (sum != first)
+			same = false;
+	}
+	
+	int32 count = frames * repeat;
+	std::sort(times, times + count);
+	
+	printf("FallLeaves replay of %s: %dx%d from step %lld, %d leaves, "
+		"%d frames at %d fps, %d times\n", path, (int)width, (int)height,
+		(long long)step, (int)field.CountLeaves(), (int)frames, (int)fps,
+		(int)repeat);
+	printf("frame time (us): p50 %lld  p90 %lld  p99 %lld  max %lld\n",
+		(long long)percentile(times, count, 50),
+		(long long)percentile(times, count, 90),
+		(long long)percentile(times, count, 99),
+		(long long)times[count - 1]);
+	printf("allocations while running: %lld\n", (long long)allocations);
+	const char* verdict = "";
+	if (repeat > 1)
+		verdict = same ? ", the same every time" : ", NOT the same every time";
+	printf("checksum: 0x%08x%s\n", (unsigned)first, verdict);
+	
+	delete[] times;
+	delete[] bits;
+	
+	return same ? 0 : 1;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--seed n] [--width n] [--height n]\n"
+		"\t[--amount n] [--speed %d-%d] [--frames n] [--fps n]\n"
+		"\t[--physics leaves] [--threads n] [--cache file] [--budget us]\n"
+		"\t[--trace file] [--snapshot file [--at frame]] [--banded 0|1]\n"
+		"\t[--clears rounds]\n"
+		"       %s --replay file [--frames n] [--fps n] [--repeat n]\n"
+		"\t[--threads n]\n",
+		name, (int)kMinSpeed, (int)kMaxSpeed, name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	uint32 seed = 1;
+	int32 width = 1920;
+	int32 height = 1080;
+	int32 amount = kDefaultAmount;
+	int32 speed = kDefaultSpeed;
+	int32 frames = 1000;
+	int32 fps = 100;
+	int32 physics = 10000;
+	int32 clears = 200;
+	bool banded = true;
+	int32 threads = FLWorkers::CountProcessors();
+	const char* cache = NULL;
+	int32 budget = 0;
+	const char* tracePath = NULL;
+	const char* snapshotPath = NULL;
+	int32 snapshotAt = -1;
+	const char* replayPath = NULL;
+	int32 repeat = 1;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--cache") == 0)
+			cache = argv[i + 1];
+		else if (strcmp(argv[i], "--seed") == 0)
+			seed = value;
+		else if (strcmp(argv[i], "--width") == 0)
+			width = value;
+		else if (strcmp(argv[i], "--height") == 0)
+			height = value;
+		else if (strcmp(argv[i], "--amount") == 0)
+			amount = value;
+		else if (strcmp(argv[i], "--speed") == 0)
+			speed = value;
+		else if (strcmp(argv[i], "--frames") == 0)
+			frames = value;
+		else if (strcmp(argv[i], "--fps") == 0)
+			fps = value;
+		else if (strcmp(argv[i], "--physics") == 0)
+			physics = value;
+		else if (strcmp(argv[i], "--clears") == 0)
+			clears = value;
+		else if (strcmp(argv[i], "--banded") == 0)
+			banded = value != 0;
+		else if (strcmp(argv[i], "--threads") == 0)
+			threads = value;
+		else if (strcmp(argv[i], "--budget") == 0)
+			budget = value;
+		else if (strcmp(argv[i], "--trace") == 0)
+			tracePath = argv[i + 1];
+		else if (strcmp(argv[i], "--snapshot") == 0)
+			snapshotPath = argv[i + 1];
+		else if (strcmp(argv[i], "--at") == 0)
+			snapshotAt = value;
+		else if (strcmp(argv[i], "--replay") == 0)
+			replayPath = argv[i + 1];
+		else if (strcmp(argv[i], "--repeat") == 0)
+			repeat = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (width < 1 || height < 1 || frames < 1 || fps < 1 || physics < 0
+			|| clears < 0 || threads < 0
+			|| amount < 1 || budget < 0
+			|| speed < kMinSpeed || speed > kMaxSpeed
+			|| repeat < 1 || snapshotAt >= frames)
+		usage(argv[0]);
+	
+	if (replayPath != NULL)
+		return replay(replayPath, frames, fps, repeat, threads);
+	
+	uint8* bits = new uint8[width * height * 4];
+	FLBuffer buffer(bits, width, height, width * 4);
+	
+	ShapeSprites sprites;
+	FLField field(&sprites);
+	field.SetAmount(amount);
+	field.SetSpeed(speed);
+	field.SetWorkerCount(threads);
+	field.SetCachePath(cache);
+	field.SetBanded(banded);
+	
+	FrameTrace trace;
+	trace.SetEnabled(tracePath != NULL);
+	field.SetTrace(&trace);
+	
+	bigtime_t started = monotonic_time();
+	field.Start(width, height, seed);
+	bigtime_t firstFrame = 0;
+	bigtime_t spritesReady = 0;
+	
+	FLPacer pacer(kStepTime, 10000, 50000);
+	FLGovernor governor(budget);
+	governor.Reset(amount, kMinAmount);
+	bigtime_t* times = new bigtime_t[frames];
+	
+	// Without a frame to save before, the state before the slowest
+	// frame is saved, like the screensaver does. The snapshot is
+	// taken once here, so it has all of its memory from then on.
+	Snapshot snapshot(kSnapshotType, kSnapshotVersion);
+	field.WriteSnapshot(snapshot);
+	pacer.WriteSnapshot(snapshot);
+	bigtime_t slowest = -1;
+	int32 savedFrame = -1;
+	
+	int64 allocations = sAllocations;
+	int64 drawn = 0;
+	int64 culled = 0;
+	int64 waiting = 0;
+	
+	for (int32 frame = 0; frame < frames; frame++) {
+		if (snapshotPath != NULL && (snapshotAt < 0 || frame == snapshotAt)) {
+			snapshot.MakeEmpty();
+			field.WriteSnapshot(snapshot);
+			pacer.WriteSnapshot(snapshot);
+		}
+		
+		bigtime_t start = monotonic_time();
+		trace.BeginFrame();
+		
+		// The frames are shown at a steady, simulated rate,
+		// so the leaves end up in the same place on every run
+		{
+			TRACE_SCOPE(&trace, "update");
+			int32 steps = pacer.Advance((bigtime_t)frame * 1000000 / fps);
+			for (int32 i = 0; i < steps; i++)
+				field.Step();
+		}
+		field.Draw(&buffer, pacer.Alpha());
+		trace.EndFrame();
+		drawn += field.CountDrawn();
+		culled += field.CountCulled();
+		waiting += field.CountWaiting();
+		
+		bigtime_t done = monotonic_time();
+		if (frame == 0)
+			firstFrame = done - started;
+		if (spritesReady == 0 && field.SpritesReady())
+			spritesReady = done - started;
+		
+		times[frame] = done - start;
+		pacer.FrameDone(times[frame]);
+		
+		if (snapshotPath != NULL && (snapshotAt < 0
+				? times[frame] > slowest : frame == snapshotAt)) {
+			slowest = times[frame];
+			savedFrame = frame;
+			if (snapshot.WriteFile(snapshotPath) != B_OK)
+				fprintf(stderr, "Could not write the snapshot to %s\n",
+					snapshotPath);
+		}
+		
+		// Only with a budget, the measured times
+		// would make every run different
+		if (budget > 0 && governor.FrameDone(times[frame])) {
+			field.SetAmount(governor.Amount());
+			field.SetSmooth(governor.Smooth());
+		}
+	}
+	
+	allocations = sAllocations - allocations;
+	
+	if (spritesReady == 0) {
+		field.WaitForSprites();
+		spritesReady = monotonic_time() - started;
+	}
+	
+	std::sort(times, times + frames);
+	
+	printf("FallLeaves headless: %dx%d, amount %d, speed %d, seed %u, "
+		"%d frames at %d fps\n", (int)width, (int)height, (int)amount,
+		(int)speed, (unsigned)seed, (int)frames, (int)fps);
+	printf("frame time (us): p50 %lld  p90 %lld  p99 %lld  max %lld\n",
+		(long long)percentile(times, frames, 50),
+		(long long)percentile(times, frames, 90),
+		(long long)percentile(times, frames, 99),
+		(long long)times[frames - 1]);
+	printf("steps: %lld  overruns: %lld  dropped: %lld  suggested tick: "
+		"%lld us\n", (long long)pacer.Steps(), (long long)pacer.Overruns(),
+		(long long)pacer.DroppedFrames(), (long long)pacer.TickSize());
+	printf("startup with %d worker threads: first frame after %lld us, all "
+		"leaf images after %lld us\n", (int)threads, (long long)firstFrame,
+		(long long)spritesReady);
+	if (cache != NULL) {
+		printf("leaf images from the cache: %d of %d\n",
+			(int)field.CountCachedSprites(), (int)kNumLeafTypes);
+	}
+	printf("leaves drawn: %lld  skipped off screen: %lld (%.1f%%)  "
+		"waiting for images: %lld\n", (long long)drawn, (long long)culled,
+		drawn + culled > 0 ? 100.0 * culled / (drawn + culled) : 0.0,
+		(long long)waiting);
+	if (budget > 0) {
+		printf("budget %d us: average frame %lld us, %d of %d leaves, "
+			"%s, %lld decreases, %lld increases\n", (int)budget,
+			(long long)governor.AverageCost(), (int)governor.Amount(),
+			(int)amount, governor.Smooth() ? "smooth" : "not smooth",
+			(long long)governor.Decreases(), (long long)governor.Increases());
+	}
+	if (tracePath != NULL) {
+		char summary[256];
+		trace.GetSummary(summary, sizeof(summary));
+		printf("trace of the last %d frames: %s\n", (int)trace.CountFrames(),
+			summary);
+		if (trace.DumpChromeTrace(tracePath) != B_OK)
+			fprintf(stderr, "Could not write the trace to %s\n", tracePath);
+	}
+	if (savedFrame >= 0) {
+		printf("snapshot before frame %d (%lld us) saved to %s\n",
+			(int)savedFrame, (long long)slowest, snapshotPath);
+	}
+	printf("sprite memory: %lld bytes\n", (long long)field.SpriteBytes());
+	printf("allocations while running: %lld\n", (long long)allocations);
+	printf("checksum: 0x%08x\n", (unsigned)checksum(buffer));
+	
+	if (physics > 0)
+		physics_benchmark(physics, width, height, speed, seed, frames);
+	if (clears > 0)
+		buffer_benchmark(clears, width, height, amount, speed, seed);
+	
+	delete[] times;
+	delete[] bits;
+	
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ShapeSprites.h"
+
+#include <math.h>
+
+#include "FLSprite.h"
+#include "FLSpriteCache.h"
+
+
+// Orange 1, orange 2, green 1, green 2, red 1, red 2
+static const uint32 kLeafColors[kNumLeafTypes] = {
+	0xffda4c05, 0xfff7702e, 0xffdaa505, 0xffe3ff59, 0xffda0505, 0xfff72e2e
+};
+
+// Every pixel is sampled this many times in each direction
+static const int32 kSamples = 4;
+
+// Change this whenever the shape changes, so
+// cached images of the old one aren't used
+static const uint32 kShapeVersion = 1;
+
+
+static bool
+inside_leaf(float x, float y)
+{
+	// Turn the leaf 45 degrees, so it hangs from its
+	// stem in the top left corner
+	float u = (x + y) * 0.70710678f;
+	float v = (y - x) * 0.70710678f;
+	
+	// A pointed oval along the u axis...
+	if (u > 0.2f && u < 1.35f) {
+		float t = (u - 0.2f) / 1.15f;
+		float halfWidth = 0.32f * sinf(t * 3.14159265f);
+		if (fabsf(v) < halfWidth)
+			return true;
+	}
+	
+	// ...and a thin stem
+	return u >= 0.0f && u <= 0.25f && fabsf(v) < 0.03f;
+}
+
+
+void
+ShapeSprites::RenderSprite(int32 type, FLSprite* sprite)
+{
+	int32 width = sprite->Width();
+	uint32* pixels = sprite->Bits();
+	uint32 color = kLeafColors[type] & 0x00ffffff;
+	
+	for (int32 y = 0; y < width; y++) {
+		for (int32 x = 0; x < width; x++) {
+			int32 covered = 0;
+			for (int32 sy = 0; sy < kSamples; sy++) {
+				for (int32 sx = 0; sx < kSamples; sx++) {
+					float fx = (x + (sx + 0.5f) / kSamples) / width;
+					float fy = (y + (sy + 0.5f) / kSamples) / width;
+					if (inside_leaf(fx, fy))
+						covered++;
+				}
+			}
+			
+			uint32 alpha = (covered * 255) / (kSamples * kSamples);
+			pixels[y * width + x] = (alpha << 24) | color;
+		}
+	}
+	
+	sprite->Premultiply();
+}
+
+
+uint64
+ShapeSprites::SpriteHash(int32 type)
+{
+	uint32 data[2] = { kShapeVersion, kLeafColors[type] };
+	return FLSpriteCache::Hash(data, sizeof(data));
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SHAPESPRITES_H_
+#define _SHAPESPRITES_H_
+
+
+#include "FLField.h"
+
+
+/*	Stands in for the vector icons when there is no BIconUtils.
+	Each leaf type is a pointed oval with a stem in roughly the
+	colors of the real leaf images.
+*/
+class ShapeSprites : public FLSpriteSource
+{
+public:
+	void			RenderSprite(int32 type, FLSprite* sprite);
+	uint64			SpriteHash(int32 type);
+};
+
+
+#endif
@@ -0,0 +1,397 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ListModel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+ListModel::ListModel(ListSource* source, bool multipleSelection)
+	:
+	fSource(source),
+	fRowCount(source->CountRows()),
+	fMultiple(multipleSelection),
+	fSlots(NULL),
+	fSlotCount(0),
+	fPageRows(0),
+	fTopRow(0),
+	fMaterialized(0),
+	fRanges(NULL),
+	fRangeCount(0),
+	fRangeCapacity(0),
+	fAnchor(-1)
+{
+	// Empty
+}
+
+
+ListModel::~ListModel()
+{
+	SetVisibleRows(0);
+	free(fRanges);
+}
+
+
+void
+ListModel::Reload(const RowMapping* mapping)
+{
+	fRowCount = fSource->CountRows();
+	_ForgetRows();
+	ScrollTo(fTopRow);
+	
+	if (mapping != NULL)
+		_MapSelection(*mapping);
+	
+	// Drop the selected rows that aren't there anymore
+	while (fRangeCount > 0 && fRanges[fRangeCount - 1].first >= fRowCount)
+		fRangeCount--;
+	if (fRangeCount > 0 && fRanges[fRangeCount - 1].last >= fRowCount)
+		fRanges[fRangeCount - 1].last = fRowCount - 1;
+	if (fAnchor >= fRowCount)
+		fAnchor = -1;
+}
+
+
+void
+ListModel::SetVisibleRows(int32 count, bool partialRow)
+{
+	if (count < 0)
+		count = 0;
+	fPageRows = count;
+	if (partialRow)
+		count++;
+	if (count == fSlotCount) {
+		ScrollTo(fTopRow);
+		return;
+	}
+	
+	for (int32 i = 0; i < fSlotCount; i++)
+		free(fSlots[i].text);
+	delete[] fSlots;
+	
+	fSlots = count > 0 ? new slot[count] : NULL;
+	fSlotCount = count;
+	for (int32 i = 0; i < fSlotCount; i++) {
+		fSlots[i].row = -1;
+		fSlots[i].text = NULL;
+		fSlots[i].length = 0;
+		fSlots[i].capacity = 0;
+	}
+	
+	ScrollTo(fTopRow);
+}
+
+
+/*	Scrolling doesn't copy anything yet. The rows that stay in view
+	keep their slots, and the new ones are asked for when they are
+	drawn.
+*/
+void
+ListModel::ScrollTo(int32 top)
+{
+	int32 maxTop = MaxTopRow();
+	if (top > maxTop)
+		top = maxTop;
+	if (top < 0)
+		top = 0;
+	
+	fTopRow = top;
+}
+
+
+void
+ListModel::ScrollToRow(int32 row)
+{
+	if (row < fTopRow)
+		ScrollTo(row);
+	else if (row >= fTopRow + fPageRows)
+		ScrollTo(row - fPageRows + 1);
+}
+
+
+int32
+ListModel::MaxTopRow() const
+{
+	// At least the last row stays in view
+	int32 page = fPageRows > 0 ? fPageRows : 1;
+	return fRowCount > page ? fRowCount - page : 0;
+}
+
+
+/*	A row always has the same slot, so the slots of the rows that are
+	still shown after scrolling aren't touched.
+*/
+const char*
+ListModel::TextAt(int32 row, int32* _length)
+{
+	if (row < fTopRow || row >= fTopRow + fSlotCount || row >= fRowCount)
+		return NULL;
+	
+	slot& shown = fSlots[row % fSlotCount];
+	if (shown.row != row) {
+		int32 length = 0;
+		const char* text = fSource->RowText(row, &length);
+		if (text == NULL)
+			length = 0;
+		
+		if (length + 1 > shown.capacity) {
+			char* buffer = (char*)realloc(shown.text, length + 1);
+			if (buffer == NULL)
+				return NULL;
+			shown.text = buffer;
+			shown.capacity = length + 1;
+		}
+		
+		memcpy(shown.text, text, length);
+		shown.text[length] = '\0';
+		shown.length = length;
+		shown.row = row;
+		fMaterialized++;
+	}
+	
+	if (_length != NULL)
+		*_length = shown.length;
+	return shown.text;
+}
+
+
+bool
+ListModel::Select(int32 row, bool extend)
+{
+	if (row < 0 || row >= fRowCount)
+		return false;
+	
+	fAnchor = row;
+	if (extend && fMultiple)
+		return _AddRange(row, row);
+	return _SetRange(row, row);
+}
+
+
+bool
+ListModel::SelectRange(int32 from, int32 to, bool extend)
+{
+	if (from < 0 || to < 0 || from >= fRowCount || to >= fRowCount)
+		return false;
+	
+	// Only the last one, if there can only be one
+	if (!fMultiple)
+		return _SetRange(to, to);
+	
+	if (from > to) {
+		int32 swap = from;
+		from = to;
+		to = swap;
+	}
+	
+	if (extend)
+		return _AddRange(from, to);
+	return _SetRange(from, to);
+}
+
+
+bool
+ListModel::Deselect(int32 row)
+{
+	int32 index = _FindRange(row);
+	if (index >= fRangeCount || fRanges[index].first > row)
+		return false;
+	
+	range& selected = fRanges[index];
+	if (selected.first == selected.last) {
+		memmove(fRanges + index, fRanges + index + 1,
+			(fRangeCount - index - 1) * sizeof(range));
+		fRangeCount--;
+	} else if (row == selected.first)
+		selected.first++;
+	else if (row == selected.last)
+		selected.last--;
+	else {
+		// Split it in two
+		if (!_MakeRoom(1))
+			return false;
+		
+		range& split = fRanges[index];
+		memmove(fRanges + index + 1, fRanges + index,
+			(fRangeCount - index) * sizeof(range));
+		fRangeCount++;
+		split.last = row - 1;
+		fRanges[index + 1].first = row + 1;
+	}
+	
+	return true;
+}
+
+
+bool
+ListModel::DeselectAll()
+{
+	bool changed = fRangeCount > 0;
+	fRangeCount = 0;
+	return changed;
+}
+
+
+bool
+ListModel::IsSelected(int32 row) const
+{
+	int32 index = _FindRange(row);
+	return index < fRangeCount && fRanges[index].first <= row;
+}
+
+
+int32
+ListModel::CurrentSelection(int32 index) const
+{
+	if (index < 0)
+		return -1;
+	
+	for (int32 i = 0; i < fRangeCount; i++) {
+		int32 count = fRanges[i].last - fRanges[i].first + 1;
+		if (index < count)
+			return fRanges[i].first + index;
+		index -= count;
+	}
+	
+	return -1;
+}
+
+
+void
+ListModel::_ForgetRows()
+{
+	for (int32 i = 0; i < fSlotCount; i++)
+		fSlots[i].row = -1;
+}
+
+
+/*	Every range goes from where the first of its rows that is left went
+	to where the last one went. Rows that were inserted between them are
+	selected with them.
+*/
+void
+ListModel::_MapSelection(const RowMapping& mapping)
+{
+	int32 count = 0;
+	for (int32 i = 0; i < fRangeCount; i++) {
+		int32 first = fRanges[i].first;
+		int32 last = fRanges[i].last;
+		int32 newFirst = -1;
+		int32 newLast = -1;
+		while (first <= last && (newFirst = mapping.NewRow(first)) < 0)
+			first++;
+		while (last >= first && (newLast = mapping.NewRow(last)) < 0)
+			last--;
+		if (newFirst < 0 || newLast < 0)
+			continue;
+		
+		// With the rows between them removed, it can touch the one before
+		if (count > 0 && fRanges[count - 1].last + 1 >= newFirst)
+			fRanges[count - 1].last = newLast;
+		else {
+			fRanges[count].first = newFirst;
+			fRanges[count].last = newLast;
+			count++;
+		}
+	}
+	fRangeCount = count;
+	
+	if (fAnchor >= 0)
+		fAnchor = mapping.NewRow(fAnchor);
+}
+
+
+/*	The first range that ends at or after the row.
+*/
+int32
+ListModel::_FindRange(int32 row) const
+{
+	int32 low = 0;
+	int32 high = fRangeCount;
+	while (low < high) {
+		int32 middle = (low + high) / 2;
+		if (fRanges[middle].last < row)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+
+/*	Add the rows to the selection, joining the ranges they overlap or
+	touch.
+*/
+bool
+ListModel::_AddRange(int32 first, int32 last)
+{
+	// The ranges from "start" up to "end" are joined with the new one
+	int32 start = _FindRange(first > 0 ? first - 1 : 0);
+	int32 end = start;
+	while (end < fRangeCount && fRanges[end].first <= last + 1)
+		end++;
+	
+	if (end - start == 1 && fRanges[start].first <= first
+		&& fRanges[start].last >= last)
+		return false;
+	
+	if (start < end) {
+		if (fRanges[start].first < first)
+			first = fRanges[start].first;
+		if (fRanges[end - 1].last > last)
+			last = fRanges[end - 1].last;
+	} else if (!_MakeRoom(1))
+		return false;
+	
+	// Replace them by one
+	int32 removed = end - start;
+	memmove(fRanges + start + 1, fRanges + end,
+		(fRangeCount - end) * sizeof(range));
+	fRangeCount += 1 - removed;
+	fRanges[start].first = first;
+	fRanges[start].last = last;
+	
+	return true;
+}
+
+
+/*	Select only these rows.
+*/
+bool
+ListModel::_SetRange(int32 first, int32 last)
+{
+	if (fRangeCount == 1 && fRanges[0].first == first
+		&& fRanges[0].last == last)
+		return false;
+	if (!_MakeRoom(1))
+		return false;
+	
+	fRanges[0].first = first;
+	fRanges[0].last = last;
+	fRangeCount = 1;
+	return true;
+}
+
+
+bool
+ListModel::_MakeRoom(int32 ranges)
+{
+	if (fRangeCount + ranges <= fRangeCapacity)
+		return true;
+	
+	int32 capacity = fRangeCapacity > 0 ? fRangeCapacity * 2 : 8;
+	while (capacity < fRangeCount + ranges)
+		capacity *= 2;
+	
+	range* grown = (range*)realloc(fRanges, capacity * sizeof(range));
+	if (grown == NULL)
+		return false;
+	
+	fRanges = grown;
+	fRangeCapacity = capacity;
+	return true;
+}
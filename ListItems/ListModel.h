@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _LISTMODEL_H_
+#define _LISTMODEL_H_
+
+
+#include "PortableDefs.h"
+#include "StringArena.h"
+
+
+/*	Where the rows of a ListModel come from. The text of a row is only
+	asked for when the row is shown.
+*/
+class ListSource
+{
+public:
+	virtual					~ListSource() {};
+	
+	virtual int32			CountRows() = 0;
+	virtual const char*		RowText(int32 row, int32* _length) = 0;
+								// Only has to stay valid until the next
+								// call
+};
+
+
+/*	Where the rows that were there before a change of a ListSource went.
+*/
+class RowMapping
+{
+public:
+	virtual					~RowMapping() {};
+	
+	virtual int32			NewRow(int32 oldRow) const = 0;
+								// -1 if the row was removed
+};
+
+
+/*	The strings of a StringArena as rows.
+*/
+class ArenaSource : public ListSource
+{
+public:
+							ArenaSource(const StringArena& arena)
+								: fArena(arena) {};
+	
+	virtual int32			CountRows() { return fArena.CountStrings(); };
+	virtual const char*		RowText(int32 row, int32* _length)
+								{ return fArena.StringAt(row, _length); };
+	
+private:
+	const StringArena&		fArena;
+};
+
+
+/*	What a list view shows of a list with any number of rows, without
+	an item for every row. Only the rows that are shown are asked for
+	and copied, into as many slots as there are shown rows, and the
+	selection is kept as ranges of rows. Scrolling and selecting
+	takes as long for ten rows as for ten million.
+*/
+class ListModel
+{
+public:
+							ListModel(ListSource* source,
+								bool multipleSelection = false);
+							~ListModel();
+	
+	ListSource*				Source() const { return fSource; };
+	int32					CountRows() const { return fRowCount; };
+	void					Reload(const RowMapping* mapping = NULL);
+								// After the rows of the source changed,
+								// forgets the copied rows and the
+								// selected rows that are gone. With a
+								// mapping, the selection moves along
+								// with the rows.
+	
+	void					SetVisibleRows(int32 count,
+								bool partialRow = false);
+								// How many rows fit, and whether part of
+								// one more is shown below them
+	int32					VisibleRows() const { return fPageRows; };
+	void					ScrollTo(int32 top);
+	void					ScrollToRow(int32 row);
+								// Only as far as needed to show the row
+	int32					TopRow() const { return fTopRow; };
+	int32					MaxTopRow() const;
+	const char*				TextAt(int32 row, int32* _length = NULL);
+								// Of a shown row, NULL for the others
+	
+	bool					Select(int32 row, bool extend = false);
+	bool					SelectRange(int32 from, int32 to,
+								bool extend = false);
+	bool					Deselect(int32 row);
+	bool					DeselectAll();
+								// They return whether the selection
+								// changed. With "extend", the rows are
+								// added to the selection if there can be
+								// more than one.
+	bool					IsSelected(int32 row) const;
+	int32					CurrentSelection(int32 index = 0) const;
+								// Like BListView, the index-th selected
+								// row, or -1
+	int32					Anchor() const { return fAnchor; };
+								// The row last selected on its own, to
+								// extend the selection from
+	
+	int64					CountMaterialized() const
+								{ return fMaterialized; };
+								// How many rows were asked for in all
+	
+private:
+	struct slot {
+		int32				row;
+		char*				text;
+		int32				length;
+		int32				capacity;
+	};
+	
+	struct range {
+		int32				first;
+		int32				last;
+	};
+	
+	void					_ForgetRows();
+	void					_MapSelection(const RowMapping& mapping);
+	int32					_FindRange(int32 row) const;
+	bool					_AddRange(int32 first, int32 last);
+	bool					_SetRange(int32 first, int32 last);
+	bool					_MakeRoom(int32 ranges);
+	
+	ListSource*				fSource;
+	int32					fRowCount;
+	bool					fMultiple;
+	
+	slot*					fSlots;
+	int32					fSlotCount;
+	int32					fPageRows;
+	int32					fTopRow;
+	int64					fMaterialized;
+	
+	range*					fRanges;
+								// Sorted, and never touching each other
+	int32					fRangeCount;
+	int32					fRangeCapacity;
+	int32					fAnchor;
+};
+
+
+#endif
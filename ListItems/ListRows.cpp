@@ -0,0 +1,455 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ListRows.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+
+// For the same row, what is inserted before it comes first, and then
+// what happens to the row itself
+enum {
+	kInsert = 0,
+	kSetText,
+	kRemove
+};
+
+// The text is compacted once more of it isn't used anymore than is,
+// but not while there is only a little of it
+static const size_t kMinUnusedBytes = 65536;
+
+
+ListRows::ListRows()
+	:
+	fText(new StringArena()),
+	fOrder(NULL),
+	fCount(0),
+	fCapacity(0),
+	fUnusedBytes(0),
+	fListener(NULL),
+	fBatchLevel(0),
+	fBatchRows(0),
+	fOperations(NULL),
+	fOperationCount(0),
+	fOperationCapacity(0),
+	fInserted((inserted*)malloc(sizeof(inserted))),
+	fInsertedCount(0),
+	fRemoved((int32*)malloc(sizeof(int32))),
+	fRemovedCount(0)
+{
+	// Empty
+}
+
+
+ListRows::~ListRows()
+{
+	delete fText;
+	free(fOrder);
+	free(fOperations);
+	free(fInserted);
+	free(fRemoved);
+}
+
+
+const char*
+ListRows::RowText(int32 row, int32* _length)
+{
+	if (row < 0 || row >= fCount)
+		return NULL;
+	return fText->StringAt(fOrder[row], _length);
+}
+
+
+status_t
+ListRows::AddRow(const char* text, int32 length)
+{
+	if (IsBatching())
+		return _Record(kInsert, fBatchRows, text, length);
+	
+	int32 index = fText->Add(text, length);
+	if (index < 0 || !_MakeRoom(1))
+		return B_NO_MEMORY;
+	
+	fOrder[fCount++] = index;
+	_SetMapping(fCount - 1, -1);
+	_Changed();
+	return B_OK;
+}
+
+
+status_t
+ListRows::InsertRow(int32 row, const char* text, int32 length)
+{
+	if (IsBatching()) {
+		if (row < 0 || row > fBatchRows)
+			return B_BAD_VALUE;
+		return _Record(kInsert, row, text, length);
+	}
+	
+	if (row < 0 || row > fCount)
+		return B_BAD_VALUE;
+	
+	int32 index = fText->Add(text, length);
+	if (index < 0 || !_MakeRoom(1))
+		return B_NO_MEMORY;
+	
+	memmove(fOrder + row + 1, fOrder + row,
+		(fCount - row) * sizeof(int32));
+	fOrder[row] = index;
+	fCount++;
+	_SetMapping(row, -1);
+	_Changed();
+	return B_OK;
+}
+
+
+status_t
+ListRows::RemoveRow(int32 row)
+{
+	if (IsBatching()) {
+		if (row < 0 || row >= fBatchRows)
+			return B_BAD_VALUE;
+		return _Record(kRemove, row, NULL, 0);
+	}
+	
+	if (row < 0 || row >= fCount)
+		return B_BAD_VALUE;
+	
+	_ForgetText(fOrder[row]);
+	memmove(fOrder + row, fOrder + row + 1,
+		(fCount - row - 1) * sizeof(int32));
+	fCount--;
+	_SetMapping(-1, row);
+	_Changed();
+	return B_OK;
+}
+
+
+status_t
+ListRows::SetRowText(int32 row, const char* text, int32 length)
+{
+	if (IsBatching()) {
+		if (row < 0 || row >= fBatchRows)
+			return B_BAD_VALUE;
+		return _Record(kSetText, row, text, length);
+	}
+	
+	if (row < 0 || row >= fCount)
+		return B_BAD_VALUE;
+	
+	int32 index = fText->Add(text, length);
+	if (index < 0)
+		return B_NO_MEMORY;
+	
+	_ForgetText(fOrder[row]);
+	fOrder[row] = index;
+	_SetMapping(-1, -1);
+	_Changed();
+	return B_OK;
+}
+
+
+status_t
+ListRows::Reserve(int32 rows, size_t bytes)
+{
+	if (fText->Reserve(rows, bytes) != B_OK || !_MakeRoom(rows))
+		return B_NO_MEMORY;
+	return B_OK;
+}
+
+
+void
+ListRows::BeginBatch()
+{
+	if (fBatchLevel++ > 0)
+		return;
+	
+	fBatchRows = fCount;
+	fOperationCount = 0;
+}
+
+
+status_t
+ListRows::CommitBatch()
+{
+	if (fBatchLevel == 0)
+		return B_BAD_VALUE;
+	if (--fBatchLevel > 0)
+		return B_OK;
+	
+	status_t status = _Apply();
+	fOperationCount = 0;
+	return status;
+}
+
+
+int32
+ListRows::NewRow(int32 oldRow) const
+{
+	if (oldRow < 0)
+		return -1;
+	
+	// How many rows before it were removed, and whether it was
+	int32 removed = std::lower_bound(fRemoved, fRemoved + fRemovedCount,
+		oldRow) - fRemoved;
+	if (removed < fRemovedCount && fRemoved[removed] == oldRow)
+		return -1;
+	
+	// How many rows were inserted before it
+	int32 low = 0;
+	int32 high = fInsertedCount;
+	while (low < high) {
+		int32 middle = (low + high) / 2;
+		if (fInserted[middle].row <= oldRow)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	int32 inserted = low > 0 ? fInserted[low - 1].total : 0;
+	
+	return oldRow - removed + inserted;
+}
+
+
+bool
+ListRows::_CompareOperations(const operation& a, const operation& b)
+{
+	if (a.row != b.row)
+		return a.row < b.row;
+	if (a.kind != b.kind)
+		return a.kind < b.kind;
+	return a.order < b.order;
+}
+
+
+/*	The text is added right away, only where it goes waits for the batch
+	to be committed.
+*/
+status_t
+ListRows::_Record(int32 kind, int32 row, const char* text, int32 length)
+{
+	if (fOperationCount == fOperationCapacity) {
+		int32 capacity = fOperationCapacity > 0
+			? fOperationCapacity * 2 : 64;
+		operation* grown = (operation*)realloc(fOperations,
+			capacity * sizeof(operation));
+		if (grown == NULL)
+			return B_NO_MEMORY;
+		fOperations = grown;
+		fOperationCapacity = capacity;
+	}
+	
+	int32 index = -1;
+	if (text != NULL) {
+		index = fText->Add(text, length);
+		if (index < 0)
+			return B_NO_MEMORY;
+	}
+	
+	operation& recorded = fOperations[fOperationCount];
+	recorded.row = row;
+	recorded.kind = kind;
+	recorded.text = index;
+	recorded.order = fOperationCount++;
+	return B_OK;
+}
+
+
+/*	Makes all of the changes of the batch in one go through the rows,
+	sorted by the row they happen at. The rows in between are copied
+	as they are.
+*/
+status_t
+ListRows::_Apply()
+{
+	if (fOperationCount == 0)
+		return B_OK;
+	
+	operation* operations = fOperations;
+	int32 count = fOperationCount;
+	std::sort(operations, operations + count, &_CompareOperations);
+	
+	int32 insertCount = 0;
+	int32 removeCount = 0;
+	for (int32 i = 0; i < count; i++) {
+		if (operations[i].kind == kInsert)
+			insertCount++;
+		else if (operations[i].kind == kRemove && (i == 0
+				|| operations[i - 1].kind != kRemove
+				|| operations[i - 1].row != operations[i].row))
+			removeCount++;
+	}
+	
+	int32 newCount = fBatchRows + insertCount - removeCount;
+	int32* order = (int32*)malloc((newCount > 0 ? newCount : 1)
+		* sizeof(int32));
+	inserted* insertedRows = (inserted*)realloc(fInserted,
+		(insertCount > 0 ? insertCount : 1) * sizeof(inserted));
+	if (insertedRows != NULL)
+		fInserted = insertedRows;
+	int32* removedRows = (int32*)realloc(fRemoved,
+		(removeCount > 0 ? removeCount : 1) * sizeof(int32));
+	if (removedRows != NULL)
+		fRemoved = removedRows;
+	if (order == NULL || insertedRows == NULL || removedRows == NULL) {
+		free(order);
+		_SetMapping(-1, -1);
+		return B_NO_MEMORY;
+	}
+	
+	int32 copied = 0;
+	int32 written = 0;
+	int32 totalInserted = 0;
+	fInsertedCount = 0;
+	fRemovedCount = 0;
+	
+	for (int32 next = 0; next < count;) {
+		int32 row = operations[next].row;
+		memcpy(order + written, fOrder + copied,
+			(row - copied) * sizeof(int32));
+		written += row - copied;
+		copied = row;
+		
+		// What is inserted before the row
+		int32 before = totalInserted;
+		while (next < count && operations[next].row == row
+			&& operations[next].kind == kInsert) {
+			order[written++] = operations[next++].text;
+			totalInserted++;
+		}
+		if (totalInserted > before) {
+			fInserted[fInsertedCount].row = row;
+			fInserted[fInsertedCount++].total = totalInserted;
+		}
+		
+		// What happens to the row itself
+		if (next == count || operations[next].row != row)
+			continue;
+		
+		int32 text = fOrder[row];
+		bool removed = false;
+		for (; next < count && operations[next].row == row; next++) {
+			if (operations[next].kind == kSetText) {
+				_ForgetText(text);
+				text = operations[next].text;
+			} else
+				removed = true;
+		}
+		
+		if (removed) {
+			_ForgetText(text);
+			fRemoved[fRemovedCount++] = row;
+		} else
+			order[written++] = text;
+		copied = row + 1;
+	}
+	
+	memcpy(order + written, fOrder + copied,
+		(fBatchRows - copied) * sizeof(int32));
+	
+	free(fOrder);
+	fOrder = order;
+	fCount = newCount;
+	fCapacity = newCount > 0 ? newCount : 1;
+	
+	_Changed();
+	return B_OK;
+}
+
+
+bool
+ListRows::_MakeRoom(int32 rows)
+{
+	if (fCount + rows <= fCapacity)
+		return true;
+	
+	int32 capacity = fCapacity > 0 ? fCapacity * 2 : 64;
+	while (capacity < fCount + rows)
+		capacity *= 2;
+	
+	int32* grown = (int32*)realloc(fOrder, capacity * sizeof(int32));
+	if (grown == NULL)
+		return false;
+	
+	fOrder = grown;
+	fCapacity = capacity;
+	return true;
+}
+
+
+void
+ListRows::_ForgetText(int32 text)
+{
+	int32 length;
+	if (fText->StringAt(text, &length) != NULL)
+		fUnusedBytes += length + 1;
+}
+
+
+/*	Copies the text of the rows in their order to a new arena, without
+	the text nobody uses anymore. If there isn't enough memory for it,
+	it stays as it is.
+*/
+void
+ListRows::_Compact()
+{
+	StringArena* text = new StringArena();
+	if (text->Reserve(fCount, fText->UsedBytes() - fUnusedBytes) != B_OK) {
+		delete text;
+		return;
+	}
+	
+	for (int32 i = 0; i < fCount; i++) {
+		int32 length;
+		const char* rowText = fText->StringAt(fOrder[i], &length);
+		if (text->Add(rowText, length) < 0) {
+			delete text;
+			return;
+		}
+	}
+	
+	for (int32 i = 0; i < fCount; i++)
+		fOrder[i] = i;
+	
+	delete fText;
+	fText = text;
+	fUnusedBytes = 0;
+}
+
+
+/*	For a single change.
+*/
+void
+ListRows::_SetMapping(int32 insertedAt, int32 removed)
+{
+	fInsertedCount = 0;
+	fRemovedCount = 0;
+	
+	if (insertedAt >= 0) {
+		fInserted[0].row = insertedAt;
+		fInserted[0].total = 1;
+		fInsertedCount = 1;
+	}
+	if (removed >= 0) {
+		fRemoved[0] = removed;
+		fRemovedCount = 1;
+	}
+}
+
+
+void
+ListRows::_Changed()
+{
+	if (fUnusedBytes > kMinUnusedBytes
+		&& fUnusedBytes > fText->UsedBytes() / 2)
+		_Compact();
+	
+	if (fListener != NULL)
+		fListener->RowsChanged(this);
+}
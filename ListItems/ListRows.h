@@ -0,0 +1,132 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _LISTROWS_H_
+#define _LISTROWS_H_
+
+
+#include <stddef.h>
+
+#include "ListModel.h"
+#include "PortableDefs.h"
+#include "StringArena.h"
+
+
+class ListRows;
+
+
+/*	Told when the rows of a ListRows changed, to reload the views that
+	show them.
+*/
+class RowsListener
+{
+public:
+	virtual					~RowsListener() {};
+	
+	virtual void			RowsChanged(ListRows* rows) = 0;
+								// The rows are also the mapping of where
+								// the rows that were there before went
+};
+
+
+/*	Rows that can be added, inserted, removed and changed, with their
+	text in a StringArena. Every change tells the listener on its own,
+	like adding an item to a BListView lays it out and invalidates it
+	right away, unless it is made between BeginBatch() and
+	CommitBatch(). Those changes are only collected, and the rows stay
+	as they were until they are all made at once, and the listener is
+	told once.
+
+	In a batch, rows are counted the way they were when it began: a row
+	is inserted before the row that was there, and a row that is
+	removed or changed is one of the rows that were there, no matter
+	what was inserted or removed before it in the batch.
+*/
+class ListRows : public ListSource, public RowMapping
+{
+public:
+							ListRows();
+	virtual					~ListRows();
+	
+	void					SetListener(RowsListener* listener)
+								{ fListener = listener; };
+	
+	virtual int32			CountRows() { return fCount; };
+	virtual const char*		RowText(int32 row, int32* _length);
+	
+	status_t				AddRow(const char* text, int32 length = -1);
+	status_t				InsertRow(int32 row, const char* text,
+								int32 length = -1);
+	status_t				RemoveRow(int32 row);
+	status_t				SetRowText(int32 row, const char* text,
+								int32 length = -1);
+	status_t				Reserve(int32 rows, size_t bytes);
+	
+	void					BeginBatch();
+	status_t				CommitBatch();
+								// Batches can be nested, the changes are
+								// made when the outermost one is
+								// committed
+	bool					IsBatching() const
+								{ return fBatchLevel > 0; };
+	
+	virtual int32			NewRow(int32 oldRow) const;
+								// Of the last change, or the last batch
+	
+	size_t					UnusedBytes() const { return fUnusedBytes; };
+								// Of the text of rows that were changed
+								// or removed, until it is compacted
+	
+private:
+	struct operation {
+		int32				row;
+		int32				kind;
+		int32				text;
+		int32				order;
+	};
+	
+	struct inserted {
+		int32				row;
+		int32				total;
+								// Of the rows inserted before this one,
+								// with these
+	};
+	
+	static bool				_CompareOperations(const operation& a,
+								const operation& b);
+	
+	status_t				_Record(int32 kind, int32 row, const char* text,
+								int32 length);
+	status_t				_Apply();
+	bool					_MakeRoom(int32 rows);
+	void					_ForgetText(int32 text);
+	void					_Compact();
+	void					_SetMapping(int32 insertedAt, int32 removed);
+	void					_Changed();
+	
+	StringArena*			fText;
+	int32*					fOrder;
+								// The text of every row
+	int32					fCount;
+	int32					fCapacity;
+	size_t					fUnusedBytes;
+	RowsListener*			fListener;
+	
+	int32					fBatchLevel;
+	int32					fBatchRows;
+								// How many rows there were when the batch
+								// began
+	operation*				fOperations;
+	int32					fOperationCount;
+	int32					fOperationCapacity;
+	
+	inserted*				fInserted;
+	int32					fInsertedCount;
+	int32*					fRemoved;
+	int32					fRemovedCount;
+								// Sorted, for NewRow()
+};
+
+
+#endif
@@ -1,18 +1,32 @@
 #include "MainWindow.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <Button.h>
-#include <ListItem.h>
+#include <MessageRunner.h>
 #include <ScrollView.h>
 
+#include "SportRows.h"
+
 enum
 {
 	M_RESET_WINDOW = 'rswn',
-	M_SET_TITLE = 'sttl'
+	M_SET_TITLE = 'sttl',
+	M_FIND = 'find',
+	M_INDEX_READY = 'idxr',
+	M_FLUSH_UPDATES = 'flup'
 };
 
 MainWindow::MainWindow(void)
 	:	BWindow(BRect(100,100,500,400),"The Weird World of Sports",B_TITLED_WINDOW,
-				B_ASYNCHRONOUS_CONTROLS | B_QUIT_ON_WINDOW_CLOSE)
+				B_ASYNCHRONOUS_CONTROLS | B_QUIT_ON_WINDOW_CLOSE),
+		fFiltered(&fSports),
+		fIndex(NULL),
+		fBuiltIndex(NULL),
+		fIndexing(false),
+		fIndexStale(false),
+		fRowsLock("sport rows"),
+		fCoalescer(this)
 {
 	// Here we will make a BView that covers the white area so that we can set the
 	// "background color"
@@ -37,8 +51,30 @@ MainWindow::MainWindow(void)
 	reset->MoveTo(Bounds().right - reset->Bounds().Width() - 10.0,
 					Bounds().bottom - reset->Bounds().Height() - 10.0);
 	
+	// The status line goes to the left of the button, and says how many rows there are and
+	// how many of them were found.
+	fStatusView = new BStringView(BRect(10.0,reset->Frame().top,reset->Frame().left - 10.0,
+									reset->Frame().bottom),"status","",
+									B_FOLLOW_LEFT_RIGHT | B_FOLLOW_BOTTOM);
+	top->AddChild(fStatusView);
+	
+	// A BTextControl is a label and a box to type in. Its modification message is sent every
+	// time that the text changes, so the list is filtered with every letter that is typed. It
+	// stays disabled until the rows have been indexed.
+	fFindField = new BTextControl(BRect(10.0,10.0,Bounds().right - 10.0,30.0),"findfield",
+									"Find:","",NULL,B_FOLLOW_LEFT_RIGHT | B_FOLLOW_TOP);
+	fFindField->SetModificationMessage(new BMessage(M_FIND));
+	fFindField->SetEnabled(false);
+	top->AddChild(fFindField);
+	
+	float width, height;
+	fFindField->GetPreferredSize(&width,&height);
+	fFindField->ResizeTo(Bounds().Width() - 20.0,height);
+	fFindField->SetDivider(fFindField->StringWidth("Find:") + 5.0);
+	
 	r = Bounds();
 	r.InsetBy(10.0,10.0);
+	r.top = fFindField->Frame().bottom + 10.0;
 	
 	// When working with BScrollViews, you must compensate for the width/height of the scrollbars.
 	// B_V_SCROLL_BAR_WIDTH is a defined constant for the width of the vertical scroll bar.
@@ -46,13 +82,17 @@ MainWindow::MainWindow(void)
 	
 	// Frame() works like Bounds() except that it returns the size and location of the control
 	// in the coordinate space of the parent view. This will make fListView's bottom stop 10
-	// pixels above the button.
-	r.bottom = reset->Frame().top - 10.0 - B_H_SCROLL_BAR_HEIGHT;
+	// pixels above the button. Our list has no horizontal scroll bar, because its rows are
+	// never wider than the list.
+	r.bottom = reset->Frame().top - 10.0;
 	
-	// Most of these parameters are exactly the same as for BView except that we can also
-	// specify whether the user is able to select just 1 item in the list or multiple items by
-	// clicking on items while holding a modifier key on the keyboard.
-	fListView = new BListView(r,"sportlist",B_SINGLE_SELECTION_LIST,B_FOLLOW_ALL);
+	// A BListView needs a BListItem object for every row, which is fine for a handful of rows,
+	// but not for millions of them. Our VirtualListView only asks its source for the rows it
+	// shows, and our ListRows hands them out of a StringArena, which keeps the text of all of
+	// the rows in one block of memory. Like with a BListView, we can also specify whether the
+	// user is able to select just 1 item in the list or multiple items by clicking on items
+	// while holding a modifier key on the keyboard.
+	fListView = new VirtualListView(r,"sportlist",&fFiltered,false,B_FOLLOW_ALL);
 	
 	// We didn't call AddChild on fListView because our BScrollView will do that for us. When
 	// created, it creates scrollbars and targets the specified view for any scrolling they do.
@@ -60,19 +100,168 @@ MainWindow::MainWindow(void)
 	
 	// If we call AddChild on fListView before we create this scrollview, our program will drop
 	// to the debugger when we call AddChild on the BScrollView -- a BView can have only one parent.
-	BScrollView *scrollView = new BScrollView("scrollview",fListView, B_FOLLOW_ALL, 0,true,true);
+	BScrollView *scrollView = new BScrollView("scrollview",fListView, B_FOLLOW_ALL, 0,false,true);
 	top->AddChild(scrollView);
 	
-	// A BListView's selection message is sent to the window any time that the list's selection
-	// changes.
+	// The list's selection message is sent to the window any time that the list's selection
+	// changes, just like with a BListView.
 	fListView->SetSelectionMessage(new BMessage(M_SET_TITLE));
 	
-	fListView->AddItem(new BStringItem("Toe Wrestling"));
-	fListView->AddItem(new BStringItem("Electric Toilet Racing"));
-	fListView->AddItem(new BStringItem("Bog Snorkeling"));
-	fListView->AddItem(new BStringItem("Chess Boxing"));
-	fListView->AddItem(new BStringItem("Cheese Rolling"));
-	fListView->AddItem(new BStringItem("Unicycle Polo"));
+	// Our six sports, or as many more made up ones as the LISTITEMS_ROWS environment variable
+	// asks for, to see that a list with ten million rows scrolls just as well.
+	int32 rows = 6;
+	const char *rowsVariable = getenv("LISTITEMS_ROWS");
+	if (rowsVariable && atoi(rowsVariable) > rows)
+		rows = atoi(rowsVariable);
+	
+	// Adding an item to a BListView lays out and redraws the list right away, and so does
+	// adding a row to our ListRows, which tells us so that we reload the list. Between
+	// BeginBatch() and CommitBatch() the rows are only collected, and then all added at once,
+	// so that the list is reloaded only once. Once they are added, RowsChanged() starts
+	// indexing them.
+	fSports.SetListener(this);
+	BeginRowChanges();
+	add_sport_rows(fSports,rows);
+	CommitRowChanges();
+}
+
+
+MainWindow::~MainWindow(void)
+{
+	// The thread may still be indexing when the window is closed right away, or it may be
+	// done, but the window never got its message.
+	if (fIndexing)
+		pthread_join(fIndexThread,NULL);
+	delete fBuiltIndex;
+	
+	fFiltered.SetIndex(NULL);
+	delete fIndex;
+	
+	// Run it with MESSAGE_STATS=1 from a Terminal to see how many of the selection messages
+	// were dropped because a newer one came within the same frame.
+	if (getenv("MESSAGE_STATS"))
+		fCoalescer.PrintStatistics("ListItems M_SET_TITLE");
+}
+
+
+void *
+MainWindow::BuildIndex(void *data)
+{
+	MainWindow *window = (MainWindow*)data;
+	SearchIndex *index = new SearchIndex();
+	
+	// The window can't change the rows while we read them.
+	window->fRowsLock.Lock();
+	status_t status = index->SetTo(&window->fSports);
+	window->fRowsLock.Unlock();
+	
+	// The index is handed over in fBuiltIndex instead of in the message, so that the window
+	// can still delete it if it is closed before it gets the message. It doesn't look at it
+	// before it has joined us.
+	if (status != B_OK)
+	{
+		delete index;
+		index = NULL;
+	}
+	window->fBuiltIndex = index;
+	
+	window->PostMessage(M_INDEX_READY);
+	return NULL;
+}
+
+
+void
+MainWindow::StartIndexing(void)
+{
+	// Indexing millions of rows takes a few seconds, so it is done by a thread of its own,
+	// which tells the window when it is done. If the rows change before that, the index
+	// it makes is thrown away and they are indexed once more.
+	if (fIndexing)
+	{
+		fIndexStale = true;
+		return;
+	}
+	
+	fFindField->SetEnabled(false);
+	fStatusView->SetText("Getting ready to find rows...");
+	fIndexStale = false;
+	if (pthread_create(&fIndexThread,NULL,&BuildIndex,this) != 0)
+	{
+		// Without a thread there is no index, and nothing can be found.
+		ShowStatus();
+		return;
+	}
+	
+	fIndexing = true;
+}
+
+
+void
+MainWindow::BeginRowChanges(void)
+{
+	// The rows may only change between these two, and not while the index thread reads them,
+	// which can take a few seconds.
+	fRowsLock.Lock();
+	fSports.BeginBatch();
+}
+
+
+void
+MainWindow::CommitRowChanges(void)
+{
+	fSports.CommitBatch();
+	fRowsLock.Unlock();
+}
+
+
+void
+MainWindow::ShowStatus(void)
+{
+	char status[128];
+	if (fIndex == NULL)
+		snprintf(status,sizeof(status),"%d rows, not enough memory to find any",
+				(int)fSports.CountRows());
+	else if (!fFiltered.IsFiltering())
+		snprintf(status,sizeof(status),"%d rows",(int)fSports.CountRows());
+	else
+		snprintf(status,sizeof(status),"%d of %d rows, found in %.1f ms",
+				(int)fIndex->CountResults(),(int)fSports.CountRows(),
+				fIndex->LastSearchTime() / 1000.0);
+	
+	fStatusView->SetText(status);
+}
+
+
+void
+MainWindow::RowsChanged(ListRows *rows)
+{
+	// The rows are also where each of the rows that were there before went, so that the
+	// rows that were selected stay selected.
+	if (!fFiltered.IsFiltering())
+		fListView->Reload(rows);
+	else
+	{
+		// The list shows the rows that were found, but the index only knows the rows as
+		// they were, so we show all of them again, and the row that was selected stays
+		// selected.
+		int32 selected = fFiltered.SourceRow(fListView->CurrentSelection());
+		fListView->DeselectAll();
+		fFiltered.SetIndex(NULL);
+		fFindField->SetText("");
+		fListView->Reload();
+		
+		int32 row = selected >= 0 ? rows->NewRow(selected) : -1;
+		if (row >= 0)
+		{
+			fListView->Select(row);
+			fListView->ScrollToRow(row);
+		}
+	}
+	
+	fFiltered.SetIndex(NULL);
+	delete fIndex;
+	fIndex = NULL;
+	StartIndexing();
 }
 
 
@@ -86,22 +275,71 @@ MainWindow::MessageReceived(BMessage *msg)
 			fListView->DeselectAll();
 			break;
 		}
-		case M_SET_TITLE:
+		case M_INDEX_READY:
 		{
-			int32 selection = fListView->CurrentSelection();
+			pthread_join(fIndexThread,NULL);
+			fIndexing = false;
 			
-			if (selection < 0)
+			SearchIndex *index = fBuiltIndex;
+			fBuiltIndex = NULL;
+			if (fIndexStale)
 			{
-				// This code is here because when we press the Reset button, the selection
-				// changes and an M_SET_TITLE message is sent, but because nothing is
-				// selected, CurrentSelection() returns -1.
-				SetTitle("The Weird World of Sports");
+				// The rows changed after the thread read them
+				delete index;
+				StartIndexing();
 				break;
 			}
 			
-			BStringItem *item = dynamic_cast<BStringItem*>(fListView->ItemAt(selection));
-			if (item)
-				SetTitle(item->Text());
+			if (index != NULL)
+			{
+				fIndex = index;
+				fFiltered.SetIndex(fIndex);
+				fFindField->SetEnabled(true);
+				fFindField->MakeFocus(true);
+			}
+			ShowStatus();
+			break;
+		}
+		case M_FIND:
+		{
+			if (fIndex == NULL)
+				break;
+			
+			// The rows that are found are shown without making anything for them. The list
+			// only has to forget the rows it showed and ask fFiltered for the new ones. The
+			// row that was selected stays selected if it was found again.
+			int32 selected = fFiltered.SourceRow(fListView->CurrentSelection());
+			fListView->DeselectAll();
+			
+			fIndex->Search(fFindField->Text());
+			fListView->Reload();
+			fListView->ScrollToRow(0);
+			
+			int32 row = selected >= 0 ? fFiltered.RowOf(selected) : -1;
+			if (row >= 0)
+			{
+				fListView->Select(row);
+				fListView->ScrollToRow(row);
+			}
+			
+			ShowStatus();
+			break;
+		}
+		case M_SET_TITLE:
+		{
+			// Holding down an arrow key or dragging over the list changes the selection
+			// many times faster than the screen is redrawn, and every change sends this
+			// message. Only the latest selection matters, so the coalescer keeps just one
+			// for the list and hands it to ApplyUpdate() once a frame.
+			if (fCoalescer.Post(M_SET_TITLE,fListView,0))
+				ScheduleFlush();
+			break;
+		}
+		case M_FLUSH_UPDATES:
+		{
+			fCoalescer.Flush(system_time());
+			if (fCoalescer.HasPending())
+				ScheduleFlush();
 			break;
 		}
 		default:
@@ -111,3 +349,38 @@ MainWindow::MessageReceived(BMessage *msg)
 		}
 	}
 }
+
+
+void
+MainWindow::ApplyUpdate(uint32 what, void *target, int64 value)
+{
+	int32 selection = fListView->CurrentSelection();
+	
+	if (selection < 0)
+	{
+		// This code is here because when we press the Reset button, the selection
+		// changes and an M_SET_TITLE message is sent, but because nothing is
+		// selected, CurrentSelection() returns -1.
+		SetTitle("The Weird World of Sports");
+		return;
+	}
+	
+	// The text of every row is in our arena, whether it is shown or not. The list
+	// only shows the rows that were found, so its row has to be looked up first.
+	const char *text = fSports.RowText(fFiltered.SourceRow(selection),NULL);
+	if (text)
+		SetTitle(text);
+}
+
+
+void
+MainWindow::ScheduleFlush(void)
+{
+	// Posted right away, the flush message goes behind all of the messages that are
+	// already waiting, so that they are coalesced too. Within a frame of the last flush,
+	// a BMessageRunner sends it once that frame is over.
+	BMessage flush(M_FLUSH_UPDATES);
+	bigtime_t delay = fCoalescer.FlushDelay(system_time());
+	if (delay <= 0 || BMessageRunner::StartSending(BMessenger(this),&flush,delay,1) != B_OK)
+		PostMessage(&flush);
+}
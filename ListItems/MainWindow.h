@@ -1,17 +1,46 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <pthread.h>
+#include <Locker.h>
+#include <StringView.h>
+#include <TextControl.h>
 #include <Window.h>
-#include <ListView.h>
 
-class MainWindow : public BWindow
+#include "ListRows.h"
+#include "MessageCoalescer.h"
+#include "SearchIndex.h"
+#include "VirtualListView.h"
+
+class MainWindow : public BWindow, public RowsListener, public CoalescedHandler
 {
 public:
 						MainWindow(void);
+						~MainWindow(void);
 			void		MessageReceived(BMessage *msg);
+			void		RowsChanged(ListRows *rows);
+			void		ApplyUpdate(uint32 what, void *target, int64 value);
 
 private:
-			BListView	*fListView;
+	static	void		*BuildIndex(void *data);
+			void		StartIndexing(void);
+			void		BeginRowChanges(void);
+			void		CommitRowChanges(void);
+			void		ShowStatus(void);
+			void		ScheduleFlush(void);
+
+			ListRows		fSports;
+			FilteredSource	fFiltered;
+			SearchIndex		*fIndex;
+			SearchIndex		*fBuiltIndex;
+			pthread_t		fIndexThread;
+			bool			fIndexing;
+			bool			fIndexStale;
+			BLocker			fRowsLock;
+			BTextControl	*fFindField;
+			BStringView		*fStatusView;
+			VirtualListView	*fListView;
+			MessageCoalescer	fCoalescer;
 };
 
 #endif
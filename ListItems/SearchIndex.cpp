@@ -0,0 +1,638 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "SearchIndex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+// Three letters are hashed into one of this many buckets. Strings that
+// only share a bucket with the query are told apart when they are
+// compared to it. Two letters have a bucket of their own each, after
+// those.
+static const int32 kTrigramBits = 18;
+static const int32 kPairBase = 1 << kTrigramBits;
+static const int32 kBucketCount = kPairBase + 65536;
+
+// The key of a bucket that has more than one three letters
+static const uint32 kShared = 0xffffffff;
+
+
+static inline uint8
+fold(uint8 c)
+{
+	return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+
+static inline uint32
+trigram_key(const uint8* text)
+{
+	return fold(text[0]) | fold(text[1]) << 8 | fold(text[2]) << 16;
+}
+
+
+static inline uint32
+trigram_bucket(uint32 key)
+{
+	return (key * 2654435761U) >> (32 - kTrigramBits);
+}
+
+
+static inline uint32
+pair_bucket(const uint8* text)
+{
+	return kPairBase + (fold(text[0]) | fold(text[1]) << 8);
+}
+
+
+/*	A bit of its own for every letter, digit and the space, and the
+	other characters share the rest.
+*/
+static inline uint64
+mask_bit(uint8 c)
+{
+	if (c >= 'a' && c <= 'z')
+		return 1ULL << (c - 'a');
+	if (c >= '0' && c <= '9')
+		return 1ULL << (26 + c - '0');
+	if (c == ' ')
+		return 1ULL << 36;
+	return 1ULL << (37 + c % 27);
+}
+
+
+static inline bool
+has_own_bit(uint8 c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == ' ';
+}
+
+
+static inline int32
+put_varint(uint8* buffer, uint32 value)
+{
+	int32 length = 0;
+	while (value >= 0x80) {
+		buffer[length++] = (uint8)(value | 0x80);
+		value >>= 7;
+	}
+	buffer[length++] = (uint8)value;
+	return length;
+}
+
+
+static inline int32
+varint_size(uint32 value)
+{
+	int32 length = 1;
+	while (value >= 0x80) {
+		value >>= 7;
+		length++;
+	}
+	return length;
+}
+
+
+static inline uint32
+get_varint(const uint8*& buffer)
+{
+	uint32 value = 0;
+	int32 shift = 0;
+	while ((*buffer & 0x80) != 0) {
+		value |= (uint32)(*buffer++ & 0x7f) << shift;
+		shift += 7;
+	}
+	return value | (uint32)*buffer++ << shift;
+}
+
+
+/*	Whether the text contains the query, which is already folded. Only
+	where the first and the last of its letters fit is the rest of it
+	compared.
+*/
+static bool
+contains(const char* text, int32 length, const char* query,
+	int32 queryLength)
+{
+	const uint8* bytes = (const uint8*)text;
+	const uint8* search = (const uint8*)query;
+	uint8 first = search[0];
+	uint8 last = search[queryLength - 1];
+	int32 lastOffset = queryLength - 1;
+	
+	for (int32 i = 0; i + queryLength <= length; i++) {
+		if (fold(bytes[i]) != first || fold(bytes[i + lastOffset]) != last)
+			continue;
+		
+		int32 j = 1;
+		while (j < lastOffset && fold(bytes[i + j]) == search[j])
+			j++;
+		if (j >= lastOffset)
+			return true;
+	}
+	
+	return false;
+}
+
+
+SearchIndex::SearchIndex()
+	:
+	fSource(NULL),
+	fRowCount(0),
+	fMasks(NULL),
+	fPostings(NULL),
+	fStarts(NULL),
+	fCounts(NULL),
+	fKeys(NULL),
+	fQuery(NULL),
+	fQueryLength(0),
+	fQueryCapacity(0),
+	fLevels(NULL),
+	fLastTime(0),
+	fLastChecked(0)
+{
+	// Empty
+}
+
+
+SearchIndex::~SearchIndex()
+{
+	Unset();
+	free(fQuery);
+	free(fLevels);
+}
+
+
+/*	Forgets the query, too.
+*/
+status_t
+SearchIndex::SetTo(ListSource* source)
+{
+	Unset();
+	
+	fSource = source;
+	fRowCount = source->CountRows();
+	status_t status = _Build();
+	if (status != B_OK)
+		Unset();
+	return status;
+}
+
+
+void
+SearchIndex::Unset()
+{
+	_FreeLevels(0);
+	fQueryLength = 0;
+	if (fQuery != NULL)
+		fQuery[0] = '\0';
+	
+	free(fMasks);
+	free(fPostings);
+	free(fStarts);
+	free(fCounts);
+	free(fKeys);
+	fMasks = NULL;
+	fPostings = NULL;
+	fStarts = NULL;
+	fCounts = NULL;
+	fKeys = NULL;
+	fSource = NULL;
+	fRowCount = 0;
+}
+
+
+/*	Only the letters after those the query has in common with the one
+	before need to be searched for, in what was found for the letters
+	before them.
+*/
+status_t
+SearchIndex::Search(const char* query)
+{
+	if (fSource == NULL)
+		return B_BAD_VALUE;
+	
+	bigtime_t start = system_time();
+	fLastChecked = 0;
+	
+	int32 length = strlen(query);
+	if (length + 1 > fQueryCapacity) {
+		char* grownQuery = (char*)realloc(fQuery, length + 1);
+		if (grownQuery == NULL)
+			return B_NO_MEMORY;
+		fQuery = grownQuery;
+		
+		level* grownLevels = (level*)realloc(fLevels,
+			(length + 1) * sizeof(level));
+		if (grownLevels == NULL)
+			return B_NO_MEMORY;
+		fLevels = grownLevels;
+		
+		for (int32 i = fQueryCapacity; i < length + 1; i++) {
+			fLevels[i].rows = NULL;
+			fLevels[i].count = 0;
+			fLevels[i].valid = false;
+		}
+		fQueryCapacity = length + 1;
+	}
+	
+	int32 common = 0;
+	while (common < length && common < fQueryLength
+		&& fold(query[common]) == (uint8)fQuery[common])
+		common++;
+	
+	_FreeLevels(common);
+	for (int32 i = common; i < length; i++)
+		fQuery[i] = fold(query[i]);
+	fQuery[length] = '\0';
+	fQueryLength = length;
+	
+	status_t status = B_OK;
+	if (length > 0 && !fLevels[length - 1].valid)
+		status = _Compute(length);
+	
+	fLastTime = system_time() - start;
+	return status;
+}
+
+
+int32
+SearchIndex::CountResults() const
+{
+	if (!IsFiltering())
+		return fRowCount;
+	
+	const level& found = fLevels[fQueryLength - 1];
+	return found.valid ? found.count : 0;
+}
+
+
+int32
+SearchIndex::ResultAt(int32 index) const
+{
+	if (index < 0 || index >= CountResults())
+		return -1;
+	if (!IsFiltering())
+		return index;
+	
+	return fLevels[fQueryLength - 1].rows[index];
+}
+
+
+int32
+SearchIndex::IndexOf(int32 row) const
+{
+	if (!IsFiltering())
+		return row >= 0 && row < fRowCount ? row : -1;
+	
+	const level& found = fLevels[fQueryLength - 1];
+	if (!found.valid)
+		return -1;
+	
+	int32 low = 0;
+	int32 high = found.count;
+	while (low < high) {
+		int32 middle = (low + high) / 2;
+		if (found.rows[middle] < row)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	
+	return low < found.count && found.rows[low] == row ? low : -1;
+}
+
+
+size_t
+SearchIndex::IndexBytes() const
+{
+	if (fSource == NULL)
+		return 0;
+	
+	return fRowCount * sizeof(uint64) + fStarts[kBucketCount]
+		+ (kBucketCount + 1) * sizeof(size_t)
+		+ kBucketCount * sizeof(uint32) + kPairBase * sizeof(uint32);
+}
+
+
+/*	Goes through all of the rows twice, first to count how much room
+	the rows of every bucket take, and then to write them down. Since
+	the rows come in order, every bucket only has to remember the
+	last one it got to know the difference to the next one, and that a
+	row has the same three letters more than once.
+*/
+status_t
+SearchIndex::_Build()
+{
+	fMasks = (uint64*)malloc((fRowCount > 0 ? fRowCount : 1)
+		* sizeof(uint64));
+	fStarts = (size_t*)malloc((kBucketCount + 1) * sizeof(size_t));
+	fCounts = (uint32*)calloc(kBucketCount, sizeof(uint32));
+	fKeys = (uint32*)calloc(kPairBase, sizeof(uint32));
+	size_t* positions = (size_t*)calloc(kBucketCount, sizeof(size_t));
+	uint32* lastRows = (uint32*)calloc(kBucketCount, sizeof(uint32));
+	if (fMasks == NULL || fStarts == NULL || fCounts == NULL
+		|| fKeys == NULL || positions == NULL || lastRows == NULL) {
+		free(positions);
+		free(lastRows);
+		return B_NO_MEMORY;
+	}
+	
+	for (int32 pass = 0; pass < 2; pass++) {
+		for (int32 row = 0; row < fRowCount; row++) {
+			int32 length;
+			const uint8* text = (const uint8*)fSource->RowText(row, &length);
+			
+			if (pass == 0) {
+				uint64 mask = 0;
+				for (int32 i = 0; i < length; i++)
+					mask |= mask_bit(fold(text[i]));
+				fMasks[row] = mask;
+			}
+			
+			// Every two letters, and every three
+			for (int32 i = 0; i + 2 <= length; i++) {
+				uint32 buckets[2] = { pair_bucket(text + i), 0 };
+				int32 bucketCount = 1;
+				if (i + 3 <= length) {
+					uint32 key = trigram_key(text + i);
+					uint32 bucket = trigram_bucket(key);
+					buckets[bucketCount++] = bucket;
+					
+					if (pass == 0 && fKeys[bucket] != key + 1)
+						fKeys[bucket] = fKeys[bucket] == 0 ? key + 1 : kShared;
+				}
+				
+				for (int32 j = 0; j < bucketCount; j++) {
+					uint32 bucket = buckets[j];
+					if (lastRows[bucket] == (uint32)row + 1)
+						continue;
+					
+					uint32 delta = row + 1 - lastRows[bucket];
+					lastRows[bucket] = row + 1;
+					if (pass == 0) {
+						positions[bucket] += varint_size(delta);
+						fCounts[bucket]++;
+					} else {
+						positions[bucket] += put_varint(
+							fPostings + positions[bucket], delta);
+					}
+				}
+			}
+		}
+		
+		if (pass == 1)
+			break;
+		
+		// Where the rows of every bucket go
+		size_t total = 0;
+		for (int32 i = 0; i < kBucketCount; i++) {
+			size_t size = positions[i];
+			fStarts[i] = total;
+			positions[i] = total;
+			total += size;
+		}
+		fStarts[kBucketCount] = total;
+		
+		fPostings = (uint8*)malloc(total > 0 ? total : 1);
+		if (fPostings == NULL) {
+			free(positions);
+			free(lastRows);
+			return B_NO_MEMORY;
+		}
+		memset(lastRows, 0, kBucketCount * sizeof(uint32));
+	}
+	
+	free(positions);
+	free(lastRows);
+	return B_OK;
+}
+
+
+/*	Finds the rows that contain the first "length" letters of the
+	query, from what was found for fewer letters where there is such a
+	result, or else from the index.
+*/
+status_t
+SearchIndex::_Compute(int32 length)
+{
+	const level* base = NULL;
+	for (int32 i = length - 1; i > 0; i--) {
+		if (fLevels[i - 1].valid) {
+			base = &fLevels[i - 1];
+			break;
+		}
+	}
+	
+	// What will be looked at, which is also as many as can be found
+	int32 bucket = -1;
+	bool exact = false;
+	int32 capacity = fRowCount;
+	uint32 key = length == 3 ? trigram_key((const uint8*)fQuery) : 0;
+	if (length == 3 && fKeys[trigram_bucket(key)] == key + 1) {
+		// The bucket has only these three letters, so it is exactly
+		// what is to be found, like for two letters
+		bucket = trigram_bucket(key);
+		exact = true;
+		capacity = fCounts[bucket];
+		base = NULL;
+	} else if (length >= 3) {
+		bucket = _RarestTrigram(length);
+		capacity = fCounts[bucket];
+		if (base != NULL && base->count <= capacity) {
+			// Comparing them all is faster than going through the bucket
+			bucket = -1;
+			capacity = base->count;
+		}
+	} else if (length == 2) {
+		// Exactly what is to be found, no matter what was found before
+		bucket = pair_bucket((const uint8*)fQuery);
+		exact = true;
+		capacity = fCounts[bucket];
+		base = NULL;
+	}
+	
+	int32* results = (int32*)malloc((capacity > 0 ? capacity : 1)
+		* sizeof(int32));
+	if (results == NULL)
+		return B_NO_MEMORY;
+	
+	int32 count;
+	if (bucket >= 0)
+		count = _FromPostings(bucket, exact, base, length, results);
+	else if (base != NULL)
+		count = _Verify(base->rows, base->count, length, results);
+	else
+		count = _FromMasks(length, results);
+	
+	if (count < capacity / 2) {
+		int32* shrunk = (int32*)realloc(results,
+			(count > 0 ? count : 1) * sizeof(int32));
+		if (shrunk != NULL)
+			results = shrunk;
+	}
+	
+	level& found = fLevels[length - 1];
+	found.rows = results;
+	found.count = count;
+	found.valid = true;
+	return B_OK;
+}
+
+
+/*	The bucket of three letters of the query with the fewest rows.
+*/
+int32
+SearchIndex::_RarestTrigram(int32 length) const
+{
+	int32 rarest = -1;
+	for (int32 i = 0; i + 3 <= length; i++) {
+		uint32 bucket = trigram_bucket(trigram_key((const uint8*)fQuery + i));
+		if (rarest < 0 || fCounts[bucket] < fCounts[rarest])
+			rarest = bucket;
+	}
+	return rarest;
+}
+
+
+int32
+SearchIndex::_Verify(const int32* rows, int32 count, int32 length,
+	int32* results)
+{
+	int32 found = 0;
+	for (int32 i = 0; i < count; i++) {
+		int32 textLength;
+		const char* text = fSource->RowText(rows[i], &textLength);
+		if (contains(text, textLength, fQuery, length))
+			results[found++] = rows[i];
+	}
+	
+	fLastChecked += count;
+	return found;
+}
+
+
+/*	The rows of the bucket that are also in the base, if there is
+	one, and contain the query. When the bucket is exactly the query,
+	they all do.
+*/
+int32
+SearchIndex::_FromPostings(int32 bucket, bool exact, const level* base,
+	int32 length, int32* results)
+{
+	const uint8* posting = fPostings + fStarts[bucket];
+	uint32 count = fCounts[bucket];
+	int32 next = 0;
+	int32 found = 0;
+	uint32 row = 0;
+	
+	for (uint32 i = 0; i < count; i++) {
+		row += get_varint(posting);
+		int32 candidate = row - 1;
+		
+		if (base != NULL) {
+			while (next < base->count && base->rows[next] < candidate)
+				next++;
+			if (next == base->count)
+				break;
+			if (base->rows[next] != candidate)
+				continue;
+		}
+		
+		if (exact) {
+			results[found++] = candidate;
+			continue;
+		}
+		
+		int32 textLength;
+		const char* text = fSource->RowText(candidate, &textLength);
+		fLastChecked++;
+		if (contains(text, textLength, fQuery, length))
+			results[found++] = candidate;
+	}
+	
+	return found;
+}
+
+
+/*	For a single letter, the rows that have it, which only have to
+	be compared to it when it doesn't have a bit of its own.
+*/
+int32
+SearchIndex::_FromMasks(int32 length, int32* results)
+{
+	uint64 needed = mask_bit(fQuery[0]);
+	bool exact = has_own_bit(fQuery[0]);
+	int32 found = 0;
+	for (int32 row = 0; row < fRowCount; row++) {
+		if ((fMasks[row] & needed) == 0)
+			continue;
+		
+		if (!exact) {
+			int32 textLength;
+			const char* text = fSource->RowText(row, &textLength);
+			fLastChecked++;
+			if (!contains(text, textLength, fQuery, length))
+				continue;
+		}
+		results[found++] = row;
+	}
+	
+	return found;
+}
+
+
+/*	Frees the results of the query from the letter "from" on.
+*/
+void
+SearchIndex::_FreeLevels(int32 from)
+{
+	for (int32 i = from; i < fQueryLength; i++) {
+		free(fLevels[i].rows);
+		fLevels[i].rows = NULL;
+		fLevels[i].count = 0;
+		fLevels[i].valid = false;
+	}
+}
+
+
+int32
+FilteredSource::CountRows()
+{
+	if (!IsFiltering())
+		return fSource->CountRows();
+	return fIndex->CountResults();
+}
+
+
+const char*
+FilteredSource::RowText(int32 row, int32* _length)
+{
+	int32 sourceRow = SourceRow(row);
+	if (sourceRow < 0)
+		return NULL;
+	return fSource->RowText(sourceRow, _length);
+}
+
+
+int32
+FilteredSource::SourceRow(int32 row) const
+{
+	if (!IsFiltering())
+		return row;
+	return fIndex->ResultAt(row);
+}
+
+
+int32
+FilteredSource::RowOf(int32 sourceRow) const
+{
+	if (!IsFiltering())
+		return sourceRow;
+	return fIndex->IndexOf(sourceRow);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SEARCHINDEX_H_
+#define _SEARCHINDEX_H_
+
+
+#include <stddef.h>
+
+#include "ListModel.h"
+#include "PortableDefs.h"
+
+
+/*	Finds the rows of a ListSource that contain some text, ignoring
+	the case of ASCII letters, as it is typed. For every three letters
+	that follow each other it keeps which rows have them, so a query
+	only has to look at the rows that have its rarest three, and the
+	same for every two letters, and for every row which letters it has,
+	for queries of one.
+
+	Every query that goes on from the one before only looks at what that
+	one found, and the results of every shorter query are kept until the
+	query changes before them, so that taking back a letter costs
+	nothing.
+*/
+class SearchIndex
+{
+public:
+							SearchIndex();
+							~SearchIndex();
+	
+	status_t				SetTo(ListSource* source);
+								// Indexes all of its rows, again after
+								// they changed. They mustn't change
+								// while it does.
+	void					Unset();
+	
+	status_t				Search(const char* query);
+	const char*				Query() const { return fQuery; };
+	bool					IsFiltering() const
+								{ return fQueryLength > 0; };
+								// Whether there is a query at all
+	
+	int32					CountResults() const;
+	int32					ResultAt(int32 index) const;
+								// The index of a row that contains
+								// the query, in the order they are in
+	int32					IndexOf(int32 row) const;
+								// Where the row is in the results,
+								// or -1
+	
+	bigtime_t				LastSearchTime() const
+								{ return fLastTime; };
+	int32					LastChecked() const { return fLastChecked; };
+								// How many rows the last Search()
+								// compared to the query
+	size_t					IndexBytes() const;
+	
+private:
+	struct level {
+		int32*				rows;
+		int32				count;
+		bool				valid;
+	};
+	
+	status_t				_Build();
+	status_t				_Compute(int32 length);
+	int32					_RarestTrigram(int32 length) const;
+	int32					_Verify(const int32* rows, int32 count,
+								int32 length, int32* results);
+	int32					_FromPostings(int32 bucket, bool exact,
+								const level* base, int32 length,
+								int32* results);
+	int32					_FromMasks(int32 length, int32* results);
+	void					_FreeLevels(int32 from);
+	
+	ListSource*				fSource;
+	int32					fRowCount;
+	uint64*					fMasks;
+								// Which letters every row has
+	uint8*					fPostings;
+								// For every bucket of two or three
+								// letters, the rows that have them, as
+								// the differences between them
+	size_t*					fStarts;
+	uint32*					fCounts;
+	uint32*					fKeys;
+								// The three letters of every bucket of
+								// them, if there is only one
+	char*					fQuery;
+								// With the ASCII letters in lower case
+	int32					fQueryLength;
+	int32					fQueryCapacity;
+	level*					fLevels;
+								// The results of the query up to every
+								// letter in it
+	
+	bigtime_t				fLastTime;
+	int32					fLastChecked;
+};
+
+
+/*	The rows of another source that a SearchIndex found, or all of them
+	while there is no index or no query. The other source has to be the
+	one the index was set to.
+*/
+class FilteredSource : public ListSource
+{
+public:
+							FilteredSource(ListSource* source,
+								const SearchIndex* index = NULL)
+								: fSource(source), fIndex(index) {};
+	
+	void					SetIndex(const SearchIndex* index)
+								{ fIndex = index; };
+	bool					IsFiltering() const
+								{ return fIndex != NULL
+									&& fIndex->IsFiltering(); };
+	
+	virtual int32			CountRows();
+	virtual const char*		RowText(int32 row, int32* _length);
+	
+	int32					SourceRow(int32 row) const;
+	int32					RowOf(int32 sourceRow) const;
+								// -1 when the row isn't shown
+	
+private:
+	ListSource*				fSource;
+	const SearchIndex*		fIndex;
+};
+
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "SportRows.h"
+
+#include <stdio.h>
+
+#include "Random.h"
+
+
+static const char* kSports[] = {
+	"Toe Wrestling",
+	"Electric Toilet Racing",
+	"Bog Snorkeling",
+	"Chess Boxing",
+	"Cheese Rolling",
+	"Unicycle Polo"
+};
+static const int32 kSportCount = sizeof(kSports) / sizeof(kSports[0]);
+
+static const char* kHow[] = { "Underwater", "Extreme", "Competitive",
+	"Synchronized", "Midnight", "Backwards", "Indoor", "Speed", "Tandem",
+	"Freestyle", "Blindfolded", "Office" };
+static const char* kWhat[] = { "Ironing", "Wife Carrying", "Bed Racing",
+	"Gravy Wrestling", "Worm Charming", "Shin Kicking", "Bottle Kicking",
+	"Pea Shooting", "Sauna Sitting", "Plank Walking", "Mud Swimming",
+	"Hobby Horsing", "Snail Racing", "Quidditch" };
+
+
+// About 32 bytes a row
+static const size_t kRowBytes = 32;
+
+
+static int32
+sport_row(int32 index, Random& random, char* text, size_t size)
+{
+	if (index < kSportCount)
+		return snprintf(text, size, "%s", kSports[index]);
+	
+	int32 hows = sizeof(kHow) / sizeof(kHow[0]);
+	int32 whats = sizeof(kWhat) / sizeof(kWhat[0]);
+	return snprintf(text, size, "%s %s %d", kHow[random.Range(0, hows - 1)],
+		kWhat[random.Range(0, whats - 1)], (int)index);
+}
+
+
+status_t
+add_sport_rows(StringArena& arena, int32 count)
+{
+	if (arena.Reserve(count, (size_t)count * kRowBytes) != B_OK)
+		return B_NO_MEMORY;
+	
+	Random random(1);
+	for (int32 i = 0; i < count; i++) {
+		char text[64];
+		int32 length = sport_row(i, random, text, sizeof(text));
+		if (arena.Add(text, length) < 0)
+			return B_NO_MEMORY;
+	}
+	
+	return B_OK;
+}
+
+
+status_t
+add_sport_rows(ListRows& rows, int32 count)
+{
+	if (rows.Reserve(count, (size_t)count * kRowBytes) != B_OK)
+		return B_NO_MEMORY;
+	
+	Random random(1);
+	for (int32 i = 0; i < count; i++) {
+		char text[64];
+		int32 length = sport_row(i, random, text, sizeof(text));
+		status_t status = rows.AddRow(text, length);
+		if (status != B_OK)
+			return status;
+	}
+	
+	return B_OK;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _SPORTROWS_H_
+#define _SPORTROWS_H_
+
+
+#include "ListRows.h"
+#include "StringArena.h"
+
+
+/*	Adds the six weird sports of the example, and then made up ones
+	until there are "count" rows, the same ones every time, to try the
+	list with many rows. Returns B_NO_MEMORY if they don't fit.
+*/
+status_t add_sport_rows(StringArena& arena, int32 count);
+status_t add_sport_rows(ListRows& rows, int32 count);
+
+
+#endif
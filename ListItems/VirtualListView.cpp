@@ -0,0 +1,323 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "VirtualListView.h"
+
+#include <math.h>
+
+#include <InterfaceDefs.h>
+#include <ScrollBar.h>
+#include <Window.h>
+
+
+VirtualListView::VirtualListView(BRect frame, const char* name,
+	ListSource* source, bool multipleSelection, uint32 resizingMode)
+	:
+	BView(frame, name, resizingMode,
+		B_WILL_DRAW | B_FRAME_EVENTS | B_NAVIGABLE),
+	fModel(source, multipleSelection),
+	fSelectionMessage(NULL),
+	fCursor(-1),
+	fRowHeight(1),
+	fBaseline(0)
+{
+	// Rows as high as those of a BStringItem
+	font_height height;
+	GetFontHeight(&height);
+	fRowHeight = ceilf(height.ascent + height.descent + height.leading) + 2;
+	fBaseline = 1 + ceilf(height.ascent);
+	
+	SetViewColor(B_TRANSPARENT_COLOR);
+	FrameResized(frame.Width(), frame.Height());
+}
+
+
+VirtualListView::~VirtualListView()
+{
+	delete fSelectionMessage;
+}
+
+
+void
+VirtualListView::AttachedToWindow()
+{
+	BView::AttachedToWindow();
+	_UpdateScrollBar();
+}
+
+
+void
+VirtualListView::Draw(BRect updateRect)
+{
+	BRect bounds = Bounds();
+	rgb_color background = ui_color(B_LIST_BACKGROUND_COLOR);
+	rgb_color selected = ui_color(B_LIST_SELECTED_BACKGROUND_COLOR);
+	rgb_color text = ui_color(B_LIST_ITEM_TEXT_COLOR);
+	rgb_color selectedText = ui_color(B_LIST_SELECTED_ITEM_TEXT_COLOR);
+	
+	// Only the rows in the update rect
+	int32 first = (int32)((updateRect.top - bounds.top) / fRowHeight);
+	int32 last = (int32)((updateRect.bottom - bounds.top) / fRowHeight);
+	if (first < 0)
+		first = 0;
+	
+	for (int32 i = first; i <= last; i++) {
+		int32 row = fModel.TopRow() + i;
+		BRect frame(bounds.left, bounds.top + i * fRowHeight, bounds.right,
+			bounds.top + (i + 1) * fRowHeight - 1);
+		
+		const char* label = fModel.TextAt(row);
+		bool isSelected = label != NULL && fModel.IsSelected(row);
+		SetLowColor(isSelected ? selected : background);
+		FillRect(frame, B_SOLID_LOW);
+		if (label == NULL)
+			continue;
+		
+		SetHighColor(isSelected ? selectedText : text);
+		DrawString(label, BPoint(frame.left + 4, frame.top + fBaseline));
+	}
+}
+
+
+void
+VirtualListView::FrameResized(float width, float height)
+{
+	int32 fullRows = (int32)((height + 1) / fRowHeight);
+	bool partialRow = fullRows * fRowHeight < height + 1;
+	fModel.SetVisibleRows(fullRows, partialRow);
+	
+	_UpdateScrollBar();
+	Invalidate();
+}
+
+
+void
+VirtualListView::KeyDown(const char* bytes, int32 numBytes)
+{
+	int32 current = fCursor;
+	int32 page = fModel.VisibleRows() > 1 ? fModel.VisibleRows() - 1 : 1;
+	int32 row;
+	
+	switch (bytes[0]) {
+		case B_UP_ARROW:
+			row = current > 0 ? current - 1 : 0;
+			break;
+		case B_DOWN_ARROW:
+			row = current + 1;
+			break;
+		case B_PAGE_UP:
+			row = current - page;
+			break;
+		case B_PAGE_DOWN:
+			row = current + page;
+			break;
+		case B_HOME:
+			row = 0;
+			break;
+		case B_END:
+			row = fModel.CountRows() - 1;
+			break;
+		default:
+			BView::KeyDown(bytes, numBytes);
+			return;
+	}
+	
+	if (row >= fModel.CountRows())
+		row = fModel.CountRows() - 1;
+	if (row < 0)
+		row = 0;
+	
+	// With shift, the selection goes from where it started
+	if ((modifiers() & B_SHIFT_KEY) != 0 && fModel.Anchor() >= 0) {
+		if (fModel.SelectRange(fModel.Anchor(), row)) {
+			Invalidate();
+			_SelectionChanged();
+		}
+	} else
+		Select(row);
+	
+	fCursor = row;
+	ScrollToRow(row);
+}
+
+
+void
+VirtualListView::MouseDown(BPoint where)
+{
+	MakeFocus(true);
+	
+	int32 row = _RowAt(where);
+	if (row < 0)
+		return;
+	
+	uint32 modifierKeys = modifiers();
+	bool changed;
+	if ((modifierKeys & B_SHIFT_KEY) != 0 && fModel.Anchor() >= 0)
+		changed = fModel.SelectRange(fModel.Anchor(), row, true);
+	else if ((modifierKeys & B_COMMAND_KEY) != 0 && fModel.IsSelected(row))
+		changed = fModel.Deselect(row);
+	else
+		changed = fModel.Select(row, (modifierKeys & B_COMMAND_KEY) != 0);
+	
+	fCursor = row;
+	if (changed) {
+		Invalidate();
+		_SelectionChanged();
+	}
+}
+
+
+/*	Scrolls by "dv" rows. Only the rows scroll, so "dh" is left alone.
+*/
+void
+VirtualListView::ScrollBy(float /*dh*/, float dv)
+{
+	int32 rows = (int32)dv;
+	if (rows != 0)
+		_ScrollToTop(fModel.TopRow() + rows);
+}
+
+
+/*	The scroll bar counts rows, not pixels, and the view itself never
+	scrolls, it only draws other rows. A horizontal scroll bar, if there
+	is one, moves "where.x", and leaves "where.y" at the top of the
+	bounds, which isn't the top row, so those scrolls are ignored.
+*/
+void
+VirtualListView::ScrollTo(BPoint where)
+{
+	if (where.x != Bounds().left)
+		return;
+	
+	int32 top = (int32)where.y;
+	if (top == fModel.TopRow())
+		return;
+	
+	fModel.ScrollTo(top);
+	Invalidate();
+}
+
+
+void
+VirtualListView::SetSelectionMessage(BMessage* message)
+{
+	delete fSelectionMessage;
+	fSelectionMessage = message;
+}
+
+
+void
+VirtualListView::Select(int32 row, bool extend)
+{
+	fCursor = row;
+	if (fModel.Select(row, extend)) {
+		Invalidate();
+		_SelectionChanged();
+	}
+}
+
+
+void
+VirtualListView::DeselectAll()
+{
+	if (fModel.DeselectAll()) {
+		Invalidate();
+		_SelectionChanged();
+	}
+}
+
+
+void
+VirtualListView::ScrollToRow(int32 row)
+{
+	int32 top = fModel.TopRow();
+	fModel.ScrollToRow(row);
+	if (fModel.TopRow() == top)
+		return;
+	
+	BScrollBar* scrollBar = ScrollBar(B_VERTICAL);
+	if (scrollBar != NULL)
+		scrollBar->SetValue(fModel.TopRow());
+	Invalidate();
+}
+
+
+/*	However many rows changed, this is the one time the scroll bar is
+	updated and the view is invalidated for them.
+*/
+void
+VirtualListView::Reload(const RowMapping* mapping)
+{
+	int32 selected = fModel.CurrentSelection();
+	fModel.Reload(mapping);
+	if (mapping != NULL && fCursor >= 0)
+		fCursor = mapping->NewRow(fCursor);
+	if (fCursor >= fModel.CountRows())
+		fCursor = fModel.CountRows() - 1;
+	
+	_UpdateScrollBar();
+	Invalidate();
+	if (fModel.CurrentSelection() != selected)
+		_SelectionChanged();
+}
+
+
+void
+VirtualListView::_ScrollToTop(int32 top)
+{
+	int32 oldTop = fModel.TopRow();
+	fModel.ScrollTo(top);
+	if (fModel.TopRow() == oldTop)
+		return;
+	
+	BScrollBar* scrollBar = ScrollBar(B_VERTICAL);
+	if (scrollBar != NULL)
+		scrollBar->SetValue(fModel.TopRow());
+	Invalidate();
+}
+
+
+void
+VirtualListView::_UpdateScrollBar()
+{
+	// Nothing is ever wider than the view
+	BScrollBar* horizontal = ScrollBar(B_HORIZONTAL);
+	if (horizontal != NULL)
+		horizontal->SetRange(0, 0);
+	
+	BScrollBar* scrollBar = ScrollBar(B_VERTICAL);
+	if (scrollBar == NULL)
+		return;
+	
+	int32 page = fModel.VisibleRows() > 1 ? fModel.VisibleRows() : 1;
+	scrollBar->SetRange(0, fModel.MaxTopRow());
+	scrollBar->SetSteps(1, page - 1 > 0 ? page - 1 : 1);
+	scrollBar->SetProportion(fModel.CountRows() > 0
+		? (float)page / fModel.CountRows() : 1.0f);
+	scrollBar->SetValue(fModel.TopRow());
+}
+
+
+void
+VirtualListView::_SelectionChanged()
+{
+	if (fSelectionMessage == NULL || Window() == NULL)
+		return;
+	
+	BMessage message(*fSelectionMessage);
+	message.AddInt32("index", fModel.CurrentSelection());
+	message.AddPointer("source", this);
+	Window()->PostMessage(&message);
+}
+
+
+int32
+VirtualListView::_RowAt(BPoint where) const
+{
+	int32 row = fModel.TopRow()
+		+ (int32)((where.y - Bounds().top) / fRowHeight);
+	return row >= 0 && row < fModel.CountRows() ? row : -1;
+}
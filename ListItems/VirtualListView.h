@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _VIRTUALLISTVIEW_H_
+#define _VIRTUALLISTVIEW_H_
+
+
+#include <Message.h>
+#include <View.h>
+
+#include "ListModel.h"
+
+
+/*	Shows the rows of a ListSource like a BListView of BStringItems,
+	but only asks for the rows it shows, through a ListModel. It is
+	scrolled by rows instead of by pixels, which keeps the scroll bar
+	exact with millions of them, where a float would not be.
+*/
+class VirtualListView : public BView
+{
+public:
+							VirtualListView(BRect frame, const char* name,
+								ListSource* source,
+								bool multipleSelection = false,
+								uint32 resizingMode
+									= B_FOLLOW_LEFT | B_FOLLOW_TOP);
+	virtual					~VirtualListView();
+	
+	virtual void			AttachedToWindow();
+	virtual void			Draw(BRect updateRect);
+	virtual void			FrameResized(float width, float height);
+	virtual void			KeyDown(const char* bytes, int32 numBytes);
+	virtual void			MouseDown(BPoint where);
+	virtual void			ScrollBy(float dh, float dv);
+	virtual void			ScrollTo(BPoint where);
+	
+	void					SetSelectionMessage(BMessage* message);
+								// Sent to the window, like the one of a
+								// BListView, when the selection changes
+	int32					CurrentSelection(int32 index = 0) const
+								{ return fModel.CurrentSelection(index); };
+	void					Select(int32 row, bool extend = false);
+	void					DeselectAll();
+	void					ScrollToRow(int32 row);
+	
+	void					Reload(const RowMapping* mapping = NULL);
+								// After the rows of the source changed,
+								// with where the rows went if it is
+								// known
+	ListModel&				Model() { return fModel; };
+	
+private:
+	void					_ScrollToTop(int32 top);
+	void					_UpdateScrollBar();
+	void					_SelectionChanged();
+	int32					_RowAt(BPoint where) const;
+	
+	ListModel				fModel;
+	BMessage*				fSelectionMessage;
+	int32					fCursor;
+								// Where the keys move on from
+	float					fRowHeight;
+	float					fBaseline;
+};
+
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Loads a million rows into a ListRows that a list shows, once a row
+	at a time, the way AddItem() lays out and redraws a BListView for
+	every item, and once in a batch, and prints how long that took and
+	how often the list was reloaded. Then it makes thousands of random
+	inserts, removals and changes of text, once one at a time and once
+	in a batch, and the same again. It checks that both lists end up
+	with the same rows and the same selection, and exits with 1 if they
+	don't.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "ListModel.h"
+#include "ListRows.h"
+#include "Random.h"
+#include "SportRows.h"
+
+
+enum {
+	kSetText = 0,
+	kRemove,
+	kInsert
+};
+
+
+struct edit {
+	int32				row;
+	int32				kind;
+	int32				order;
+	char				text[32];
+};
+
+
+/*	Does what VirtualListView::Reload() does when the rows changed: it
+	reloads the model, updates the scroll bar and redraws the shown rows.
+*/
+class ListShower : public RowsListener
+{
+public:
+	ListShower(ListRows* rows, int32 visible)
+		:
+		fModel(rows, true),
+		fReloads(0),
+		fDrawnRows(0)
+	{
+		fModel.SetVisibleRows(visible, true);
+		rows->SetListener(this);
+	}
+	
+	virtual void RowsChanged(ListRows* rows)
+	{
+		fModel.Reload(rows);
+		fReloads++;
+		
+		for (int32 i = 0; i <= fModel.VisibleRows(); i++) {
+			if (fModel.TextAt(fModel.TopRow() + i) != NULL)
+				fDrawnRows++;
+		}
+	}
+	
+	ListModel& Model() { return fModel; }
+	int64 Reloads() const { return fReloads; }
+	int64 DrawnRows() const { return fDrawnRows; }
+	
+private:
+	ListModel			fModel;
+	int64				fReloads;
+	int64				fDrawnRows;
+};
+
+
+static void
+print_time(const char* what, bigtime_t time, const ListShower& shower,
+	int64 reloads, int64 drawnRows)
+{
+	printf("%-22s %10.1f ms %10d reloads %12lld rows drawn\n", what,
+		time / 1000.0, (int)(shower.Reloads() - reloads),
+		(long long)(shower.DrawnRows() - drawnRows));
+}
+
+
+static bool
+load(ListRows& rows, ListShower& shower, int32 count, bool batch)
+{
+	bigtime_t start = system_time();
+	if (batch)
+		rows.BeginBatch();
+	status_t status = add_sport_rows(rows, count);
+	if (batch && rows.CommitBatch() != B_OK)
+		status = B_NO_MEMORY;
+	bigtime_t time = system_time() - start;
+	
+	if (status != B_OK) {
+		fprintf(stderr, "There isn't enough memory for %d rows\n",
+			(int)count);
+		return false;
+	}
+	
+	print_time(batch ? "load in a batch" : "load a row at a time", time,
+		shower, 0, 0);
+	return true;
+}
+
+
+/*	Makes up edits of the rows as they are before any of them, in the
+	order they are asked for in a batch.
+*/
+static void
+make_edits(edit* edits, int32 count, int32 rowCount, int32 round)
+{
+	Random random(11 + round);
+	for (int32 i = 0; i < count; i++) {
+		edit& made = edits[i];
+		made.kind = random.Range(kSetText, kInsert);
+		made.row = random.Next() % (uint32)rowCount;
+		if (made.kind == kInsert)
+			made.row = random.Next() % (uint32)(rowCount + 1);
+		made.order = i;
+		snprintf(made.text, sizeof(made.text), "Edited %d %d", (int)round,
+			(int)i);
+	}
+}
+
+
+/*	The same edits one at a time have to start with the last row, so
+	that they don't move the rows of the others. For the same row, its
+	text is changed first, then it is removed, and the rows inserted
+	before it come last, the last one first.
+*/
+static bool
+compare_one_at_a_time(const edit& a, const edit& b)
+{
+	if (a.row != b.row)
+		return a.row > b.row;
+	if (a.kind != b.kind)
+		return a.kind < b.kind;
+	if (a.kind == kInsert)
+		return a.order > b.order;
+	return a.order < b.order;
+}
+
+
+static status_t
+apply(ListRows& rows, const edit& made)
+{
+	switch (made.kind) {
+		case kSetText:
+			return rows.SetRowText(made.row, made.text);
+		case kRemove:
+			return rows.RemoveRow(made.row);
+		default:
+			return rows.InsertRow(made.row, made.text);
+	}
+}
+
+
+static bigtime_t
+edit_one_at_a_time(ListRows& rows, edit* edits, int32 count)
+{
+	std::sort(edits, edits + count, &compare_one_at_a_time);
+	
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < count; i++) {
+		// A row that was removed already is only removed once
+		if (edits[i].kind == kRemove && i > 0 && edits[i - 1].kind == kRemove
+			&& edits[i - 1].row == edits[i].row)
+			continue;
+		apply(rows, edits[i]);
+	}
+	return system_time() - start;
+}
+
+
+static bigtime_t
+edit_in_a_batch(ListRows& rows, const edit* edits, int32 count)
+{
+	bigtime_t start = system_time();
+	rows.BeginBatch();
+	for (int32 i = 0; i < count; i++)
+		apply(rows, edits[i]);
+	rows.CommitBatch();
+	return system_time() - start;
+}
+
+
+static bool
+same_rows(ListRows& a, ListShower& aShower, ListRows& b, ListShower& bShower)
+{
+	if (a.CountRows() != b.CountRows()) {
+		printf("%d rows instead of %d\n", (int)b.CountRows(),
+			(int)a.CountRows());
+		return false;
+	}
+	
+	for (int32 i = 0; i < a.CountRows(); i++) {
+		if (strcmp(a.RowText(i, NULL), b.RowText(i, NULL)) != 0) {
+			printf("row %d is \"%s\" instead of \"%s\"\n", (int)i,
+				b.RowText(i, NULL), a.RowText(i, NULL));
+			return false;
+		}
+	}
+	
+	ListModel& aModel = aShower.Model();
+	ListModel& bModel = bShower.Model();
+	for (int32 i = 0; aModel.CurrentSelection(i) >= 0
+		|| bModel.CurrentSelection(i) >= 0; i++) {
+		if (aModel.CurrentSelection(i) != bModel.CurrentSelection(i)) {
+			printf("row %d is selected instead of %d\n",
+				(int)bModel.CurrentSelection(i),
+				(int)aModel.CurrentSelection(i));
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+
+/*	Selects the same rows in both lists, a few of them and some ranges.
+*/
+static void
+select_rows(ListShower& a, ListShower& b, int32 rowCount)
+{
+	Random random(5);
+	for (int32 i = 0; i < 8; i++) {
+		int32 row = random.Next() % (uint32)rowCount;
+		int32 last = row + random.Range(0, 100);
+		if (last >= rowCount)
+			last = rowCount - 1;
+		a.Model().SelectRange(row, last, true);
+		b.Model().SelectRange(row, last, true);
+	}
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--rows n] [--edits n] [--rounds n] "
+		"[--visible n]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 rowCount = 1000000;
+	int32 editCount = 10000;
+	int32 rounds = 3;
+	int32 visible = 40;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--rows") == 0)
+			rowCount = value;
+		else if (strcmp(argv[i], "--edits") == 0)
+			editCount = value;
+		else if (strcmp(argv[i], "--rounds") == 0)
+			rounds = value;
+		else if (strcmp(argv[i], "--visible") == 0)
+			visible = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (rowCount < 1 || editCount < 1 || rounds < 0 || visible < 1)
+		usage(argv[0]);
+	
+	printf("ListItems batches: %d rows, %d shown at a time\n\n",
+		(int)rowCount, (int)visible);
+	
+	ListRows single;
+	ListRows batched;
+	ListShower singleShower(&single, visible);
+	ListShower batchedShower(&batched, visible);
+	
+	if (!load(single, singleShower, rowCount, false)
+		|| !load(batched, batchedShower, rowCount, true))
+		return 1;
+	
+	bool same = same_rows(single, singleShower, batched, batchedShower);
+	select_rows(singleShower, batchedShower, rowCount);
+	
+	edit* edits = new edit[editCount];
+	for (int32 round = 0; round < rounds && same; round++) {
+		printf("\nround %d: %d edits of %d rows\n", (int)round + 1,
+			(int)editCount, (int)single.CountRows());
+		
+		make_edits(edits, editCount, single.CountRows(), round);
+		int64 reloads = batchedShower.Reloads();
+		int64 drawnRows = batchedShower.DrawnRows();
+		bigtime_t time = edit_in_a_batch(batched, edits, editCount);
+		print_time("edit in a batch", time, batchedShower, reloads,
+			drawnRows);
+		
+		reloads = singleShower.Reloads();
+		drawnRows = singleShower.DrawnRows();
+		time = edit_one_at_a_time(single, edits, editCount);
+		print_time("edit one at a time", time, singleShower, reloads,
+			drawnRows);
+		
+		same = same_rows(single, singleShower, batched, batchedShower);
+	}
+	delete[] edits;
+	
+	printf("\n%s, %.1f KB of text not used anymore\n",
+		same ? "Both lists have the same rows" : "The lists differ",
+		batched.UnusedBytes() / 1024.0);
+	return same ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Moves the selection through a list of a million rows and drags a
+	slider at the same time, as fast as holding down a key and moving
+	the mouse sends messages, for some seconds of made up time. Once
+	every message is handled as it comes, like the windows used to,
+	and once through a MessageCoalescer, and it prints how many of them
+	were applied and dropped, how late the latest update was applied
+	at most and how long the handlers took. It exits with 1 if the
+	coalesced handlers didn't end up with the same title and label, or
+	applied an update later than a frame after it came.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ListModel.h"
+#include "MessageCoalescer.h"
+#include "SportRows.h"
+#include "StringArena.h"
+
+
+enum {
+	M_SET_TITLE = 'sttl',
+	M_SLIDE = 'slde'
+};
+
+
+/*	Does what the ListItems and VerticalSlider windows do with them.
+*/
+class Handlers : public CoalescedHandler
+{
+public:
+	Handlers(ListModel& model)
+		:
+		fModel(model),
+		fApplied(0)
+	{
+		fTitle[0] = '\0';
+		fLabel[0] = '\0';
+	}
+	
+	virtual void ApplyUpdate(uint32 what, void* target, int64 value)
+	{
+		fApplied++;
+		if (what == M_SLIDE) {
+			snprintf(fLabel, sizeof(fLabel), "%d", (int)value);
+			return;
+		}
+		
+		int32 selection = fModel.CurrentSelection();
+		const char* text = selection >= 0 ? fModel.TextAt(selection) : NULL;
+		snprintf(fTitle, sizeof(fTitle), "%s",
+			text != NULL ? text : "The Weird World of Sports");
+	}
+	
+	const char* Title() const { return fTitle; }
+	const char* Label() const { return fLabel; }
+	int64 Applied() const { return fApplied; }
+	
+private:
+	ListModel&			fModel;
+	char				fTitle[64];
+	char				fLabel[16];
+	int64				fApplied;
+};
+
+
+struct result {
+	bigtime_t			handlerTime;
+	bigtime_t			latestApply;
+								// How late an update was applied at most
+	char				title[64];
+	char				label[16];
+};
+
+
+// A time that never comes
+static const bigtime_t kNever = 0x7fffffffffffffffLL;
+
+
+/*	Goes through the made up time from one message to the next, which
+	come "selectInterval" and "slideInterval" apart until "duration",
+	and to the flushes that the coalescer asks for.
+*/
+static result
+run(ListModel& model, MessageCoalescer* coalescer, Handlers& handlers,
+	bigtime_t duration, bigtime_t selectInterval, bigtime_t slideInterval)
+{
+	result done;
+	done.handlerTime = 0;
+	done.latestApply = 0;
+	
+	bigtime_t nextSelect = 0;
+	bigtime_t nextSlide = 0;
+	bigtime_t flushAt = kNever;
+	bigtime_t firstPending = 0;
+	int32 slideValue = 0;
+	model.Select(0);
+	
+	while (true) {
+		bigtime_t now = nextSelect < nextSlide ? nextSelect : nextSlide;
+		if (flushAt < now)
+			now = flushAt;
+		if (now == kNever)
+			break;
+		
+		bigtime_t start = system_time();
+		if (now == flushAt) {
+			if (coalescer->Flush(now) > 0 && now - firstPending
+					> done.latestApply)
+				done.latestApply = now - firstPending;
+			flushAt = coalescer->HasPending()
+				? now + coalescer->FlushDelay(now) : kNever;
+		} else {
+			uint32 what;
+			int64 value;
+			if (now == nextSelect) {
+				// The arrow key moves the selection down a row
+				int32 row = (model.CurrentSelection() + 1) % model.CountRows();
+				model.Select(row);
+				model.ScrollToRow(row);
+				what = M_SET_TITLE;
+				value = 0;
+				nextSelect = now + selectInterval;
+				if (nextSelect > duration)
+					nextSelect = kNever;
+			} else {
+				slideValue = (slideValue + 1) % 101;
+				what = M_SLIDE;
+				value = slideValue;
+				nextSlide = now + slideInterval;
+				if (nextSlide > duration)
+					nextSlide = kNever;
+			}
+			
+			if (coalescer == NULL)
+				handlers.ApplyUpdate(what, NULL, value);
+			else if (coalescer->Post(what, what == M_SLIDE ? NULL : &model,
+					value)) {
+				firstPending = now;
+				flushAt = now + coalescer->FlushDelay(now);
+			}
+		}
+		done.handlerTime += system_time() - start;
+	}
+	
+	strcpy(done.title, handlers.Title());
+	strcpy(done.label, handlers.Label());
+	return done;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--rows n] [--seconds n] [--select-hz n] "
+		"[--slide-hz n]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 rowCount = 1000000;
+	int32 seconds = 10;
+	int32 selectRate = 1000;
+	int32 slideRate = 500;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--rows") == 0)
+			rowCount = value;
+		else if (strcmp(argv[i], "--seconds") == 0)
+			seconds = value;
+		else if (strcmp(argv[i], "--select-hz") == 0)
+			selectRate = value;
+		else if (strcmp(argv[i], "--slide-hz") == 0)
+			slideRate = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (rowCount < 1 || seconds < 1 || selectRate < 1 || selectRate > 1000000
+		|| slideRate < 1 || slideRate > 1000000)
+		usage(argv[0]);
+	
+	StringArena rows;
+	if (add_sport_rows(rows, rowCount) != B_OK) {
+		fprintf(stderr, "There isn't enough memory for %d rows\n",
+			(int)rowCount);
+		return 1;
+	}
+	
+	bigtime_t duration = (bigtime_t)seconds * 1000000;
+	bigtime_t selectInterval = 1000000 / selectRate;
+	bigtime_t slideInterval = 1000000 / slideRate;
+	printf("ListItems coalescing: %d rows, %d s of selecting at %d Hz and "
+		"sliding at %d Hz, %.1f ms frames\n\n", (int)rowCount, (int)seconds,
+		(int)selectRate, (int)slideRate, kCoalesceFrameInterval / 1000.0);
+	
+	ArenaSource source(rows);
+	ListModel directModel(&source);
+	directModel.SetVisibleRows(40, true);
+	Handlers direct(directModel);
+	result directResult = run(directModel, NULL, direct, duration,
+		selectInterval, slideInterval);
+	
+	ListModel coalescedModel(&source);
+	coalescedModel.SetVisibleRows(40, true);
+	Handlers coalesced(coalescedModel);
+	MessageCoalescer coalescer(&coalesced);
+	result coalescedResult = run(coalescedModel, &coalescer, coalesced,
+		duration, selectInterval, slideInterval);
+	
+	printf("%-12s %10s %10s %10s %10s %12s\n", "", "messages", "applied",
+		"dropped", "frames", "handlers ms");
+	printf("%-12s %10lld %10lld %10d %10s %12.1f\n", "one by one",
+		(long long)direct.Applied(), (long long)direct.Applied(), 0, "-",
+		directResult.handlerTime / 1000.0);
+	printf("%-12s %10lld %10lld %10lld %10lld %12.1f\n", "coalesced",
+		(long long)coalescer.CountPosted(), (long long)coalescer.CountApplied(),
+		(long long)coalescer.CountDropped(),
+		(long long)coalescer.CountFlushes(),
+		coalescedResult.handlerTime / 1000.0);
+	printf("\nthe latest update was applied at most %.1f ms after it came\n",
+		coalescedResult.latestApply / 1000.0);
+	
+	bool same = strcmp(directResult.title, coalescedResult.title) == 0
+		&& strcmp(directResult.label, coalescedResult.label) == 0;
+	printf("title \"%s\", label \"%s\"%s\n", coalescedResult.title,
+		coalescedResult.label, same ? "" : ", not the same as one by one");
+	
+	return same && coalescedResult.latestApply <= kCoalesceFrameInterval
+		? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Fills a list with millions of rows, once the way ListItems used to,
+	with an item on the heap for every row, and once into a StringArena,
+	and prints how long that took and how much memory it takes. Then
+	it scrolls and selects in a ListModel of ten thousand rows and of
+	all of them, like a VirtualListView would, and prints how long that
+	took and how many rows had to be copied, which shouldn't depend on
+	how many rows there are.
+*/
+
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ListModel.h"
+#include "Random.h"
+#include "SportRows.h"
+#include "StringArena.h"
+
+
+/*	About what a BStringItem is: a BListItem with its size, level and
+	flags, and a copy of the text.
+*/
+class HeapItem
+{
+public:
+	HeapItem(const char* text)
+		:
+		fText(strdup(text)),
+		fTop(0),
+		fWidth(0),
+		fHeight(0),
+		fBaselineOffset(0),
+		fLevel(0),
+		fSelected(false),
+		fEnabled(true),
+		fExpanded(true),
+		fHasSubitems(false),
+		fVisible(true)
+	{
+	}
+	
+	virtual ~HeapItem()
+	{
+		free(fText);
+	}
+	
+private:
+	char*				fText;
+	float				fTop;
+	float				fWidth;
+	float				fHeight;
+	float				fBaselineOffset;
+	uint32				fLevel;
+	bool				fSelected;
+	bool				fEnabled;
+	bool				fExpanded;
+	bool				fHasSubitems;
+	bool				fVisible;
+};
+
+
+static size_t
+heap_in_use()
+{
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+}
+
+
+static void
+fill_arena(const StringArena& rows)
+{
+	int32 count = rows.CountStrings();
+	size_t before = heap_in_use();
+	bigtime_t start = system_time();
+	
+	StringArena copy;
+	for (int32 i = 0; i < count; i++) {
+		int32 length;
+		const char* text = rows.StringAt(i, &length);
+		copy.Add(text, length);
+	}
+	
+	bigtime_t time = system_time() - start;
+	size_t bytes = heap_in_use() - before;
+	printf("string arena: %8.1f ms  %8.1f MB  %5.1f bytes a row  "
+		"%.1f MB used\n", time / 1000.0, bytes / 1048576.0,
+		(double)bytes / count, copy.UsedBytes() / 1048576.0);
+}
+
+
+static void
+fill_items(const StringArena& rows)
+{
+	int32 count = rows.CountStrings();
+	size_t before = heap_in_use();
+	bigtime_t start = system_time();
+	
+	// A BList doubles its array of pointers when it is full
+	HeapItem** items = NULL;
+	int32 capacity = 0;
+	for (int32 i = 0; i < count; i++) {
+		if (i == capacity) {
+			capacity = capacity > 0 ? capacity * 2 : 20;
+			items = (HeapItem**)realloc(items, capacity * sizeof(HeapItem*));
+		}
+		items[i] = new HeapItem(rows.StringAt(i));
+	}
+	
+	bigtime_t time = system_time() - start;
+	size_t bytes = heap_in_use() - before;
+	printf("an item each: %8.1f ms  %8.1f MB  %5.1f bytes a row  "
+		"%d allocations\n", time / 1000.0, bytes / 1048576.0,
+		(double)bytes / count, (int)(2 * count));
+	
+	for (int32 i = 0; i < count; i++)
+		delete items[i];
+	free(items);
+}
+
+
+struct timing {
+	double				jump;
+	double				jumpRows;
+	double				step;
+	double				stepRows;
+	double				select;
+};
+
+
+/*	Ask for every shown row, like VirtualListView::Draw() does.
+*/
+static uint32
+draw(ListModel& model)
+{
+	uint32 sum = 0;
+	for (int32 i = 0; i <= model.VisibleRows(); i++) {
+		int32 row = model.TopRow() + i;
+		const char* text = model.TextAt(row);
+		if (text != NULL)
+			sum += text[0] + model.IsSelected(row);
+	}
+	return sum;
+}
+
+
+static timing
+measure(StringArena& rows, int32 visible, int32 operations)
+{
+	ArenaSource source(rows);
+	ListModel model(&source, true);
+	model.SetVisibleRows(visible, true);
+	Random random(3);
+	timing result;
+	uint32 sum = 0;
+	
+	// Dragging the scroll bar: anywhere at all
+	int64 materialized = model.CountMaterialized();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < operations; i++) {
+		model.ScrollTo(random.Next() % (uint32)rows.CountStrings());
+		sum += draw(model);
+	}
+	result.jump = (system_time() - start) * 1000.0 / operations;
+	result.jumpRows = (double)(model.CountMaterialized() - materialized)
+		/ operations;
+	
+	// Scrolling down one row at a time
+	model.ScrollTo(0);
+	materialized = model.CountMaterialized();
+	start = system_time();
+	for (int32 i = 0; i < operations; i++) {
+		model.ScrollTo((model.TopRow() + 1) % (model.MaxTopRow() + 1));
+		sum += draw(model);
+	}
+	result.step = (system_time() - start) * 1000.0 / operations;
+	result.stepRows = (double)(model.CountMaterialized() - materialized)
+		/ operations;
+	
+	// Clicking a row and shift-clicking another one far away, and
+	// every other time a command-click somewhere in between
+	start = system_time();
+	for (int32 i = 0; i < operations; i++) {
+		int32 row = random.Next() % (uint32)rows.CountStrings();
+		int32 other = random.Next() % (uint32)rows.CountStrings();
+		model.Select(row);
+		model.SelectRange(row, other, true);
+		if (i % 2 == 0)
+			model.Deselect((row + other) / 2);
+		model.ScrollToRow(other);
+		sum += draw(model);
+	}
+	result.select = (system_time() - start) * 1000.0 / operations;
+	
+	if (sum == 0)
+		printf("(nothing was drawn)\n");
+	return result;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--rows n] [--visible n] [--ops n] "
+		"[--items 0|1]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 rowCount = 10000000;
+	int32 visible = 40;
+	int32 operations = 100000;
+	bool items = true;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--rows") == 0)
+			rowCount = value;
+		else if (strcmp(argv[i], "--visible") == 0)
+			visible = value;
+		else if (strcmp(argv[i], "--ops") == 0)
+			operations = value;
+		else if (strcmp(argv[i], "--items") == 0)
+			items = value != 0;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (rowCount < 1 || visible < 1 || operations < 1)
+		usage(argv[0]);
+	
+	printf("ListItems headless: %d rows, %d shown at a time\n",
+		(int)rowCount, (int)visible);
+	
+	// Making up the rows takes the same time either way, so they
+	// are made up first, and then copied into the list
+	StringArena rows;
+	if (add_sport_rows(rows, rowCount) != B_OK) {
+		fprintf(stderr, "There isn't enough memory for %d rows\n",
+			(int)rowCount);
+		return 1;
+	}
+	
+	if (items)
+		fill_items(rows);
+	fill_arena(rows);
+	
+	StringArena fewRows;
+	add_sport_rows(fewRows, rowCount < 10000 ? rowCount : 10000);
+	
+	printf("\n%10s %10s %10s %10s %10s %10s\n", "rows", "jump ns",
+		"rows/jump", "step ns", "rows/step", "select ns");
+	StringArena* arenas[2] = { &fewRows, &rows };
+	for (int32 i = 0; i < 2; i++) {
+		timing result = measure(*arenas[i], visible, operations);
+		printf("%10d %10.0f %10.1f %10.0f %10.2f %10.0f\n",
+			(int)arenas[i]->CountStrings(), result.jump, result.jumpRows,
+			result.step, result.stepRows, result.select);
+	}
+	
+	return 0;
+}
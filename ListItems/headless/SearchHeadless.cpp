@@ -0,0 +1,236 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Types a query into the SearchIndex of millions of rows one letter
+	at a time, and takes it back again, and prints how long every
+	letter took, next to going through all of the rows for every letter
+	the way a plain filter would. Then it types parts of rows picked at
+	random, and prints how long the letters took at most and mostly. It
+	checks that the index finds the same rows as the plain filter, and
+	exits with 1 if it doesn't.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "ListModel.h"
+#include "Random.h"
+#include "SearchIndex.h"
+#include "SportRows.h"
+#include "StringArena.h"
+
+
+static int32* sPlainRows;
+
+
+/*	Goes through all of the rows, like a filter without an index.
+*/
+static int32
+plain_filter(const StringArena& rows, const char* query)
+{
+	int32 found = 0;
+	for (int32 i = 0; i < rows.CountStrings(); i++) {
+		if (strcasestr(rows.StringAt(i), query) != NULL)
+			sPlainRows[found++] = i;
+	}
+	return found;
+}
+
+
+static bool
+same_rows(const SearchIndex& index, int32 count)
+{
+	if (index.CountResults() != count)
+		return false;
+	for (int32 i = 0; i < count; i++) {
+		if (index.ResultAt(i) != sPlainRows[i])
+			return false;
+	}
+	return true;
+}
+
+
+/*	Shows the rows that were found, like the VirtualListView does after
+	every letter, and returns how many rows had to be copied for it.
+*/
+static int64
+show(ListModel& model)
+{
+	int64 before = model.CountMaterialized();
+	model.Reload();
+	model.ScrollTo(0);
+	for (int32 i = 0; i <= model.VisibleRows(); i++)
+		model.TextAt(i);
+	return model.CountMaterialized() - before;
+}
+
+
+static bool
+type(const StringArena& rows, SearchIndex& index, ListModel& model,
+	const char* query)
+{
+	printf("\n%-16s %10s %10s %10s %10s %8s\n", "query", "found",
+		"compared", "index us", "plain us", "shown");
+	
+	char typed[256];
+	int32 length = strlen(query);
+	bool same = true;
+	
+	// Typing it, then taking it back, letter by letter
+	for (int32 step = 1; step < 2 * length; step++) {
+		int32 letters = step <= length ? step : 2 * length - step;
+		memcpy(typed, query, letters);
+		typed[letters] = '\0';
+		
+		index.Search(typed);
+		int64 shown = show(model);
+		
+		bigtime_t start = system_time();
+		int32 count = plain_filter(rows, typed);
+		bigtime_t plainTime = system_time() - start;
+		if (!same_rows(index, count)) {
+			printf("\"%s\": the index found %d rows instead of %d\n", typed,
+				(int)index.CountResults(), (int)count);
+			same = false;
+		}
+		
+		char quoted[260];
+		snprintf(quoted, sizeof(quoted), "\"%s\"", typed);
+		printf("%-16s %10d %10d %10.1f %10.1f %8d\n", quoted,
+			(int)index.CountResults(), (int)index.LastChecked(),
+			(double)index.LastSearchTime(), (double)plainTime, (int)shown);
+	}
+	
+	return same;
+}
+
+
+/*	Types parts of random rows, from two to twelve letters long, each
+	after clearing the one before.
+*/
+static bool
+type_random(const StringArena& rows, SearchIndex& index, int32 queries,
+	int32 checks)
+{
+	Random random(7);
+	bigtime_t* times = new bigtime_t[queries * 12];
+	int32 letterCount = 0;
+	bool same = true;
+	
+	for (int32 i = 0; i < queries; i++) {
+		int32 length;
+		const char* text = rows.StringAt(
+			random.Next() % (uint32)rows.CountStrings(), &length);
+		int32 wanted = random.Range(2, 12);
+		if (wanted > length)
+			wanted = length;
+		int32 offset = random.Range(0, length - wanted);
+		
+		char query[16];
+		index.Search("");
+		for (int32 letters = 1; letters <= wanted; letters++) {
+			memcpy(query, text + offset, letters);
+			query[letters] = '\0';
+			index.Search(query);
+			times[letterCount++] = index.LastSearchTime();
+		}
+		
+		if (i < checks && !same_rows(index, plain_filter(rows, query))) {
+			printf("\"%s\": the index didn't find the same rows\n", query);
+			same = false;
+		}
+	}
+	
+	std::sort(times, times + letterCount);
+	bigtime_t total = 0;
+	for (int32 i = 0; i < letterCount; i++)
+		total += times[i];
+	
+	printf("\n%d random queries, %d letters: %.1f us on average, "
+		"half within %d us, 99%% within %d us, at most %d us\n",
+		(int)queries, (int)letterCount, (double)total / letterCount,
+		(int)times[letterCount / 2], (int)times[letterCount * 99 / 100],
+		(int)times[letterCount - 1]);
+	
+	delete[] times;
+	return same;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--rows n] [--query text] [--queries n] "
+		"[--checks n]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	int32 rowCount = 10000000;
+	const char* query = "shin kicking 42";
+	int32 queries = 1000;
+	int32 checks = 20;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		if (strcmp(argv[i], "--rows") == 0)
+			rowCount = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--query") == 0)
+			query = argv[i + 1];
+		else if (strcmp(argv[i], "--queries") == 0)
+			queries = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--checks") == 0)
+			checks = atoi(argv[i + 1]);
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (rowCount < 1 || queries < 1 || query[0] == '\0'
+		|| strlen(query) > 200)
+		usage(argv[0]);
+	
+	printf("ListItems search: %d rows\n", (int)rowCount);
+	
+	StringArena rows;
+	sPlainRows = (int32*)malloc(rowCount * sizeof(int32));
+	if (sPlainRows == NULL || add_sport_rows(rows, rowCount) != B_OK) {
+		fprintf(stderr, "There isn't enough memory for %d rows\n",
+			(int)rowCount);
+		return 1;
+	}
+	
+	ArenaSource source(rows);
+	SearchIndex index;
+	bigtime_t start = system_time();
+	if (index.SetTo(&source) != B_OK) {
+		fprintf(stderr, "There isn't enough memory for the index\n");
+		return 1;
+	}
+	printf("index: %.1f ms to build, %.1f MB, %.1f bytes a row "
+		"(the rows take %.1f MB)\n", (system_time() - start) / 1000.0,
+		index.IndexBytes() / 1048576.0, (double)index.IndexBytes() / rowCount,
+		rows.UsedBytes() / 1048576.0);
+	
+	FilteredSource filtered(&source, &index);
+	ListModel model(&filtered);
+	model.SetVisibleRows(40, true);
+	
+	bool same = type(rows, index, model, query);
+	same &= type_random(rows, index, queries, checks);
+	
+	free(sPlainRows);
+	return same ? 0 : 1;
+}
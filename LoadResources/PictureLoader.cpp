@@ -0,0 +1,145 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "PictureLoader.h"
+
+
+PictureLoader::PictureLoader(ImageCache* cache, const image_key* keys,
+	int32 count)
+	:
+	fCache(cache),
+	fKeys(NULL),
+	fCount(count > 0 ? count : 0),
+	fShown(-1),
+	fNext(-1),
+	fPrefetching(-1),
+	fPrefetches(0),
+	fWaits(0),
+	fQuitting(false)
+{
+	fKeys = new image_key[fCount > 0 ? fCount : 1];
+	for (int32 i = 0; i < fCount; i++)
+		fKeys[i] = keys[i];
+	
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fChanged, NULL);
+	pthread_create(&fThread, NULL, &_Prefetch, this);
+}
+
+
+PictureLoader::~PictureLoader()
+{
+	pthread_mutex_lock(&fLock);
+	fQuitting = true;
+	pthread_cond_broadcast(&fChanged);
+	pthread_mutex_unlock(&fLock);
+	
+	pthread_join(fThread, NULL);
+	
+	if (fShown >= 0)
+		fCache->Release(fKeys[fShown]);
+	delete[] fKeys;
+	
+	pthread_cond_destroy(&fChanged);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+/*	Only the one thread that shows the pictures calls this, so that
+	fShown is only used by it.
+*/
+void*
+PictureLoader::Get(int32 index)
+{
+	if (index < 0 || index >= fCount)
+		return NULL;
+	
+	pthread_mutex_lock(&fLock);
+	
+	// The cache makes this wait for the thread, instead of decoding
+	// the picture a second time
+	if (fPrefetching == index)
+		fWaits++;
+	
+	// The next one is shown next, so get it while this one is being
+	// looked at, unless the thread is still busy
+	int32 next = (index + 1) % fCount;
+	if (next != index && fNext < 0 && fPrefetching < 0) {
+		fNext = next;
+		pthread_cond_broadcast(&fChanged);
+	}
+	
+	pthread_mutex_unlock(&fLock);
+	
+	// The new one is acquired before the old one is released, so that
+	// showing the same one again doesn't let it go in between
+	void* picture = fCache->Acquire(fKeys[index]);
+	if (fShown >= 0)
+		fCache->Release(fKeys[fShown]);
+	fShown = picture != NULL ? index : -1;
+	
+	return picture;
+}
+
+
+int32
+PictureLoader::CountPrefetches() const
+{
+	pthread_mutex_lock(&fLock);
+	int32 prefetches = fPrefetches;
+	pthread_mutex_unlock(&fLock);
+	
+	return prefetches;
+}
+
+
+int32
+PictureLoader::CountWaits() const
+{
+	pthread_mutex_lock(&fLock);
+	int32 waits = fWaits;
+	pthread_mutex_unlock(&fLock);
+	
+	return waits;
+}
+
+
+/*	Gets the next picture into the cache, and releases it right away,
+	so that it stays there until the cache needs the room, which it
+	takes from the pictures that weren't used for the longest time
+	first.
+*/
+void*
+PictureLoader::_Prefetch(void* data)
+{
+	PictureLoader* loader = (PictureLoader*)data;
+	
+	pthread_mutex_lock(&loader->fLock);
+	
+	while (true) {
+		while (loader->fNext < 0 && !loader->fQuitting)
+			pthread_cond_wait(&loader->fChanged, &loader->fLock);
+		
+		if (loader->fQuitting)
+			break;
+		
+		int32 index = loader->fNext;
+		loader->fPrefetching = index;
+		loader->fNext = -1;
+		pthread_mutex_unlock(&loader->fLock);
+		
+		if (loader->fCache->Acquire(loader->fKeys[index]) != NULL)
+			loader->fCache->Release(loader->fKeys[index]);
+		
+		pthread_mutex_lock(&loader->fLock);
+		loader->fPrefetching = -1;
+		loader->fPrefetches++;
+	}
+	
+	pthread_mutex_unlock(&loader->fLock);
+	
+	return NULL;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _PICTURELOADER_H_
+#define _PICTURELOADER_H_
+
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "ImageCache.h"
+#include "PortableDefs.h"
+
+
+/*	Gets pictures from an ImageCache only when they are shown, and the
+	one after the shown one in the background, since they are shown in
+	order. The cache decodes them, and frees the ones that weren't
+	shown for the longest time to stay within its budget. It can be
+	shared by several loaders, of one window or of several, which then
+	share the pictures and never decode the same one twice at the same
+	time. The shown picture stays acquired, so it is always kept. POSIX
+	threads are used, rather than spawn_thread(), so the headless
+	harness can run it too.
+*/
+class PictureLoader
+{
+public:
+							PictureLoader(ImageCache* cache,
+								const image_key* keys, int32 count);
+								// The pictures are the images of "keys"
+							~PictureLoader();
+								// Waits for the picture being gotten in
+								// the background, and releases the
+								// shown one
+	
+	int32					CountPictures() const { return fCount; };
+	
+	void*					Get(int32 index);
+								// From the cache, decoded now if it isn't
+								// there, or waited for if it is being
+								// decoded, and starts on the next one.
+								// It stays valid until the next Get().
+	
+	int32					CountPrefetches() const;
+	int32					CountWaits() const;
+								// The pictures gotten in the background,
+								// and the times Get() asked for the one
+								// that was being gotten there
+	
+private:
+	static void*			_Prefetch(void* data);
+	
+	ImageCache*				fCache;
+	image_key*				fKeys;
+	int32					fCount;
+	int32					fShown;
+								// The acquired picture, or -1
+	int32					fNext;
+								// The picture for the thread to get,
+								// or -1
+	int32					fPrefetching;
+								// The one it is getting, or -1
+	
+	int32					fPrefetches;
+	int32					fWaits;
+	
+	pthread_t				fThread;
+	bool					fQuitting;
+	mutable pthread_mutex_t	fLock;
+	pthread_cond_t			fChanged;
+								// There is a picture to get
+};
+
+
+#endif
@@ -1,30 +1,183 @@
 #include "PictureView.h"
+#include <Application.h>
+#include <Autolock.h>
+#include <DataIO.h>
+#include <Locker.h>
+#include <Resources.h>
 #include <TranslationUtils.h>
 #include <TranslatorFormats.h>
 
-// This class is our own special control. It loads five images from the application
-// resources and places them in an array. Once loaded, it resizes itself to exactly
-// fit the first bitmap. Since they are all the same size, this assumption is OK.
+#include "PngDecoder.h"
+
+// The pictures that are kept decoded can take up to this many bytes, which is
+// about three of ours. The ones that are shown are always kept.
+static const size_t kMaxPictureBytes = 32 * 1024;
+
+// The pictures are the PNG resources with the IDs 1 to 5
+static const int32 kPictureCount = 5;
+
+
+// The pictures are the five PNG images in the application resources, with the
+// IDs 1 to 5. They are decoded by our own PngDecoder, which is a lot faster than
+// the Translation Kit for the small kinds of PNG images icons come in, and gives
+// premultiplied pixels. It can't decode every kind of PNG image, though, so the
+// others are still loaded with BTranslationUtils::GetBitmap. There are 5 different
+// versions of it. This is one of two which load images from program resources.
+// The source of a key is the ID of the resource.
+class ResourcePictures : public ImageDecoder
+{
+public:
+	void *Decode(const image_key &key, size_t *_bytes)
+	{
+		// The application's resources are already open, so the data of the
+		// resource is only a pointer away. This is called by the loader's own
+		// thread as well as by the window's, and a BResources can only be used
+		// by one thread at a time, so getting the data is done while holding
+		// a lock. Decoding it is done without, since the data stays where it
+		// is as long as the application runs.
+		size_t size = 0;
+		const void *data;
+		{
+			BAutolock locker(fResourcesLock);
+			data = BApplication::AppResources()->LoadResource(B_PNG_FORMAT,
+				key.source, &size);
+		}
+		if (!data)
+			return NULL;
+		
+		BBitmap *smiley = NULL;
+		bool opaque = false;
+		PngDecoder decoder;
+		if (decoder.SetTo(data, size) == B_OK)
+		{
+			smiley = new BBitmap(BRect(0, 0, decoder.Width() - 1, decoder.Height() - 1),
+				B_RGBA32);
+			if (smiley->IsValid()
+				&& decoder.Decode((uint8*)smiley->Bits(), smiley->BytesPerRow()) == B_OK)
+				opaque = decoder.IsOpaque();
+			else
+			{
+				delete smiley;
+				return NULL;
+			}
+		}
+		else
+		{
+			// The translators read the same data from memory, rather than
+			// from the resources themselves
+			BMemoryIO stream(data,size);
+			smiley = BTranslationUtils::GetBitmap(&stream);
+			if (!smiley || !smiley->IsValid())
+			{
+				delete smiley;
+				return NULL;
+			}
+			
+			// The translators give straight colors, which are premultiplied
+			// here, to be the same as what our decoder gives
+			if (smiley->ColorSpace() == B_RGBA32)
+				PngDecoder::Premultiply((uint8*)smiley->Bits(),
+					smiley->Bounds().IntegerWidth() + 1,
+					smiley->Bounds().IntegerHeight() + 1, smiley->BytesPerRow());
+			else
+				opaque = true;
+		}
+		
+		// Our view is white behind the picture, so a picture that isn't opaque is
+		// blended over white once, right here, instead of on every paint. With
+		// premultiplied colors, that only takes adding a bit of white to every
+		// pixel. Opaque pictures are left as they are.
+		if (!opaque)
+			PngDecoder::Flatten((uint8*)smiley->Bits(),
+				smiley->Bounds().IntegerWidth() + 1,
+				smiley->Bounds().IntegerHeight() + 1, smiley->BytesPerRow(),
+				0xffffff);
+		
+		*_bytes = smiley->BitsLength();
+		return smiley;
+	}
+	
+	void Free(void *picture)
+	{
+		delete (BBitmap*)picture;
+	}
+	
+private:
+	BLocker	fResourcesLock;
+};
+
+
+// Every PictureView of the application gets its pictures from the same cache,
+// so that a picture that one of them decoded doesn't have to be decoded again
+// for another one, and two of them that want the same picture at the same time
+// only decode it once. The first view makes the cache, and the last one deletes
+// it again. The views can be in different windows, which each have a thread of
+// their own, so this is done while holding a lock.
+static BLocker sCacheLock("picture cache");
+static ResourcePictures *sDecoder = NULL;
+static ImageCache *sCache = NULL;
+static int32 sCacheUsers = 0;
+
+
+static ImageCache *
+acquire_cache(void)
+{
+	BAutolock locker(sCacheLock);
+	if (sCacheUsers++ == 0)
+	{
+		sDecoder = new ResourcePictures();
+		sCache = new ImageCache(sDecoder,kMaxPictureBytes);
+	}
+	return sCache;
+}
+
+
+static void
+release_cache(void)
+{
+	BAutolock locker(sCacheLock);
+	if (--sCacheUsers == 0)
+	{
+		delete sCache;
+		delete sDecoder;
+		sCache = NULL;
+		sDecoder = NULL;
+	}
+}
+
+
+// This class is our own special control. It shows one of five images from the
+// application resources at a time. Decoding an image takes a while, so they are
+// only decoded when they are about to be shown, instead of all of them up front,
+// and the ones that weren't shown for a while are freed again. Once the first one
+// is loaded, it resizes itself to exactly fit it. Since they are all the same
+// size, this assumption is OK.
 PictureView::PictureView(void)
  :	BView(BRect(0,0,100,100), "picview", B_FOLLOW_LEFT | B_FOLLOW_TOP, B_WILL_DRAW),
  	fBitmapIndex(0)
 {
-	// Load up all our pictures using a loop. There are 5 different versions of
-	// BTranslationUtils::GetBitmap. This is one of two which load images from program
-	// resources.
-	for (int8 i = 1; i <= 5; i++)
+	// The loader gets the picture we ask for from the cache, and then the one
+	// after it on a thread of its own, since that is the one shown next.
+	image_key keys[kPictureCount];
+	for (int32 i = 0; i < kPictureCount; i++)
 	{
-		BBitmap *smiley = BTranslationUtils::GetBitmap(B_PNG_FORMAT,i);
-		 fBitmaps[i - 1] = (smiley && smiley->IsValid()) ? smiley : NULL;
+		keys[i].source = i + 1;
+		keys[i].width = 0;
+		keys[i].height = 0;
+		keys[i].colorSpace = B_RGBA32;
 	}
+	fLoader = new PictureLoader(acquire_cache(),keys,kPictureCount);
 	
-	if (fBitmaps[0] && fBitmaps[0]->IsValid())
-		ResizeTo(fBitmaps[0]->Bounds().Width(),fBitmaps[0]->Bounds().Height());
+	BBitmap *first = (BBitmap*)fLoader->Get(0);
+	if (first)
+		ResizeTo(first->Bounds().Width(),first->Bounds().Height());
 }
 
 
 PictureView::~PictureView(void)
 {
+	delete fLoader;
+	release_cache();
 }
 
 
@@ -34,9 +187,12 @@ PictureView::~PictureView(void)
 void
 PictureView::Draw(BRect rect)
 {
-	// Alpha transparency is ignored in the default drawing mode for performance reasons,
-	// so we will set the drawing mode to utilizes transparency information.
-	SetDrawingMode(B_OP_ALPHA);
+	// Alpha transparency is ignored in the default drawing mode for performance reasons.
+	// Our pictures were already blended over white when they were decoded, so they
+	// are opaque and can be copied to the screen as they are, which is the fastest
+	// there is. A picture that is drawn over something that changes would need the
+	// B_OP_ALPHA drawing mode instead, which blends it again on every paint.
+	SetDrawingMode(B_OP_COPY);
 	
 	// Set the foreground color of the BView to white
 	SetHighColor(255,255,255);
@@ -47,9 +203,11 @@ PictureView::Draw(BRect rect)
 	// and low colors.
 	FillRect(Bounds());
 	
-	// Draw the current bitmap on the screen
-	if (fBitmaps[fBitmapIndex])
-		DrawBitmap(fBitmaps[fBitmapIndex]);
+	// Draw the current bitmap on the screen. If it isn't decoded yet, this waits
+	// for it.
+	BBitmap *bitmap = (BBitmap*)fLoader->Get(fBitmapIndex);
+	if (bitmap)
+		DrawBitmap(bitmap);
 	
 	// Set the foreground color to black
 	SetHighColor(0,0,0);
@@ -68,11 +226,8 @@ PictureView::Draw(BRect rect)
 void
 PictureView::MouseUp(BPoint pt)
 {
-	// Go to the next image in the array or loop around to the beginning if at the end.
-	if (fBitmapIndex == sizeof(*fBitmaps))
-		fBitmapIndex = 0;
-	else
-		fBitmapIndex++;
+	// Go to the next image or loop around to the beginning if at the end.
+	fBitmapIndex = (fBitmapIndex + 1) % fLoader->CountPictures();
 	
 	// Force a redraw of the entire view because we've changed pictures
 	Invalidate();
@@ -6,6 +6,8 @@
 #include <String.h>
 #include <View.h>
 
+#include "PictureLoader.h"
+
 class PictureView : public BView
 {
 public:
@@ -16,7 +18,7 @@ public:
 	void			MouseUp(BPoint pt);
 	
 private:
-	BBitmap			*fBitmaps[5];
+	PictureLoader	*fLoader;
 	int8			fBitmapIndex;
 };
 
@@ -0,0 +1,333 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Puts the ImageCache through its paces with the pictures of
+	Resources.rsrc, decoded with libpng into plain memory.
+
+	First, a number of threads all ask for the same image at once,
+	which should only be decoded by one of them. Then the threads get
+	images at every size and in both byte orders, some of them much
+	more often than others, without the cache and with it, within a
+	budget of a part of what all of them take, and it prints how
+	often the images were in the cache and how long getting them took.
+*/
+
+
+#include <atomic>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ImageCache.h"
+#include "Random.h"
+#include "ResourceDecoder.h"
+#include "ResourceReader.h"
+
+
+static const int32 kSizes[] = { 16, 24, 32, 48, 64, 96, 128 };
+static const int32 kSizeCount = sizeof(kSizes) / sizeof(kSizes[0]);
+static const uint32 kOrders[] = { kRGBAOrder, kBGRAOrder };
+
+
+/*	Counts the images that are really decoded, and can take longer
+	to decode them, like much bigger images would.
+*/
+class CountingDecoder : public ResourceDecoder
+{
+public:
+	CountingDecoder(const ResourceReader& reader)
+		:
+		ResourceDecoder(reader),
+		fDecodes(0),
+		fDelay(0)
+	{
+	}
+	
+	virtual void* Decode(const image_key& key, size_t* _bytes)
+	{
+		fDecodes++;
+		if (fDelay > 0)
+			usleep(fDelay);
+		return ResourceDecoder::Decode(key, _bytes);
+	}
+	
+	int32 CountDecodes() const { return fDecodes; }
+	void SetDelay(bigtime_t delay) { fDelay = delay; }
+	
+private:
+	std::atomic<int32>		fDecodes;
+	bigtime_t				fDelay;
+};
+
+
+struct run {
+	ImageCache*				cache;
+	ImageDecoder*			decoder;
+	const image_key*		keys;
+	const double*			weights;
+								// Adding up to 1, from the first key
+	int32					keyCount;
+	int32					gets;
+	uint32					seed;
+	pthread_barrier_t*		barrier;
+	uint32					sum;
+};
+
+
+/*	Pick a key, the first ones far more often than the last ones.
+*/
+static int32
+pick_key(const run* job, Random& random)
+{
+	double value = (random.Next() & 0xffffff) / (double)0x1000000;
+	int32 low = 0;
+	int32 high = job->keyCount - 1;
+	while (low < high) {
+		int32 middle = (low + high) / 2;
+		if (job->weights[middle] > value)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low;
+}
+
+
+static void*
+get_images(void* data)
+{
+	run* job = (run*)data;
+	Random random(job->seed);
+	
+	pthread_barrier_wait(job->barrier);
+	
+	for (int32 i = 0; i < job->gets; i++) {
+		const image_key& key = job->keys[pick_key(job, random)];
+		
+		// Look at a pixel, like drawing it would
+		if (job->cache != NULL) {
+			rgba_image* image = (rgba_image*)job->cache->Acquire(key);
+			if (image != NULL)
+				job->sum += *(uint32*)image->bits;
+			job->cache->Release(key);
+		} else {
+			size_t bytes;
+			rgba_image* image = (rgba_image*)job->decoder->Decode(key,
+				&bytes);
+			if (image != NULL) {
+				job->sum += *(uint32*)image->bits;
+				job->decoder->Free(image);
+			}
+		}
+	}
+	
+	return NULL;
+}
+
+
+/*	Run "threads" threads getting "gets" images each, all starting
+	at the same time, and return how long that took.
+*/
+static bigtime_t
+run_threads(int32 threads, ImageCache* cache, ImageDecoder* decoder,
+	const image_key* keys, const double* weights, int32 keyCount,
+	int32 gets)
+{
+	pthread_barrier_t barrier;
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+	
+	run* jobs = new run[threads];
+	pthread_t* ids = new pthread_t[threads];
+	for (int32 i = 0; i < threads; i++) {
+		jobs[i].cache = cache;
+		jobs[i].decoder = decoder;
+		jobs[i].keys = keys;
+		jobs[i].weights = weights;
+		jobs[i].keyCount = keyCount;
+		jobs[i].gets = gets;
+		jobs[i].seed = i + 1;
+		jobs[i].barrier = &barrier;
+		jobs[i].sum = 0;
+		pthread_create(&ids[i], NULL, &get_images, &jobs[i]);
+	}
+	
+	pthread_barrier_wait(&barrier);
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+	bigtime_t time = system_time() - start;
+	
+	delete[] jobs;
+	delete[] ids;
+	pthread_barrier_destroy(&barrier);
+	
+	return time;
+}
+
+
+static void
+print_stats(const image_cache_stats& stats, CountingDecoder& decoder,
+	int32 decodesBefore)
+{
+	int64 gets = stats.hits + stats.misses;
+	printf("  hits %lld  misses %lld (%.1f%% hits)  coalesced %lld  "
+		"evictions %lld\n", (long long)stats.hits, (long long)stats.misses,
+		gets > 0 ? 100.0 * stats.hits / gets : 0.0,
+		(long long)stats.coalesced, (long long)stats.evictions);
+	printf("  decoded %d times, %lld failed\n",
+		(int)(decoder.CountDecodes() - decodesBefore),
+		(long long)stats.failures);
+	printf("  hit %.2f us on average, %lld at most;  miss %.1f us on "
+		"average, %lld at most\n",
+		stats.hits > 0 ? (double)stats.hitTime / stats.hits : 0.0,
+		(long long)stats.maxHitTime,
+		stats.misses > 0 ? (double)stats.missTime / stats.misses : 0.0,
+		(long long)stats.maxMissTime);
+	printf("  %d images, %d acquired, %lu bytes now, %lu at most\n",
+		(int)stats.images, (int)stats.acquired, (unsigned long)stats.bytes,
+		(unsigned long)stats.maxBytes);
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--file resources] [--threads n] "
+		"[--gets n]\n"
+		"\t[--budget percent]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* path = "../Resources.rsrc";
+	int32 threads = 8;
+	int32 gets = 20000;
+	int32 budgetPercent = 25;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--file") == 0)
+			path = argv[i + 1];
+		else if (strcmp(argv[i], "--threads") == 0)
+			threads = value;
+		else if (strcmp(argv[i], "--gets") == 0)
+			gets = value;
+		else if (strcmp(argv[i], "--budget") == 0)
+			budgetPercent = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (threads < 1 || gets < 1 || budgetPercent < 0)
+		usage(argv[0]);
+	
+	ResourceReader reader;
+	if (reader.SetTo(path) != B_OK) {
+		fprintf(stderr, "%s is not a resource file\n", path);
+		return 1;
+	}
+	
+	int32 pictures = 0;
+	while (reader.HasResource(kPictureType, pictures + 1))
+		pictures++;
+	if (pictures == 0) {
+		fprintf(stderr, "There are no PNG resources in %s\n", path);
+		return 1;
+	}
+	
+	// Every picture at every size in both byte orders, shuffled so
+	// the ones asked for the most aren't all of one picture or size
+	int32 keyCount = pictures * kSizeCount * 2;
+	image_key* keys = new image_key[keyCount];
+	size_t allBytes = 0;
+	for (int32 i = 0; i < keyCount; i++) {
+		int32 size = kSizes[i / 2 % kSizeCount];
+		image_key key = { (uint32)(i / (kSizeCount * 2) + 1), size, size,
+			kOrders[i % 2] };
+		keys[i] = key;
+		allBytes += size * size * 4;
+	}
+	
+	Random random(1);
+	for (int32 i = keyCount - 1; i > 0; i--) {
+		int32 other = random.Range(0, i);
+		image_key key = keys[i];
+		keys[i] = keys[other];
+		keys[other] = key;
+	}
+	
+	// Zipf, the second key is asked for half as often as the
+	// first one, the third a third as often and so on
+	double* weights = new double[keyCount];
+	double total = 0;
+	for (int32 i = 0; i < keyCount; i++) {
+		total += 1.0 / (i + 1);
+		weights[i] = total;
+	}
+	for (int32 i = 0; i < keyCount; i++)
+		weights[i] /= total;
+	
+	CountingDecoder decoder(reader);
+	size_t budget = allBytes * budgetPercent / 100;
+	
+	printf("ImageCache headless: %d images of %d pictures, %lu bytes in "
+		"all, %d threads\n", (int)keyCount, (int)pictures,
+		(unsigned long)allBytes, (int)threads);
+	
+	// The same image, asked for by every thread at once, taking
+	// long enough to decode for all of them to ask for it
+	{
+		ImageCache cache(&decoder, budget);
+		image_key key = { 1, 128, 128, kBGRAOrder };
+		double one = 1.0;
+		int32 decodes = decoder.CountDecodes();
+		decoder.SetDelay(20000);
+		run_threads(threads, &cache, &decoder, &key, &one, 1, 1);
+		decoder.SetDelay(0);
+		
+		image_cache_stats stats;
+		cache.GetStats(&stats);
+		printf("one image taking 20 ms to decode, one get on every thread "
+			"at once:\n");
+		print_stats(stats, decoder, decodes);
+	}
+	
+	// Without the cache, every get decodes
+	int32 decodes = decoder.CountDecodes();
+	int32 uncachedGets = gets / 10 > 0 ? gets / 10 : 1;
+	bigtime_t time = run_threads(threads, NULL, &decoder, keys, weights,
+		keyCount, uncachedGets);
+	printf("%d gets on every thread without the cache: %.0f gets a "
+		"second, decoded %d times\n", (int)uncachedGets,
+		(double)threads * uncachedGets * 1000000 / time,
+		(int)(decoder.CountDecodes() - decodes));
+	
+	ImageCache cache(&decoder, budget);
+	decodes = decoder.CountDecodes();
+	time = run_threads(threads, &cache, &decoder, keys, weights, keyCount,
+		gets);
+	
+	image_cache_stats stats;
+	cache.GetStats(&stats);
+	printf("%d gets on every thread with a budget of %d%% (%lu bytes): "
+		"%.0f gets a second\n", (int)gets, (int)budgetPercent,
+		(unsigned long)budget, (double)threads * gets * 1000000 / time);
+	print_stats(stats, decoder, decodes);
+	
+	delete[] keys;
+	delete[] weights;
+	
+	return 0;
+}
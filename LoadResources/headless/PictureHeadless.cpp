@@ -0,0 +1,232 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Loads the pictures of Resources.rsrc the way PictureView does,
+	without Haiku: the PNG resources are read with the ResourceReader
+	and decoded with libpng into plain memory.
+
+	It first decodes all of them up front, the way PictureView used
+	to, and then only the first one through a PictureLoader and an
+	ImageCache, and prints how long it took until the first picture
+	could be painted and how much memory the pictures took. Then it
+	clicks through the pictures, giving the loader some time in between
+	like a person would, and prints how long every click waited for its
+	picture. Last, a second loader, like the PictureView of a window
+	opened after the first one closed, goes through the pictures once
+	with the same cache.
+*/
+
+
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "PictureLoader.h"
+#include "ResourceDecoder.h"
+#include "ResourceReader.h"
+
+
+/*	The PNG resources with the IDs from 1 up, "copies" times over to
+	have more of them. The source of a key is the index of the picture
+	plus one.
+*/
+class ResourcePictures : public ImageDecoder
+{
+public:
+	ResourcePictures(const ResourceReader& reader, int32 copies)
+		:
+		fReader(reader),
+		fDecoder(reader),
+		fCount(0),
+		fCopies(copies)
+	{
+		while (fReader.HasResource(kPictureType, fCount + 1))
+			fCount++;
+	}
+	
+	int32 CountPictures() const
+	{
+		return fCount * fCopies;
+	}
+	
+	image_key KeyFor(int32 index) const
+	{
+		image_key key = { (uint32)index + 1, 0, 0, kRGBAOrder };
+		return key;
+	}
+	
+	virtual void* Decode(const image_key& key, size_t* _bytes)
+	{
+		image_key resource = key;
+		resource.source = (key.source - 1) % fCount + 1;
+		return fDecoder.Decode(resource, _bytes);
+	}
+	
+	virtual void Free(void* image)
+	{
+		fDecoder.Free(image);
+	}
+	
+private:
+	const ResourceReader&	fReader;
+	ResourceDecoder			fDecoder;
+	int32					fCount;
+	int32					fCopies;
+};
+
+
+static bigtime_t
+percentile(const bigtime_t* sorted, int32 count, int32 percent)
+{
+	return sorted[(int64)(count - 1) * percent / 100];
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--file resources] [--cap bytes] "
+		"[--clicks n]\n"
+		"\t[--think us] [--copies n]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* path = "../Resources.rsrc";
+	int32 cap = 32 * 1024;
+	int32 clicks = 50;
+	int32 think = 5000;
+	int32 copies = 1;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		int32 value = atoi(argv[i + 1]);
+		if (strcmp(argv[i], "--file") == 0)
+			path = argv[i + 1];
+		else if (strcmp(argv[i], "--cap") == 0)
+			cap = value;
+		else if (strcmp(argv[i], "--clicks") == 0)
+			clicks = value;
+		else if (strcmp(argv[i], "--think") == 0)
+			think = value;
+		else if (strcmp(argv[i], "--copies") == 0)
+			copies = value;
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (cap < 0 || clicks < 1 || think < 0 || copies < 1)
+		usage(argv[0]);
+	
+	ResourceReader reader;
+	if (reader.SetTo(path) != B_OK) {
+		fprintf(stderr, "%s is not a resource file\n", path);
+		return 1;
+	}
+	
+	ResourcePictures source(reader, copies);
+	int32 count = source.CountPictures();
+	if (count == 0) {
+		fprintf(stderr, "There are no PNG resources in %s\n", path);
+		return 1;
+	}
+	
+	printf("PictureView headless: %d pictures from %s, cap %d bytes\n",
+		(int)count, path, (int)cap);
+	
+	// Everything up front, like PictureView used to
+	bigtime_t start = system_time();
+	void** pictures = new void*[count];
+	size_t eagerBytes = 0;
+	for (int32 i = 0; i < count; i++) {
+		size_t bytes = 0;
+		pictures[i] = source.Decode(source.KeyFor(i), &bytes);
+		eagerBytes += bytes;
+	}
+	bigtime_t eager = system_time() - start;
+	
+	for (int32 i = 0; i < count; i++) {
+		if (pictures[i] != NULL)
+			source.Free(pictures[i]);
+	}
+	delete[] pictures;
+	
+	printf("all up front: first paint after %lld us, %lu bytes resident\n",
+		(long long)eager, (unsigned long)eagerBytes);
+	
+	image_key* keys = new image_key[count];
+	for (int32 i = 0; i < count; i++)
+		keys[i] = source.KeyFor(i);
+	
+	// Only the first one, and the next in the background
+	start = system_time();
+	ImageCache cache(&source, cap > 0 ? (size_t)cap : SIZE_MAX);
+	PictureLoader* loader = new PictureLoader(&cache, keys, count);
+	rgba_image* first = (rgba_image*)loader->Get(0);
+	bigtime_t lazy = system_time() - start;
+	if (first == NULL) {
+		fprintf(stderr, "The first picture could not be decoded\n");
+		return 1;
+	}
+	
+	image_cache_stats stats;
+	cache.GetStats(&stats);
+	printf("on demand:    first paint after %lld us, %lu bytes resident "
+		"(%dx%d)\n", (long long)lazy, (unsigned long)stats.bytes,
+		(int)first->width, (int)first->height);
+	
+	bigtime_t* waits = new bigtime_t[clicks];
+	int32 index = 0;
+	for (int32 click = 0; click < clicks; click++) {
+		usleep(think);
+		
+		index = (index + 1) % count;
+		start = system_time();
+		loader->Get(index);
+		waits[click] = system_time() - start;
+	}
+	
+	std::sort(waits, waits + clicks);
+	printf("%d clicks, %d us apart: waited p50 %lld us  p99 %lld us  "
+		"max %lld us\n", (int)clicks, (int)think,
+		(long long)percentile(waits, clicks, 50),
+		(long long)percentile(waits, clicks, 99),
+		(long long)waits[clicks - 1]);
+	cache.GetStats(&stats);
+	printf("decoded %lld times, %d gotten in the background, waited for "
+		"%d, freed %lld\n", (long long)(stats.misses - stats.coalesced),
+		(int)loader->CountPrefetches(), (int)loader->CountWaits(),
+		(long long)stats.evictions);
+	printf("resident: %lu bytes now, %lu at most\n",
+		(unsigned long)stats.bytes, (unsigned long)stats.maxBytes);
+	
+	// Another window once the first one is closed, which leaves its
+	// pictures in the cache
+	delete loader;
+	cache.ResetStats();
+	loader = new PictureLoader(&cache, keys, count);
+	for (int32 i = 0; i < count; i++)
+		loader->Get(i);
+	delete loader;
+	
+	cache.GetStats(&stats);
+	printf("a second window: %lld of %d pictures decoded again\n",
+		(long long)(stats.misses - stats.coalesced), (int)count);
+	
+	delete[] keys;
+	delete[] waits;
+	
+	return 0;
+}
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Times decoding PNG images into B_RGBA32 pixels: with libpng the
+	way it decodes by default, into straight alpha, with libpng and
+	then premultiplied, and with the PngDecoder, in plain C++ and with
+	SSE2. The PngDecoder has to give the very same pixels as libpng
+	and premultiplying does, or it says so.
+
+	The images are the pictures of Resources.rsrc, and bigger ones it
+	makes up and encodes with libpng, each with only one of the PNG
+	filters, with the filters libpng picks, opaque and without alpha.
+*/
+
+
+#include <png.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "PngDecoder.h"
+#include "Random.h"
+#include "ResourceDecoder.h"
+#include "ResourceReader.h"
+
+
+enum {
+	kLibpng,
+	kLibpngPremultiplied,
+	kPlain,
+	kVectorized,
+	kWayCount
+};
+
+static const char* kWayNames[] = { "libpng", "+ premul", "PngDecoder C++",
+	"PngDecoder SSE2" };
+
+
+struct test_image {
+	char					name[32];
+	uint8*					data;
+	size_t					size;
+	int32					width;
+	int32					height;
+	bool					ownsData;
+};
+
+
+struct png_buffer {
+	uint8*					data;
+	size_t					size;
+	size_t					capacity;
+};
+
+
+static void
+write_to_buffer(png_structp png, png_bytep data, png_size_t length)
+{
+	png_buffer* buffer = (png_buffer*)png_get_io_ptr(png);
+	if (buffer->size + length > buffer->capacity) {
+		buffer->capacity = (buffer->size + length) * 2;
+		buffer->data = (uint8*)realloc(buffer->data, buffer->capacity);
+	}
+	memcpy(buffer->data + buffer->size, data, length);
+	buffer->size += length;
+}
+
+
+/*	Encode RGBA pixels, or only the RGB of them, with the given
+	PNG_FILTER_* flags for libpng to pick from.
+*/
+static uint8*
+encode_png(const uint8* pixels, int32 width, int32 height, bool alpha,
+	int filters, size_t* _size)
+{
+	png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL,
+		NULL, NULL);
+	png_infop info = png_create_info_struct(png);
+	png_buffer buffer = { NULL, 0, 0 };
+	uint8* row = new uint8[width * 4];
+	
+	if (setjmp(png_jmpbuf(png))) {
+		png_destroy_write_struct(&png, &info);
+		free(buffer.data);
+		delete[] row;
+		return NULL;
+	}
+	
+	png_set_write_fn(png, &buffer, &write_to_buffer, NULL);
+	png_set_IHDR(png, info, width, height, 8,
+		alpha ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB,
+		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+		PNG_FILTER_TYPE_DEFAULT);
+	png_set_filter(png, PNG_FILTER_TYPE_BASE, filters);
+	png_write_info(png, info);
+	
+	for (int32 y = 0; y < height; y++) {
+		const uint8* source = pixels + y * width * 4;
+		if (alpha)
+			memcpy(row, source, width * 4);
+		else {
+			for (int32 x = 0; x < width; x++)
+				memcpy(row + x * 3, source + x * 4, 3);
+		}
+		png_write_row(png, row);
+	}
+	
+	png_write_end(png, NULL);
+	png_destroy_write_struct(&png, &info);
+	delete[] row;
+	
+	*_size = buffer.size;
+	return buffer.data;
+}
+
+
+/*	Something like a big icon: smooth colors with some noise, and an
+	edge that fades out, or none if it is opaque.
+*/
+static uint8*
+make_pixels(int32 width, int32 height, bool opaque)
+{
+	uint8* pixels = new uint8[width * height * 4];
+	Random random(7);
+	
+	for (int32 y = 0; y < height; y++) {
+		for (int32 x = 0; x < width; x++) {
+			uint8* pixel = pixels + (y * width + x) * 4;
+			int32 noise = random.Range(0, 15);
+			pixel[0] = (x * 255 / width + noise) & 0xff;
+			pixel[1] = (y * 255 / height + noise) & 0xff;
+			pixel[2] = ((x ^ y) & 0x3f) * 3 + noise;
+			
+			int32 dx = 2 * x - width;
+			int32 dy = 2 * y - height;
+			int64 distance = (int64)dx * dx + (int64)dy * dy;
+			int64 radius = (int64)width * width;
+			int32 alpha = (int32)(255 * (radius - distance) * 4 / radius);
+			if (opaque || alpha > 255)
+				alpha = 255;
+			pixel[3] = alpha > 0 ? alpha : 0;
+		}
+	}
+	
+	return pixels;
+}
+
+
+static bool
+decode(int32 way, const test_image& image, uint8* bits)
+{
+	if (way == kLibpng || way == kLibpngPremultiplied) {
+		png_image decoded;
+		memset(&decoded, 0, sizeof(decoded));
+		decoded.version = PNG_IMAGE_VERSION;
+		if (!png_image_begin_read_from_memory(&decoded, image.data,
+				image.size))
+			return false;
+		
+		decoded.format = PNG_FORMAT_BGRA;
+		if (!png_image_finish_read(&decoded, NULL, bits, 0, NULL)) {
+			png_image_free(&decoded);
+			return false;
+		}
+		
+		if (way == kLibpngPremultiplied) {
+			PngDecoder::SetVectorized(true);
+			PngDecoder::Premultiply(bits, image.width, image.height,
+				image.width * 4);
+		}
+		return true;
+	}
+	
+	PngDecoder::SetVectorized(way == kVectorized);
+	PngDecoder decoder;
+	return decoder.SetTo(image.data, image.size) == B_OK
+		&& decoder.Decode(bits, image.width * 4) == B_OK;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [--file resources] [--size pixels] "
+		"[--pixels millions]\n", name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* path = "../Resources.rsrc";
+	int32 size = 512;
+	int32 millions = 5;
+	
+	for (int i = 1; i < argc; i++) {
+		if (i + 1 >= argc)
+			usage(argv[0]);
+		
+		if (strcmp(argv[i], "--file") == 0)
+			path = argv[i + 1];
+		else if (strcmp(argv[i], "--size") == 0)
+			size = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "--pixels") == 0)
+			millions = atoi(argv[i + 1]);
+		else
+			usage(argv[0]);
+		i++;
+	}
+	
+	if (size < 1 || millions < 1)
+		usage(argv[0]);
+	
+	ResourceReader reader;
+	if (reader.SetTo(path) != B_OK) {
+		fprintf(stderr, "%s is not a resource file\n", path);
+		return 1;
+	}
+	
+	test_image images[16];
+	int32 count = 0;
+	for (int32 id = 1; count < 6 && reader.HasResource(kPictureType, id);
+			id++) {
+		test_image& image = images[count];
+		image.data = (uint8*)reader.LoadResource(kPictureType, id,
+			&image.size);
+		image.ownsData = false;
+		snprintf(image.name, sizeof(image.name), "resource %d", (int)id);
+		count++;
+	}
+	
+	static const struct {
+		const char*	name;
+		int			filters;
+		bool		alpha;
+		bool		opaque;
+	} kMadeUp[] = {
+		{ "sub", PNG_FILTER_SUB, true, false },
+		{ "up", PNG_FILTER_UP, true, false },
+		{ "average", PNG_FILTER_AVG, true, false },
+		{ "paeth", PNG_FILTER_PAETH, true, false },
+		{ "any filter", PNG_ALL_FILTERS, true, false },
+		{ "opaque", PNG_ALL_FILTERS, true, true },
+		{ "no alpha", PNG_ALL_FILTERS, false, true }
+	};
+	
+	uint8* pixels[2] = { make_pixels(size, size, false),
+		make_pixels(size, size, true) };
+	for (size_t i = 0; i < sizeof(kMadeUp) / sizeof(kMadeUp[0]); i++) {
+		test_image& image = images[count];
+		image.data = encode_png(pixels[kMadeUp[i].opaque ? 1 : 0], size,
+			size, kMadeUp[i].alpha, kMadeUp[i].filters, &image.size);
+		image.ownsData = true;
+		snprintf(image.name, sizeof(image.name), "%s %dx%d",
+			kMadeUp[i].name, (int)size, (int)size);
+		if (image.data != NULL)
+			count++;
+	}
+	delete[] pixels[0];
+	delete[] pixels[1];
+	
+	printf("PNG decoding, megapixels a second, ~%d million pixels each\n",
+		(int)millions);
+	printf("%-18s %9s", "image", "bytes");
+	for (int32 way = 0; way < kWayCount; way++)
+		printf(" %15s", kWayNames[way]);
+	printf("  opaque\n");
+	
+	bool allSame = true;
+	for (int32 i = 0; i < count; i++) {
+		test_image& image = images[i];
+		PngDecoder decoder;
+		if (decoder.SetTo(image.data, image.size) != B_OK) {
+			printf("%-18s can't be decoded\n", image.name);
+			continue;
+		}
+		image.width = decoder.Width();
+		image.height = decoder.Height();
+		
+		int32 pixelCount = image.width * image.height;
+		int32 rounds = (int32)((int64)millions * 1000000 / pixelCount);
+		if (rounds < 1)
+			rounds = 1;
+		
+		uint8* bits[kWayCount];
+		printf("%-18s %9lu", image.name, (unsigned long)image.size);
+		for (int32 way = 0; way < kWayCount; way++) {
+			bits[way] = new uint8[pixelCount * 4];
+			decode(way, image, bits[way]);
+			
+			bigtime_t start = system_time();
+			for (int32 round = 0; round < rounds; round++)
+				decode(way, image, bits[way]);
+			bigtime_t time = system_time() - start;
+			
+			printf(" %15.1f", (double)pixelCount * rounds / time);
+			fflush(stdout);
+		}
+		
+		decoder.Decode(bits[kVectorized], image.width * 4);
+		printf("  %s\n", decoder.IsOpaque() ? "yes" : "no");
+		
+		for (int32 way = kPlain; way < kWayCount; way++) {
+			if (memcmp(bits[way], bits[kLibpngPremultiplied],
+					pixelCount * 4) != 0) {
+				printf("  %s doesn't give the same pixels as libpng\n",
+					kWayNames[way]);
+				allSame = false;
+			}
+		}
+		
+		for (int32 way = 0; way < kWayCount; way++)
+			delete[] bits[way];
+	}
+	
+	// Flattening over the white of PictureView has to come out the
+	// same both ways too
+	uint8* flat[2];
+	for (int32 i = 0; i < 2; i++) {
+		flat[i] = make_pixels(size, size, false);
+		PngDecoder::SetVectorized(false);
+		PngDecoder::Premultiply(flat[i], size, size, size * 4);
+		PngDecoder::SetVectorized(i == 1);
+		PngDecoder::Flatten(flat[i], size, size, size * 4, 0xffffff);
+	}
+	if (memcmp(flat[0], flat[1], size * size * 4) != 0) {
+		printf("Flattening with SSE2 doesn't give the same pixels\n");
+		allSame = false;
+	}
+	delete[] flat[0];
+	delete[] flat[1];
+	
+	for (int32 i = 0; i < count; i++) {
+		if (images[i].ownsData)
+			free(images[i].data);
+	}
+	
+	return allSame ? 0 : 1;
+}
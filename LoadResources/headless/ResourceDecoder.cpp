@@ -0,0 +1,118 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ResourceDecoder.h"
+
+#include <png.h>
+#include <string.h>
+
+#include "PngDecoder.h"
+
+
+ResourceDecoder::ResourceDecoder(const ResourceReader& reader)
+	:
+	fReader(reader)
+{
+	// Empty
+}
+
+
+void*
+ResourceDecoder::Decode(const image_key& key, size_t* _bytes)
+{
+	if ((key.colorSpace != kRGBAOrder && key.colorSpace != kBGRAOrder
+			&& key.colorSpace != kPremultipliedOrder)
+		|| key.width < 0 || key.height < 0)
+		return NULL;
+	
+	size_t size;
+	const void* data = fReader.LoadResource(kPictureType, key.source, &size);
+	if (data == NULL)
+		return NULL;
+	
+	int32 width;
+	int32 height;
+	uint8* bits = _DecodePng(data, size, key.colorSpace, &width, &height);
+	if (bits == NULL)
+		return NULL;
+	
+	rgba_image* decoded = new rgba_image;
+	decoded->width = key.width > 0 ? key.width : width;
+	decoded->height = key.height > 0 ? key.height : height;
+	decoded->bytesPerRow = decoded->width * 4;
+	
+	if (decoded->width == width && decoded->height == height)
+		decoded->bits = bits;
+	else {
+		// Take the pixel closest to the center of every new one
+		decoded->bits = new uint8[decoded->bytesPerRow * decoded->height];
+		for (int32 y = 0; y < decoded->height; y++) {
+			const uint32* source = (const uint32*)bits
+				+ (2 * y + 1) * height / (2 * decoded->height) * width;
+			uint32* dest = (uint32*)(decoded->bits + y * decoded->bytesPerRow);
+			for (int32 x = 0; x < decoded->width; x++)
+				dest[x] = source[(2 * x + 1) * width / (2 * decoded->width)];
+		}
+		delete[] bits;
+	}
+	
+	*_bytes = decoded->bytesPerRow * decoded->height;
+	return decoded;
+}
+
+
+/*	Decode the PNG at the size it has.
+*/
+uint8*
+ResourceDecoder::_DecodePng(const void* data, size_t size, uint32 order,
+	int32* _width, int32* _height)
+{
+	if (order == kPremultipliedOrder) {
+		PngDecoder decoder;
+		status_t status = decoder.SetTo(data, size);
+		if (status == B_OK) {
+			*_width = decoder.Width();
+			*_height = decoder.Height();
+			uint8* bits = new uint8[*_width * *_height * 4];
+			if (decoder.Decode(bits, *_width * 4) != B_OK) {
+				delete[] bits;
+				return NULL;
+			}
+			return bits;
+		}
+		if (status != B_BAD_TYPE)
+			return NULL;
+	}
+	
+	png_image image;
+	memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_memory(&image, data, size))
+		return NULL;
+	
+	image.format = order == kRGBAOrder ? PNG_FORMAT_RGBA : PNG_FORMAT_BGRA;
+	uint8* bits = new uint8[PNG_IMAGE_SIZE(image)];
+	if (!png_image_finish_read(&image, NULL, bits, 0, NULL)) {
+		png_image_free(&image);
+		delete[] bits;
+		return NULL;
+	}
+	
+	*_width = image.width;
+	*_height = image.height;
+	if (order == kPremultipliedOrder)
+		PngDecoder::Premultiply(bits, *_width, *_height, *_width * 4);
+	return bits;
+}
+
+
+void
+ResourceDecoder::Free(void* image)
+{
+	rgba_image* decoded = (rgba_image*)image;
+	delete[] decoded->bits;
+	delete decoded;
+}
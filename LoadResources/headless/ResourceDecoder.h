@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef _RESOURCEDECODER_H_
+#define _RESOURCEDECODER_H_
+
+
+#include "ImageCache.h"
+#include "ResourceReader.h"
+
+
+// The byte orders ResourceDecoder decodes to, as the color space
+// of an image_key. 'BGRA' is how B_RGBA32 is laid out in memory,
+// and 'BGRp' is the same with premultiplied colors.
+const uint32 kRGBAOrder = 'RGBA';
+const uint32 kBGRAOrder = 'BGRA';
+const uint32 kPremultipliedOrder = 'BGRp';
+
+// The type of the resources it decodes
+const type_code kPictureType = 'PNG ';
+
+
+/*	A decoded image, four bytes a pixel.
+*/
+struct rgba_image {
+	uint8*				bits;
+	int32				width;
+	int32				height;
+	int32				bytesPerRow;
+};
+
+
+/*	Decodes the PNG resources of a resource file into plain memory,
+	as rgba_images. The source of a key is the ID of the resource.
+	Premultiplied images are decoded with the PngDecoder, unless it
+	can't decode them, and the others with libpng. Images of another
+	size than the resource are scaled to it, taking the nearest pixel.
+*/
+class ResourceDecoder : public ImageDecoder
+{
+public:
+							ResourceDecoder(const ResourceReader& reader);
+	
+	virtual void*			Decode(const image_key& key, size_t* _bytes);
+	virtual void			Free(void* image);
+	
+private:
+	uint8*					_DecodePng(const void* data, size_t size,
+								uint32 order, int32* _width,
+								int32* _height);
+	
+	const ResourceReader&	fReader;
+};
+
+
+#endif
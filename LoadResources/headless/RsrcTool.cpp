@@ -0,0 +1,325 @@
+/*
+ * Copyright 2026 HaikuApiExamples contributors. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*	Lists and extracts the resources of a Haiku resource file, like
+	Resources.rsrc here or HaikuFortune.rsrc, with the ResourceReader
+	instead of the Storage Kit, so it runs anywhere.
+
+	It also times opening a file and looking up every resource in it,
+	with the index and by going through all of them, and the same for
+	made up files with many more resources.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Random.h"
+#include "ResourceReader.h"
+
+
+static const type_code kBenchmarkType = 'BNCH';
+static const int32 kBenchmarkCounts[] = { 10, 1000, 100000 };
+static const int32 kBenchmarkLookups = 1000000;
+
+
+static void
+type_string(type_code type, char* string)
+{
+	for (int32 i = 0; i < 4; i++) {
+		char c = (char)(type >> (24 - i * 8));
+		string[i] = c >= ' ' && c <= '~' ? c : '.';
+	}
+	string[4] = '\0';
+}
+
+
+/*	"PNG" is 'PNG ', types are padded with spaces.
+*/
+static type_code
+parse_type(const char* string)
+{
+	type_code type = 0;
+	for (int32 i = 0; i < 4; i++) {
+		char c = *string != '\0' ? *string++ : ' ';
+		type = (type << 8) | (uint8)c;
+	}
+	return type;
+}
+
+
+static void
+put32(uint8* bytes, uint32 value)
+{
+	bytes[0] = value;
+	bytes[1] = value >> 8;
+	bytes[2] = value >> 16;
+	bytes[3] = value >> 24;
+}
+
+
+/*	Make up a resource file with "count" resources of 16 bytes, of
+	one type with IDs from 0, without names. Returns its size.
+*/
+static size_t
+build_file(int32 count, uint8** _data)
+{
+	const size_t kDataSize = 16;
+	size_t indexOffset = 68;
+	size_t entriesOffset = indexOffset + 132;
+	size_t dataOffset = entriesOffset + count * 12;
+	size_t tableOffset = dataOffset + count * kDataSize;
+	size_t tableSize = 4 + count * 10 + 8 + 8;
+	size_t size = 4 + tableOffset + tableSize;
+	
+	uint8* file = new uint8[size];
+	memset(file, 0, size);
+	memcpy(file, "RS\0\0", 4);
+	
+	uint8* resources = file + 4;
+	put32(resources, 0x444f1000);
+	put32(resources + 4, count);
+	put32(resources + 8, indexOffset);
+	put32(resources + 12, dataOffset - indexOffset);
+	put32(resources + indexOffset + 120, tableOffset);
+	put32(resources + indexOffset + 124, tableSize);
+	
+	uint8* table = resources + tableOffset;
+	put32(table, kBenchmarkType);
+	for (int32 i = 0; i < count; i++) {
+		uint8* entry = resources + entriesOffset + i * 12;
+		put32(entry, dataOffset + i * kDataSize);
+		put32(entry + 4, kDataSize);
+		memset(resources + dataOffset + i * kDataSize, i, kDataSize);
+		
+		uint8* info = table + 4 + i * 10;
+		put32(info, i);
+		put32(info + 4, i + 1);
+	}
+	
+	size_t end = tableSize - 8;
+	put32(table + end - 8, 0xffffffff);
+	put32(table + end - 4, 0xffffffff);
+	
+	uint32 checksum = 0;
+	for (size_t i = 0; i < end; i += 4) {
+		checksum += (table[i] << 24) | (table[i + 1] << 16)
+			| (table[i + 2] << 8) | table[i + 3];
+	}
+	put32(table + end, checksum);
+	
+	*_data = file;
+	return size;
+}
+
+
+static int
+list(const char* path)
+{
+	ResourceReader reader;
+	if (reader.SetTo(path) != B_OK) {
+		fprintf(stderr, "%s is not a resource file\n", path);
+		return 1;
+	}
+	
+	printf("%s: %d resources\n", path, (int)reader.CountResources());
+	for (int32 i = 0; i < reader.CountResources(); i++) {
+		type_code type;
+		int32 id;
+		const char* name;
+		size_t size;
+		reader.GetResourceInfo(i, &type, &id, &name, &size);
+		
+		char typeString[5];
+		type_string(type, typeString);
+		printf("  '%s' %8d %8lu  %s\n", typeString, (int)id,
+			(unsigned long)size, name);
+	}
+	
+	return 0;
+}
+
+
+static int
+extract(const char* path, const char* typeString, const char* which,
+	const char* output)
+{
+	ResourceReader reader;
+	if (reader.SetTo(path) != B_OK) {
+		fprintf(stderr, "%s is not a resource file\n", path);
+		return 1;
+	}
+	
+	// A number is an ID, anything else a name
+	type_code type = parse_type(typeString);
+	char* end;
+	long id = strtol(which, &end, 0);
+	size_t size;
+	const void* data = *which != '\0' && *end == '\0'
+		? reader.LoadResource(type, (int32)id, &size)
+		: reader.LoadResource(type, which, &size);
+	if (data == NULL) {
+		fprintf(stderr, "There is no '%s' resource %s in %s\n", typeString,
+			which, path);
+		return 1;
+	}
+	
+	FILE* file = output != NULL ? fopen(output, "wb") : stdout;
+	if (file == NULL) {
+		fprintf(stderr, "Could not open %s\n", output);
+		return 1;
+	}
+	
+	bool ok = fwrite(data, 1, size, file) == size;
+	if (file != stdout && fclose(file) != 0)
+		ok = false;
+	if (!ok) {
+		fprintf(stderr, "Could not write the resource\n");
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+/*	Look up "lookups" resources picked at random, with the index and
+	going through them one after the other, and print how long that
+	took with how long opening the file took.
+*/
+static void
+time_lookups(ResourceReader& reader, const char* name, double openTime,
+	int32 lookups)
+{
+	int32 count = reader.CountResources();
+	type_code* types = new type_code[count];
+	int32* ids = new int32[count];
+	for (int32 i = 0; i < count; i++)
+		reader.GetResourceInfo(i, &types[i], &ids[i], NULL, NULL);
+	
+	Random random(1);
+	size_t total = 0;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < lookups; i++) {
+		int32 pick = random.Next() % count;
+		size_t size = 0;
+		reader.LoadResource(types[pick], ids[pick], &size);
+		total += size;
+	}
+	bigtime_t indexed = system_time() - start;
+	
+	// Going through them all is a lot slower with many
+	// resources, so only as many lookups as it takes
+	int32 linearLookups = lookups;
+	if (count > 1000)
+		linearLookups = lookups / (count / 1000);
+	
+	random.SetSeed(1);
+	start = system_time();
+	for (int32 i = 0; i < linearLookups; i++) {
+		int32 pick = random.Next() % count;
+		for (int32 j = 0; j < count; j++) {
+			type_code type;
+			int32 id;
+			size_t size;
+			reader.GetResourceInfo(j, &type, &id, NULL, &size);
+			if (type == types[pick] && id == ids[pick]) {
+				total += size;
+				break;
+			}
+		}
+	}
+	bigtime_t scanned = system_time() - start;
+	
+	printf("  %-18s %6d resources: open %8.1f us, lookup %5.1f ns "
+		"indexed, %9.1f ns scanned\n", name, (int)count,
+		openTime, indexed * 1000.0 / lookups,
+		linearLookups > 0 ? scanned * 1000.0 / linearLookups : 0.0);
+	
+	// Keeps the lookups from being optimized away
+	if (total == 0)
+		printf("  (nothing found)\n");
+	
+	delete[] types;
+	delete[] ids;
+}
+
+
+static int
+benchmark(int argc, char** argv)
+{
+	printf("lookups of %d resources picked at random:\n",
+		(int)kBenchmarkLookups);
+	
+	const int32 kRounds = 1000;
+	for (int32 i = 0; i < argc; i++) {
+		ResourceReader reader;
+		bigtime_t start = system_time();
+		for (int32 round = 0; round < kRounds; round++)
+			reader.SetTo(argv[i]);
+		double open = (system_time() - start) / (double)kRounds;
+		
+		if (reader.InitCheck() != B_OK || reader.CountResources() == 0) {
+			fprintf(stderr, "%s is not a resource file, or empty\n",
+				argv[i]);
+			return 1;
+		}
+		
+		const char* name = strrchr(argv[i], '/');
+		time_lookups(reader, name != NULL ? name + 1 : argv[i], open,
+			kBenchmarkLookups);
+	}
+	
+	for (size_t i = 0;
+			i < sizeof(kBenchmarkCounts) / sizeof(kBenchmarkCounts[0]); i++) {
+		uint8* file;
+		size_t size = build_file(kBenchmarkCounts[i], &file);
+		
+		ResourceReader reader;
+		int32 rounds = kBenchmarkCounts[i] > 1000 ? 10 : kRounds;
+		bigtime_t start = system_time();
+		for (int32 round = 0; round < rounds; round++)
+			reader.SetTo(file, size);
+		double open = (system_time() - start) / (double)rounds;
+		
+		if (reader.CountResources() != kBenchmarkCounts[i]) {
+			fprintf(stderr, "The made up file with %d resources could not "
+				"be read\n", (int)kBenchmarkCounts[i]);
+			return 1;
+		}
+		
+		time_lookups(reader, "made up", open, kBenchmarkLookups);
+		reader.Unset();
+		delete[] file;
+	}
+	
+	return 0;
+}
+
+
+static void
+usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s list file\n"
+		"       %s extract file type id|name [output]\n"
+		"       %s bench file...\n", name, name, name);
+	exit(1);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	if (argc == 3 && strcmp(argv[1], "list") == 0)
+		return list(argv[2]);
+	if ((argc == 5 || argc == 6) && strcmp(argv[1], "extract") == 0)
+		return extract(argv[2], argv[3], argv[4], argc == 6 ? argv[5] : NULL);
+	if (argc >= 2 && strcmp(argv[1], "bench") == 0)
+		return benchmark(argc - 2, argv + 2);
+	
+	usage(argv[0]);
+	return 1;
+}
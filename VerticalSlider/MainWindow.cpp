@@ -1,4 +1,6 @@
 #include "MainWindow.h"
+#include <stdlib.h>
+#include <MessageRunner.h>
 #include <Slider.h>
 
 // The BString class is a phenomenally useful class which eliminates
@@ -16,14 +18,16 @@
 enum
 {
 	M_BUTTON_CLICKED = 'btcl',
-	M_SLIDE = 'slde'
+	M_SLIDE = 'slde',
+	M_FLUSH_UPDATES = 'flup'
 };
 
 
 MainWindow::MainWindow(void)
 	:	BWindow(BRect(100,100,300,300),"ClickMe",B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS | 
 																	B_QUIT_ON_WINDOW_CLOSE),
-		fCount(0)
+		fCount(0),
+		fCoalescer(this)
 {
 	// Create a slider. It has min and max value, a name, a label, and a message sent on
 	// mouse clicks. It can be vertical or horizontal, and have a block or triangle thumb
@@ -41,6 +45,15 @@ MainWindow::MainWindow(void)
 }
 
 
+MainWindow::~MainWindow(void)
+{
+	// Run it with MESSAGE_STATS=1 from a Terminal to see how many of the slider's messages
+	// were dropped because a newer one came within the same frame.
+	if (getenv("MESSAGE_STATS"))
+		fCoalescer.PrintStatistics("VerticalSlider M_SLIDE");
+}
+
+
 void
 MainWindow::MessageReceived(BMessage *msg)
 {
@@ -63,15 +76,22 @@ MainWindow::MessageReceived(BMessage *msg)
 		}
 		case M_SLIDE:
 		{
-			// Change the slider label to its current value. Notice how this happens as
-			// you slide the slider, while the window title is changed only when you
-			// release it.
-			BString labelString;
+			// Dragging the slider sends one of these for every pixel that the mouse moves,
+			// which can be many more than the screen shows. Instead of changing the label
+			// for every one of them, the coalescer keeps only the latest value and hands
+			// it to ApplyUpdate() once a frame.
 			int32 val;
 			msg->FindInt32("be:value", 0, &val);
 			
-			labelString << val;
-			slider->SetLabel(labelString);
+			if (fCoalescer.Post(M_SLIDE,slider,val))
+				ScheduleFlush();
+			break;
+		}
+		case M_FLUSH_UPDATES:
+		{
+			fCoalescer.Flush(system_time());
+			if (fCoalescer.HasPending())
+				ScheduleFlush();
 			break;
 		}
 		default:
@@ -85,3 +105,28 @@ MainWindow::MessageReceived(BMessage *msg)
 		}
 	}
 }
+
+
+void
+MainWindow::ApplyUpdate(uint32 what, void *target, int64 value)
+{
+	// Change the slider label to its current value. Notice how this happens as
+	// you slide the slider, while the window title is changed only when you
+	// release it.
+	BString labelString;
+	labelString << (int32)value;
+	slider->SetLabel(labelString);
+}
+
+
+void
+MainWindow::ScheduleFlush(void)
+{
+	// Posted right away, the flush message goes behind all of the messages that are
+	// already waiting, so that they are coalesced too. Within a frame of the last flush,
+	// a BMessageRunner sends it once that frame is over.
+	BMessage flush(M_FLUSH_UPDATES);
+	bigtime_t delay = fCoalescer.FlushDelay(system_time());
+	if (delay <= 0 || BMessageRunner::StartSending(BMessenger(this),&flush,delay,1) != B_OK)
+		PostMessage(&flush);
+}
@@ -3,22 +3,31 @@
 
 #include <Window.h>
 
+#include "MessageCoalescer.h"
+
 class BSlider;
 
-class MainWindow : public BWindow
+class MainWindow : public BWindow, public CoalescedHandler
 {
 public:
 				MainWindow(void);
+				~MainWindow(void);
 
 	// We are implementing the virtual BWindow method MessageReceived so
 	// that we can do something with the message that the button sends.
 	void		MessageReceived(BMessage *msg);
 
+	// The coalescer calls this with the latest value of the slider, at most once a frame.
+	void		ApplyUpdate(uint32 what, void *target, int64 value);
+
 private:
+	void		ScheduleFlush(void);
+
 	// This property will hold the number of
 	// times the button has been clicked.
 	int32	fCount;
 	BSlider* slider;
+	MessageCoalescer fCoalescer;
 };
 
 #endif